@@ -16,6 +16,24 @@
 #    misrepresented as being the original software.
 # 3. This notice may not be removed or altered from any source distribution.
 
+import os, ctypes
+
+# Native solution reader and writer, built by 'tools/Makefile.cbfsolution'
+class _CBFsolution_struct(ctypes.Structure):
+  _fields_ = [('claim', ctypes.c_char * 512),
+              ('primvarnum', ctypes.c_longlong), ('primvar', ctypes.POINTER(ctypes.c_double)),
+              ('primpsdvarnnz', ctypes.c_longlong), ('primpsdvar', ctypes.POINTER(ctypes.c_double)),
+              ('dualvarnum', ctypes.c_longlong), ('dualvar', ctypes.POINTER(ctypes.c_double)),
+              ('dualpsdvarnnz', ctypes.c_longlong), ('dualpsdvar', ctypes.POINTER(ctypes.c_double))]
+
+try:
+  _libcbfsolution = ctypes.CDLL(os.path.join(os.path.dirname(os.path.abspath(__file__)), '..', '..', 'tools', 'libcbfsolution.so'))
+  _libcbfsolution.CBF_readsol.argtypes = [ctypes.c_char_p, ctypes.c_longlong, ctypes.POINTER(_CBFsolution_struct)]
+  _libcbfsolution.CBF_writesol.argtypes = [ctypes.c_char_p, ctypes.POINTER(_CBFsolution_struct), ctypes.c_longlong]
+  _libcbfsolution.CBF_cleansol.argtypes = [ctypes.POINTER(_CBFsolution_struct)]
+except OSError:
+  _libcbfsolution = None
+
 
 class CBFsolution:
   def __init__(self):
@@ -25,6 +43,7 @@ class CBFsolution:
     self.claim = None
 
     # Variables in primal problem (affine map values are computed)
+    # NOTE: PSD variables are given by the lower triangular part, row by row...
     self.primvar = list()
     self.primpsdvar = list()
 
@@ -66,8 +85,50 @@ class CBFsolution:
           printer('{0:.16g}'.format(x))
       printer('')
 
-  def readsol(self, prob, file):
+  def writesol(self, file):
+    if _libcbfsolution is None:
+      ff = open(file,'wt')
+      try:
+        self.printsol( lambda x: ff.write(str(x) + '\n') )
+      finally:
+        ff.close()
+      return
+
+    sol = _CBFsolution_struct()
+    if self.claim is not None:
+      sol.claim = self.claim
+    (sol.primvarnum, sol.primvar) = self.__to_c(self.primvar)
+    (sol.primpsdvarnnz, sol.primpsdvar) = self.__to_c([x for vech in self.primpsdvar for x in vech])
+    (sol.dualvarnum, sol.dualvar) = self.__to_c(self.dualvar)
+    (sol.dualpsdvarnnz, sol.dualpsdvar) = self.__to_c([x for vech in self.dualpsdvar for x in vech])
+
+    if _libcbfsolution.CBF_writesol(file, ctypes.byref(sol), 1) != 0:
+      raise Exception('Failed to write file: ' + file)
+
+  def readsol(self, prob, file, index=0):
+    if _libcbfsolution is not None:
+      self.__readsol_native(prob, file, index)
+    else:
+      self.__readsol_python(prob, file, index)
+
+  def __readsol_native(self, prob, file, index):
+    sol = _CBFsolution_struct()
+    if _libcbfsolution.CBF_readsol(file, index, ctypes.byref(sol)) != 0:
+      raise Exception('Failed to read file: ' + file)
+
+    try:
+      self.claim = sol.claim if sol.claim else None
+      self.primvar = sol.primvar[:sol.primvarnum]
+      self.primpsdvar = self.__split_psd(sol.primpsdvar[:sol.primpsdvarnnz], prob.psdvardim)
+      self.dualvar = sol.dualvar[:sol.dualvarnum]
+      self.dualpsdvar = self.__split_psd(sol.dualpsdvar[:sol.dualpsdvarnnz], prob.psdmapdim)
+
+    finally:
+      _libcbfsolution.CBF_cleansol(ctypes.byref(sol))
+
+  def __readsol_python(self, prob, file, index):
     (linenum,line) = (-1, "")
+    change = 0
     ff = open(file,'rt')
     f = enumerate(ff)
     try:
@@ -78,6 +139,16 @@ class CBFsolution:
         if not line:
           continue
 
+        if line == "CHANGE":
+          if change == index:
+            break
+          change += 1
+          continue
+
+        # Skip solutions before the requested one
+        if change < index:
+          continue
+
         if line == "CLAIM":
           if self.claim is not None:
             raise Exception('Keyword also found earlier and can only appear once')
@@ -98,6 +169,17 @@ class CBFsolution:
             self.primvar[i] = float(self.__prepare_line(line))
           continue
 
+        if line == "PRIMPSDVAR":
+          if len(self.primpsdvar) > 0:
+            raise Exception('Keyword also found earlier and can only appear once')
+
+          vals = [0.0] * sum([d*(d+1)/2 for d in prob.psdvardim])
+          for i in xrange(len(vals)):
+            (linenum,line) = next(f)
+            vals[i] = float(self.__prepare_line(line))
+          self.primpsdvar = self.__split_psd(vals, prob.psdvardim)
+          continue
+
         if line == "DUALVAR":
           if len(self.dualvar) > 0:
             raise Exception('Keyword also found earlier and can only appear once')
@@ -108,12 +190,25 @@ class CBFsolution:
             self.dualvar[i] = float(self.__prepare_line(line))
           continue
 
+        if line == "DUALPSDVAR":
+          if len(self.dualpsdvar) > 0:
+            raise Exception('Keyword also found earlier and can only appear once')
+
+          vals = [0.0] * sum([d*(d+1)/2 for d in prob.psdmapdim])
+          for i in xrange(len(vals)):
+            (linenum,line) = next(f)
+            vals[i] = float(self.__prepare_line(line))
+          self.dualpsdvar = self.__split_psd(vals, prob.psdmapdim)
+          continue
+
         raise Exception('Keyword not recognized')
 
       #
       # End of file reached at this point
       #
       (linenum,line) = (linenum+1, "")
+      if change < index:
+        raise Exception('Solution not found')
 
     except Exception as e:
       if isinstance(e, StopIteration):
@@ -128,6 +223,22 @@ class CBFsolution:
     finally:
       ff.close()
 
+  def __split_psd(self, vals, dims):
+    if len(vals) == 0:
+      return list()
+
+    if len(vals) != sum([d*(d+1)/2 for d in dims]):
+      raise Exception('Mismatch between PSD dimensions and number of values')
+
+    (vechs, i) = (list(), 0)
+    for d in dims:
+      vechs.append(vals[i:i+d*(d+1)/2])
+      i += d*(d+1)/2
+    return vechs
+
+  def __to_c(self, vals):
+    return (len(vals), (ctypes.c_double * len(vals))(*vals))
+
   def __prepare_line(self, line):
     line = line.rstrip('\r\n')
     if len(line) > 510:
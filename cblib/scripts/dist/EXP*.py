@@ -0,0 +1,11 @@
+import math
+
+# Dual exponential cone: x[0] >= -x[2]*exp(x[1]/x[2] - 1) with x[0] >= 0, x[2] <= 0
+
+def primdist(x):
+  # Moreau: the distance to the dual cone is the norm of the projection onto the primal cone at -x
+  return math.sqrt(sum([xi*xi for xi in expcone.proj([-xi for xi in x])]))
+
+expcone = __import__('dist.EXP', fromlist='EXP')
+dualcone = expcone
+dualdist = dualcone.primdist
@@ -0,0 +1,69 @@
+import math
+
+# Exponential cone: x[0] >= x[1]*exp(x[2]/x[1]) with x[0], x[1] >= 0
+
+def proj(x):
+  r, s, t = x[0], x[1], x[2]
+
+  # Inside the cone
+  if (s > 0 and r > 0 and math.log(r) - math.log(s) >= t / s) or (s == 0 and r >= 0 and t <= 0):
+    return [r, s, t]
+
+  # Inside the polar cone
+  if (t > 0 and r < 0 and math.log(-r) - math.log(t) >= s / t - 1) or (t == 0 and r <= 0 and s <= 0):
+    return [0.0, 0.0, 0.0]
+
+  # Candidate on the face s = 0, which is the projection if s <= 0 and t <= 0 as the residual
+  # (min(r,0), s, 0) is then in the polar cone
+  best = [max(r, 0.0), 0.0, min(t, 0.0)]
+  bestdist = sqdist(x, best)
+
+  if s <= 0 and t <= 0:
+    return best
+
+  # At ratio rho, the last two entries of x decompose uniquely as a*(1, rho) + b*(1-rho, 1) with
+  # a = ((rho-1)*t + s) / q and b = (t - rho*s) / q where q = rho*(rho-1) + 1. The projection is
+  # a*(exp(rho), 1, rho) at the root of the residual in the first entry, b*(-exp(-rho)) being the
+  # first entry of the polar part (Friberg, 2021).
+  def hfun(rho):
+    return ((rho-1)*t + s)*math.exp(rho) - (t - rho*s)*math.exp(-rho) - (rho*(rho-1) + 1)*r
+
+  # Otherwise a > 0 and b > 0 at the projection, which brackets its ratio as the unique root
+  lo, hi = -500.0, 500.0
+  if s > 0:
+    hi = min(hi, t / s)
+  elif s < 0:
+    lo = max(lo, t / s)
+
+  if t > 0:
+    lo = max(lo, 1 - s / t)
+  elif t < 0:
+    hi = min(hi, 1 - s / t)
+
+  # The face candidate remains if the root is out of numerical range
+  hlo, hhi = hfun(lo), hfun(hi)
+  if lo < hi and (hlo < 0) != (hhi < 0):
+    for i in range(200):
+      mid = 0.5*(lo + hi)
+      if (hfun(mid) < 0) == (hlo < 0):
+        lo = mid
+      else:
+        hi = mid
+
+    rho = 0.5*(lo + hi)
+    step = ((rho-1)*t + s) / (rho*(rho-1) + 1)
+    cand = [step*math.exp(rho), step, step*rho]
+    canddist = sqdist(x, cand)
+    if canddist < bestdist:
+      best, bestdist = cand, canddist
+
+  return best
+
+def sqdist(x, y):
+  return sum([(xi - yi)**2 for (xi, yi) in zip(x, y)])
+
+def primdist(x):
+  return math.sqrt(sqdist(x, proj(x)))
+
+dualcone = __import__('dist.EXP*', fromlist='EXP*')
+dualdist = dualcone.primdist
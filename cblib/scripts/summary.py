@@ -44,11 +44,11 @@ def summary(prob, sol, printer):
   if priminfo and (
        len(sol.primvar) != prob.varnum or \
        len(sol.primpsdvar) != prob.psdvarnum or \
-       [len(x) for x in sol.primpsdvar] != prob.psdvardim) or \
+       [len(x) for x in sol.primpsdvar] != [d*(d+1)/2 for d in prob.psdvardim]) or \
      dualinfo and (
        len(sol.dualvar) != prob.mapnum or \
        len(sol.dualpsdvar) != prob.psdmapnum or \
-       [len(x) for x in sol.dualpsdvar] != prob.psdmapdim \
+       [len(x) for x in sol.dualpsdvar] != [d*(d+1)/2 for d in prob.psdmapdim] \
      ):
     printer('Mismatch between problem and solution')
     return
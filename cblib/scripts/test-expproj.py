@@ -0,0 +1,125 @@
+# Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+#
+# This software is provided 'as-is', without any express or implied
+# warranty. In no event will the authors be held liable for any damages
+# arising from the use of this software.
+#
+# Permission is granted to anyone to use this software for any purpose,
+# including commercial applications, and to alter it and redistribute it
+# freely, subject to the following restrictions:
+#
+# 1. The origin of this software must not be misrepresented; you must not
+#    claim that you wrote the original software. If you use this software
+#    in a product, an acknowledgment in the product documentation would be
+#    appreciated but is not required.
+# 2. Altered source versions must be plainly marked as such, and must not be
+#    misrepresented as being the original software.
+# 3. This notice may not be removed or altered from any source distribution.
+
+
+# Direct execution requires top level directory on python path
+if __name__ == "__main__":
+  import os, sys, inspect
+  scriptdir = os.path.split(inspect.getfile( inspect.currentframe() ))[0]
+  packagedir = os.path.realpath(os.path.abspath(os.path.join(scriptdir,'..')))
+  if packagedir not in sys.path:
+    sys.path.insert(0, packagedir)
+
+
+import os, sys, inspect, getopt, math, random, re, subprocess, tempfile
+
+expcone = __import__('dist.EXP', fromlist='EXP')
+dexpcone = __import__('dist.EXP*', fromlist='EXP*')
+
+# Points where the distance is known to be hard to get right
+hardpoints = [[0.658, -1.607, 0.366]]
+
+def bruteforce(x):
+  r, s, t = x[0], x[1], x[2]
+
+  if (s > 0 and r > 0 and math.log(r) - math.log(s) >= t / s) or (s == 0 and r >= 0 and t <= 0):
+    return 0.0
+
+  # Distance to the ray through (exp(rho), 1, rho)
+  def raydist(rho):
+    u = [math.exp(rho), 1.0, rho]
+    step = max(0.0, sum([xi*ui for (xi, ui) in zip(x, u)]) / sum([ui*ui for ui in u]))
+    return math.sqrt(sum([(xi - step*ui)**2 for (xi, ui) in zip(x, u)]))
+
+  # Dense search over the curved boundary, refined locally by golden section
+  rho = min([-30.0 + 0.01*i for i in range(6001)], key=raydist)
+  lo, hi = rho - 0.01, rho + 0.01
+  g = 0.5*(math.sqrt(5.0) - 1.0)
+  for i in range(100):
+    a, b = hi - g*(hi - lo), lo + g*(hi - lo)
+    if raydist(a) < raydist(b):
+      hi = b
+    else:
+      lo = a
+
+  face = math.sqrt(min(r, 0.0)**2 + s*s + max(t, 0.0)**2)
+  return min(raydist(0.5*(lo + hi)), face)
+
+def cbfcheckdist(cbfcheck, cone, x):
+  tmpdir = tempfile.mkdtemp()
+  probfile = os.path.join(tmpdir, 'exp.cbf')
+  solfile = os.path.join(tmpdir, 'exp.sol')
+
+  with open(probfile, 'w') as f:
+    f.write('VER\n3\n\nOBJSENSE\nMIN\n\nVAR\n3 1\n' + cone + ' 3\n\n')
+  with open(solfile, 'w') as f:
+    f.write('PRIMVAR\n' + ''.join(['%.16g\n' % xi for xi in x]) + '\n')
+
+  out = subprocess.check_output([cbfcheck, probfile, solfile]).decode()
+  os.remove(probfile)
+  os.remove(solfile)
+  os.rmdir(tmpdir)
+  return float(re.search("'" + re.escape(cone) + "': ([^,}]+)", out).group(1))
+
+def testexpproj(cbfcheck, numpoints, tol):
+  random.seed(0)
+  points = hardpoints + [[random.uniform(-2.0, 2.0) for k in range(3)] for i in range(numpoints)]
+  fails = 0
+
+  for x in points:
+    # Moreau: the projection of -x onto the primal cone is orthogonal to its residual
+    dref = math.sqrt(max(0.0, sum([xi*xi for xi in x]) - bruteforce([-xi for xi in x])**2))
+
+    for (cone, dist, ref) in [('EXP',  expcone.primdist,  bruteforce(x)),
+                              ('EXP*', dexpcone.primdist, dref)]:
+      vals = [dist(x)]
+      if cbfcheck is not None:
+        vals.append(cbfcheckdist(cbfcheck, cone, x))
+
+      if any([abs(val - ref) > tol*(1.0 + ref) for val in vals]):
+        print(cone + ' distance of ' + str(x) + ' is ' + str(vals) + ', brute force gives ' + str(ref))
+        fails += 1
+
+  print(str(len(points)) + ' points tested, ' + str(fails) + ' failures')
+  return fails
+
+
+if __name__ == "__main__":
+  try:
+    # Verify command line arguments
+    opts, args = getopt.gnu_getopt(sys.argv[1:], "c:n:", "cbfcheck=")
+    if len(args) >= 1:
+      raise Exception('Unexpected arguments')
+  except Exception as e:
+    print(str(e))
+    scriptdir = os.path.split(inspect.getfile( inspect.currentframe() ))[0]
+    rootdir = os.path.join(scriptdir,'..')
+    print(''.join([
+          'Incorrect usage, try comparing the exponential cone distances of cbfcheck against brute force:', '\n',
+          '  python ', sys.argv[0], ' -c ', os.path.realpath(os.path.abspath(os.path.join(rootdir,'tools','cbfcheck'))) ]))
+    sys.exit(2)
+
+  cbfcheck = None
+  numpoints = 200
+  for opt, arg in opts:
+    if opt in ("-c", "--cbfcheck"):
+      cbfcheck = arg
+    elif opt == "-n":
+      numpoints = int(arg)
+
+  sys.exit(1 if testexpproj(cbfcheck, numpoints, 1e-6) else 0)
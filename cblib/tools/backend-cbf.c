@@ -20,10 +20,55 @@
 #include "cbf-format.h"
 #include <stddef.h>
 #include <stdio.h>
+#include <stdlib.h>
+
+typedef struct CBFwriter_struct {
+  FILE *pFile;
+  long long int nnz;
+} CBFwriter;
 
 static CBFresponsee
   write(const char *file, const CBFdata data);
 
+static CBFresponsee
+  stream(const char *file, CBFstream *stream);
+
+static CBFresponsee
+  stream_structure(void *userdata, CBFdata *data);
+
+static CBFresponsee
+  stream_blockbegin(void *userdata, CBFblocke block, long long int nnz);
+
+static CBFresponsee
+  stream_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk);
+
+static CBFresponsee
+  stream_blockend(void *userdata, CBFblocke block);
+
+static CBFresponsee
+  stream_finish(void *userdata, CBFresponsee res);
+
+static long long int
+  blocknnz(CBFblocke block, const CBFdata data);
+
+static CBFresponsee
+  writeSTRUCTURE(FILE *pFile, const CBFdata data);
+
+static CBFresponsee
+  writePOWCONES(FILE *pFile, const char *keyword, long long int conenum, long long int alphanum, const long long int *alphabeg, const double *alpha);
+
+static CBFresponsee
+  writeSTACKDOMAIN(FILE *pFile, CBFscalarconee domain, const long long int *stackparam, long long int i, long long int dim);
+
+static CBFresponsee
+  writeBLOCKBEGIN(FILE *pFile, CBFblocke block, long long int nnz);
+
+static CBFresponsee
+  writeBLOCKCHUNK(FILE *pFile, CBFblocke block, const CBFdata data);
+
+static CBFresponsee
+  writeBLOCKEND(FILE *pFile, CBFblocke block);
+
 static CBFresponsee
   writeVER(FILE *pFile, const CBFdata data);
 
@@ -74,7 +119,7 @@ static CBFresponsee
 // Global variable
 // -------------------------------------
 
-CBFbackend const backend_cbf = { "cbf", "cbf", write };
+CBFbackend const backend_cbf = { "cbf", "cbf", write, stream };
 
 
 // -------------------------------------
@@ -84,18 +129,134 @@ CBFbackend const backend_cbf = { "cbf", "cbf", write };
 static CBFresponsee write(const char *file, const CBFdata data) {
   CBFresponsee res = CBF_RES_OK;
   FILE *pFile = NULL;
+  long long int nnz;
+  int block;
 
   pFile = fopen(file, "wt");
   if (!pFile) {
     return CBF_RES_ERR;
   }
 
+  if (res == CBF_RES_OK)
+    res = writeSTRUCTURE(pFile, data);
+
+  for (block=CBF_BLOCK_BEGIN; block<CBF_BLOCK_END && res==CBF_RES_OK; ++block) {
+    nnz = blocknnz((CBFblocke)block, data);
+
+    if (nnz >= 1) {
+      if (res == CBF_RES_OK)
+        res = writeBLOCKBEGIN(pFile, (CBFblocke)block, nnz);
+
+      if (res == CBF_RES_OK)
+        res = writeBLOCKCHUNK(pFile, (CBFblocke)block, data);
+
+      if (res == CBF_RES_OK)
+        res = writeBLOCKEND(pFile, (CBFblocke)block);
+    }
+  }
+
+  fclose(pFile);
+  return res;
+}
+
+static CBFresponsee stream(const char *file, CBFstream *stream) {
+  CBFwriter *writer = NULL;
+
+  writer = (CBFwriter*) calloc(1, sizeof(*writer));
+  if (!writer) {
+    return CBF_RES_ERR;
+  }
+
+  writer->pFile = fopen(file, "wt");
+  if (!writer->pFile) {
+    free(writer);
+    return CBF_RES_ERR;
+  }
+
+  stream->userdata   = writer;
+  stream->structure  = stream_structure;
+  stream->blockbegin = stream_blockbegin;
+  stream->blockchunk = stream_blockchunk;
+  stream->blockend   = stream_blockend;
+  stream->finish     = stream_finish;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee stream_structure(void *userdata, CBFdata *data)
+{
+  CBFwriter *writer = (CBFwriter*) userdata;
+  return writeSTRUCTURE(writer->pFile, *data);
+}
+
+static CBFresponsee stream_blockbegin(void *userdata, CBFblocke block, long long int nnz)
+{
+  CBFwriter *writer = (CBFwriter*) userdata;
+
+  // Empty blocks are omitted
+  writer->nnz = nnz;
+  if (writer->nnz == 0)
+    return CBF_RES_OK;
+
+  return writeBLOCKBEGIN(writer->pFile, block, nnz);
+}
+
+static CBFresponsee stream_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk)
+{
+  CBFwriter *writer = (CBFwriter*) userdata;
+  return writeBLOCKCHUNK(writer->pFile, block, *chunk);
+}
+
+static CBFresponsee stream_blockend(void *userdata, CBFblocke block)
+{
+  CBFwriter *writer = (CBFwriter*) userdata;
+
+  if (writer->nnz == 0)
+    return CBF_RES_OK;
+
+  return writeBLOCKEND(writer->pFile, block);
+}
+
+static CBFresponsee stream_finish(void *userdata, CBFresponsee res)
+{
+  CBFwriter *writer = (CBFwriter*) userdata;
+
+  fclose(writer->pFile);
+  free(writer);
+  return res;
+}
+
+static long long int blocknnz(CBFblocke block, const CBFdata data)
+{
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:     return data.objfnnz;
+  case CBF_BLOCK_OBJACOORD:     return data.objannz;
+  case CBF_BLOCK_OBJBCOORD:     return (data.objbval != 0.0);
+  case CBF_BLOCK_FCOORD:        return data.fnnz;
+  case CBF_BLOCK_ACOORD:        return data.annz;
+  case CBF_BLOCK_BCOORD:        return data.bnnz;
+  case CBF_BLOCK_HCOORD:        return data.hnnz;
+  case CBF_BLOCK_DCOORD:        return data.dnnz;
+  default:                      return 0;
+  }
+}
+
+static CBFresponsee writeSTRUCTURE(FILE *pFile, const CBFdata data)
+{
+  CBFresponsee res = CBF_RES_OK;
+
   if (res == CBF_RES_OK)
     res = writeVER(pFile, data);
 
   if (res == CBF_RES_OK)
     res = writeOBJSENSE(pFile, data);
 
+  if (res == CBF_RES_OK)
+    res = writePOWCONES(pFile, "POWCONES", data.powconenum, data.powalphanum, data.powalphabeg, data.powalpha);
+
+  if (res == CBF_RES_OK)
+    res = writePOWCONES(pFile, "POW*CONES", data.dpowconenum, data.dpowalphanum, data.dpowalphabeg, data.dpowalpha);
+
   if (res == CBF_RES_OK)
     res = writePSDVAR(pFile, data);
 
@@ -111,31 +272,52 @@ static CBFresponsee write(const char *file, const CBFdata data) {
   if (res == CBF_RES_OK)
     res = writePSDCON(pFile, data);
 
-  if (res == CBF_RES_OK)
-    res = writeOBJFCOORD(pFile, data);
+  return res;
+}
 
-  if (res == CBF_RES_OK)
-    res = writeOBJACOORD(pFile, data);
+static CBFresponsee writeBLOCKBEGIN(FILE *pFile, CBFblocke block, long long int nnz)
+{
+  CBFresponsee res = CBF_RES_OK;
+  const char *blocknam;
 
-  if (res == CBF_RES_OK)
-    res = writeOBJBCOORD(pFile, data);
+  res = CBF_blocktostr(block, &blocknam);
 
-  if (res == CBF_RES_OK)
-    res = writeFCOORD(pFile, data);
+  if (res == CBF_RES_OK) {
+    // The objective constant has no nonzero count
+    if (block == CBF_BLOCK_OBJBCOORD) {
+      if (fprintf(pFile, "%s\n", blocknam) <= 0)
+        res = CBF_RES_ERR;
+    } else {
+      if (fprintf(pFile, "%s\n%lli\n", blocknam, nnz) <= 0)
+        res = CBF_RES_ERR;
+    }
+  }
 
-  if (res == CBF_RES_OK)
-    res = writeACOORD(pFile, data);
+  return res;
+}
 
-  if (res == CBF_RES_OK)
-    res = writeBCOORD(pFile, data);
+static CBFresponsee writeBLOCKCHUNK(FILE *pFile, CBFblocke block, const CBFdata data)
+{
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:     return writeOBJFCOORD(pFile, data);
+  case CBF_BLOCK_OBJACOORD:     return writeOBJACOORD(pFile, data);
+  case CBF_BLOCK_OBJBCOORD:     return writeOBJBCOORD(pFile, data);
+  case CBF_BLOCK_FCOORD:        return writeFCOORD(pFile, data);
+  case CBF_BLOCK_ACOORD:        return writeACOORD(pFile, data);
+  case CBF_BLOCK_BCOORD:        return writeBCOORD(pFile, data);
+  case CBF_BLOCK_HCOORD:        return writeHCOORD(pFile, data);
+  case CBF_BLOCK_DCOORD:        return writeDCOORD(pFile, data);
+  default:                      return CBF_RES_ERR;
+  }
+}
 
-  if (res == CBF_RES_OK)
-    res = writeHCOORD(pFile, data);
+static CBFresponsee writeBLOCKEND(FILE *pFile, CBFblocke block)
+{
+  CBFresponsee res = CBF_RES_OK;
 
-  if (res == CBF_RES_OK)
-    res = writeDCOORD(pFile, data);
+  if (fprintf(pFile, "\n") <= 0)
+    res = CBF_RES_ERR;
 
-  fclose(pFile);
   return res;
 }
 
@@ -166,7 +348,6 @@ static CBFresponsee writeOBJSENSE(FILE *pFile, const CBFdata data)
 static CBFresponsee writeCON(FILE *pFile, const CBFdata data)
 {
   CBFresponsee res = CBF_RES_OK;
-  const char *conenam;
   long long int i;
 
   if (data.mapnum >= 1 || data.mapstacknum >= 1)
@@ -175,11 +356,35 @@ static CBFresponsee writeCON(FILE *pFile, const CBFdata data)
       if (fprintf(pFile, "CON\n%lli %lli\n", data.mapnum, data.mapstacknum) <= 0)
         res = CBF_RES_ERR;
 
-    for (i=0; i<data.mapstacknum && res==CBF_RES_OK; ++i) {
-      CBF_conetostr(data.mapstackdomain[i], &conenam);
+    for (i=0; i<data.mapstacknum && res==CBF_RES_OK; ++i)
+      res = writeSTACKDOMAIN(pFile, data.mapstackdomain[i], data.mapstackparam, i, data.mapstackdim[i]);
 
-      if (fprintf(pFile, "%s %lli\n", conenam, data.mapstackdim[i]) <= 0)
+    if (res == CBF_RES_OK)
+      if (fprintf(pFile, "\n") <= 0)
         res = CBF_RES_ERR;
+  }
+
+  return res;
+}
+
+static CBFresponsee writePOWCONES(FILE *pFile, const char *keyword, long long int conenum, long long int alphanum, const long long int *alphabeg, const double *alpha)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, j;
+
+  if (conenum >= 1)
+  {
+    if (res == CBF_RES_OK)
+      if (fprintf(pFile, "%s\n%lli %lli\n", keyword, conenum, alphanum) <= 0)
+        res = CBF_RES_ERR;
+
+    for (i=0; i<conenum && res==CBF_RES_OK; ++i) {
+      if (fprintf(pFile, "%lli\n", alphabeg[i+1] - alphabeg[i]) <= 0)
+        res = CBF_RES_ERR;
+
+      for (j=alphabeg[i]; j<alphabeg[i+1] && res==CBF_RES_OK; ++j)
+        if (fprintf(pFile, "%.16lg\n", alpha[j]) <= 0)
+          res = CBF_RES_ERR;
     }
 
     if (res == CBF_RES_OK)
@@ -190,10 +395,29 @@ static CBFresponsee writeCON(FILE *pFile, const CBFdata data)
   return res;
 }
 
-static CBFresponsee writeVAR(FILE *pFile, const CBFdata data)
+static CBFresponsee writeSTACKDOMAIN(FILE *pFile, CBFscalarconee domain, const long long int *stackparam, long long int i, long long int dim)
 {
   CBFresponsee res = CBF_RES_OK;
   const char *conenam;
+
+  res = CBF_conetostr(domain, &conenam);
+
+  if (res == CBF_RES_OK) {
+    if (CBF_coneisparametric(domain)) {
+      if (fprintf(pFile, "@%lli:%s %lli\n", stackparam[i], conenam, dim) <= 0)
+        res = CBF_RES_ERR;
+    } else {
+      if (fprintf(pFile, "%s %lli\n", conenam, dim) <= 0)
+        res = CBF_RES_ERR;
+    }
+  }
+
+  return res;
+}
+
+static CBFresponsee writeVAR(FILE *pFile, const CBFdata data)
+{
+  CBFresponsee res = CBF_RES_OK;
   long long int i;
 
   if (data.varnum >= 1 || data.varstacknum >= 1)
@@ -202,12 +426,8 @@ static CBFresponsee writeVAR(FILE *pFile, const CBFdata data)
       if (fprintf(pFile, "VAR\n%lli %lli\n", data.varnum, data.varstacknum) <= 0)
         res = CBF_RES_ERR;
 
-    for (i=0; i<data.varstacknum && res==CBF_RES_OK; ++i) {
-      CBF_conetostr(data.varstackdomain[i], &conenam);
-
-      if (fprintf(pFile, "%s %lli\n", conenam, data.varstackdim[i]) <= 0)
-        res = CBF_RES_ERR;
-    }
+    for (i=0; i<data.varstacknum && res==CBF_RES_OK; ++i)
+      res = writeSTACKDOMAIN(pFile, data.varstackdomain[i], data.varstackparam, i, data.varstackdim[i]);
 
     if (res == CBF_RES_OK)
       if (fprintf(pFile, "\n") <= 0)
@@ -291,20 +511,9 @@ static CBFresponsee writeOBJFCOORD(FILE *pFile, const CBFdata data)
   CBFresponsee res = CBF_RES_OK;
   long long int i;
 
-  if (data.objfnnz >= 1)
-  {
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "OBJFCOORD\n%lli\n", data.objfnnz) <= 0)
-        res = CBF_RES_ERR;
-
-    for (i=0; i<data.objfnnz && res==CBF_RES_OK; ++i)
-      if (fprintf(pFile, "%i %i %i %.16lg\n", data.objfsubj[i], data.objfsubk[i], data.objfsubl[i], data.objfval[i]) <= 0)
-        res = CBF_RES_ERR;
-
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "\n") <= 0)
-        res = CBF_RES_ERR;
-  }
+  for (i=0; i<data.objfnnz && res==CBF_RES_OK; ++i)
+    if (fprintf(pFile, "%i %i %i %.16lg\n", data.objfsubj[i], data.objfsubk[i], data.objfsubl[i], data.objfval[i]) <= 0)
+      res = CBF_RES_ERR;
 
   return res;
 }
@@ -314,20 +523,9 @@ static CBFresponsee writeOBJACOORD(FILE *pFile, const CBFdata data)
   CBFresponsee res = CBF_RES_OK;
   long long int i;
 
-  if (data.objannz >= 1)
-  {
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "OBJACOORD\n%lli\n", data.objannz) <= 0)
-        res = CBF_RES_ERR;
-
-    for (i=0; i<data.objannz && res==CBF_RES_OK; ++i)
-      if (fprintf(pFile, "%lli %.16lg\n", data.objasubj[i], data.objaval[i]) <= 0)
-        res = CBF_RES_ERR;
-
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "\n") <= 0)
-        res = CBF_RES_ERR;
-  }
+  for (i=0; i<data.objannz && res==CBF_RES_OK; ++i)
+    if (fprintf(pFile, "%lli %.16lg\n", data.objasubj[i], data.objaval[i]) <= 0)
+      res = CBF_RES_ERR;
 
   return res;
 }
@@ -336,16 +534,8 @@ static CBFresponsee writeOBJBCOORD(FILE *pFile, const CBFdata data)
 {
   CBFresponsee res = CBF_RES_OK;
 
-  if (data.objbval != 0.0)
-  {
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "OBJBCOORD\n%lg\n", data.objbval) <= 0)
-        res = CBF_RES_ERR;
-
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "\n") <= 0)
-        res = CBF_RES_ERR;
-  }
+  if (fprintf(pFile, "%lg\n", data.objbval) <= 0)
+    res = CBF_RES_ERR;
 
   return res;
 }
@@ -355,20 +545,9 @@ static CBFresponsee writeFCOORD(FILE *pFile, const CBFdata data)
   CBFresponsee res = CBF_RES_OK;
   long long int i;
 
-  if (data.fnnz >= 1)
-  {
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "FCOORD\n%lli\n", data.fnnz) <= 0)
-        res = CBF_RES_ERR;
-
-    for (i=0; i<data.fnnz && res==CBF_RES_OK; ++i)
-      if (fprintf(pFile, "%lli %i %i %i %.16lg\n", data.fsubi[i], data.fsubj[i], data.fsubk[i], data.fsubl[i], data.fval[i]) <= 0)
-        res = CBF_RES_ERR;
-
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "\n") <= 0)
-        res = CBF_RES_ERR;
-  }
+  for (i=0; i<data.fnnz && res==CBF_RES_OK; ++i)
+    if (fprintf(pFile, "%lli %i %i %i %.16lg\n", data.fsubi[i], data.fsubj[i], data.fsubk[i], data.fsubl[i], data.fval[i]) <= 0)
+      res = CBF_RES_ERR;
 
   return res;
 }
@@ -378,20 +557,9 @@ static CBFresponsee writeACOORD(FILE *pFile, const CBFdata data)
   CBFresponsee res = CBF_RES_OK;
   long long int i;
 
-  if (data.annz >= 1)
-  {
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "ACOORD\n%lli\n", data.annz) <= 0)
-        res = CBF_RES_ERR;
-
-    for (i=0; i<data.annz && res==CBF_RES_OK; ++i)
-      if (fprintf(pFile, "%lli %lli %.16lg\n", data.asubi[i], data.asubj[i], data.aval[i]) <= 0)
-        res = CBF_RES_ERR;
-
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "\n") <= 0)
-        res = CBF_RES_ERR;
-  }
+  for (i=0; i<data.annz && res==CBF_RES_OK; ++i)
+    if (fprintf(pFile, "%lli %lli %.16lg\n", data.asubi[i], data.asubj[i], data.aval[i]) <= 0)
+      res = CBF_RES_ERR;
 
   return res;
 }
@@ -401,20 +569,9 @@ static CBFresponsee writeBCOORD(FILE *pFile, const CBFdata data)
   CBFresponsee res = CBF_RES_OK;
   long long int i;
 
-  if (data.bnnz >= 1)
-  {
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "BCOORD\n%lli\n", data.bnnz) <= 0)
-        res = CBF_RES_ERR;
-
-    for (i=0; i<data.bnnz && res==CBF_RES_OK; ++i)
-      if (fprintf(pFile, "%lli %.16lg\n", data.bsubi[i], data.bval[i]) <= 0)
-        res = CBF_RES_ERR;
-
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "\n") <= 0)
-        res = CBF_RES_ERR;
-  }
+  for (i=0; i<data.bnnz && res==CBF_RES_OK; ++i)
+    if (fprintf(pFile, "%lli %.16lg\n", data.bsubi[i], data.bval[i]) <= 0)
+      res = CBF_RES_ERR;
 
   return res;
 }
@@ -424,20 +581,9 @@ static CBFresponsee writeHCOORD(FILE *pFile, const CBFdata data)
   CBFresponsee res = CBF_RES_OK;
   long long int i;
 
-  if (data.hnnz >= 1)
-  {
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "HCOORD\n%lli\n", data.hnnz) <= 0)
-        res = CBF_RES_ERR;
-
-    for (i=0; i<data.hnnz && res==CBF_RES_OK; ++i)
-      if (fprintf(pFile, "%i %lli %i %i %.16lg\n", data.hsubi[i], data.hsubj[i], data.hsubk[i], data.hsubl[i], data.hval[i]) <= 0)
-        res = CBF_RES_ERR;
-
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "\n") <= 0)
-        res = CBF_RES_ERR;
-  }
+  for (i=0; i<data.hnnz && res==CBF_RES_OK; ++i)
+    if (fprintf(pFile, "%i %lli %i %i %.16lg\n", data.hsubi[i], data.hsubj[i], data.hsubk[i], data.hsubl[i], data.hval[i]) <= 0)
+      res = CBF_RES_ERR;
 
   return res;
 }
@@ -447,20 +593,9 @@ static CBFresponsee writeDCOORD(FILE *pFile, const CBFdata data)
   CBFresponsee res = CBF_RES_OK;
   long long int i;
 
-  if (data.dnnz >= 1)
-  {
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "DCOORD\n%lli\n", data.dnnz) <= 0)
-        res = CBF_RES_ERR;
-
-    for (i=0; i<data.dnnz && res==CBF_RES_OK; ++i)
-      if (fprintf(pFile, "%i %i %i %.16lg\n", data.dsubi[i], data.dsubk[i], data.dsubl[i], data.dval[i]) <= 0)
-        res = CBF_RES_ERR;
-
-    if (res == CBF_RES_OK)
-      if (fprintf(pFile, "\n") <= 0)
-        res = CBF_RES_ERR;
-  }
+  for (i=0; i<data.dnnz && res==CBF_RES_OK; ++i)
+    if (fprintf(pFile, "%i %i %i %.16lg\n", data.dsubi[i], data.dsubk[i], data.dsubl[i], data.dval[i]) <= 0)
+      res = CBF_RES_ERR;
 
   return res;
 }
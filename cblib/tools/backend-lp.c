@@ -0,0 +1,499 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "backend-lp.h"
+#include "backend-mps.h"
+#include "cbf-helper.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <string.h>
+
+// Size of the output buffer used when writing the file
+#define CBF_LP_BUFFER  (1 << 20)
+
+// Lines are broken after this many characters, well within the limit of 510
+#define CBF_LP_LINE    200
+
+static CBFresponsee
+  write(const char *file, const CBFdata data);
+
+static CBFresponsee
+  check(const CBFdata data);
+
+static CBFresponsee
+  writeFILE(FILE *pFile, const CBFdata data);
+
+static int
+  validnames(const CBFnametable *names, long long int num);
+
+static CBFresponsee
+  writeOBJECTIVE(FILE *pFile, const CBFdata data);
+
+static CBFresponsee
+  writeCONSTRAINTS(FILE *pFile, const CBFdata data);
+
+static CBFresponsee
+  writeQUADCONES(FILE *pFile, const CBFdata data);
+
+static CBFresponsee
+  writeBOUNDS(FILE *pFile, const CBFdata data);
+
+static CBFresponsee
+  writeGENERALS(FILE *pFile, const CBFdata data);
+
+static CBFresponsee
+  writeTERM(FILE *pFile, double val, const char *prefix, const char *name, long long int *linelen);
+
+static CBFresponsee
+  writeQUADTERM(FILE *pFile, double val, const char *prefix, const char *name0, const char *name1, long long int *linelen);
+
+static CBFresponsee
+  writeQUADCONE(FILE *pFile, CBFscalarconee domain, long long int dim, const char *prefix, const CBFnametable *names, long long int first);
+
+static CBFresponsee
+  writeCONEBOUNDS(FILE *pFile, CBFscalarconee domain, long long int dim, const char *prefix, const CBFnametable *names, long long int first);
+
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFbackend const backend_lp = { "lp", "lp", write };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee write(const char *file, const CBFdata data) {
+  CBFresponsee res = CBF_RES_OK;
+  FILE *pFile = NULL;
+  char *buffer = NULL;
+
+  res = check(data);
+  if (res != CBF_RES_OK) {
+    return res;
+  }
+
+  pFile = fopen(file, "wt");
+  if (!pFile) {
+    return CBF_RES_ERR;
+  }
+
+  // Terms are written a few at a time, so the default buffer is quickly exhausted
+  buffer = (char*) malloc(CBF_LP_BUFFER * sizeof(buffer[0]));
+  if (buffer)
+    setvbuf(pFile, buffer, _IOFBF, CBF_LP_BUFFER);
+
+  res = writeFILE(pFile, data);
+
+  if (fclose(pFile) != 0)
+    res = CBF_RES_ERR;
+
+  free(buffer);
+  return res;
+}
+
+static CBFresponsee check(const CBFdata data) {
+  long long int i;
+
+  if (data.psdmapnum >= 1 || data.psdvarnum >= 1) {
+    printf("Positive semidefinite domains are not supported in the selected output file format.\n");
+    return CBF_RES_ERR;
+  }
+
+  for (i=0; i<data.varstacknum; ++i) {
+    if (data.varstackdomain[i] >= CBF_CONE_PEXP) {
+      printf("Exponential and power cone domains are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+    if ((data.varstackdomain[i] == CBF_CONE_QUAD || data.varstackdomain[i] == CBF_CONE_RQUAD) && data.varstackdim[i] < 2) {
+      printf("Quadratic cone domains of dimension below two are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+  }
+
+  for (i=0; i<data.mapstacknum; ++i) {
+    if (data.mapstackdomain[i] >= CBF_CONE_PEXP) {
+      printf("Exponential and power cone domains are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+    if ((data.mapstackdomain[i] == CBF_CONE_QUAD || data.mapstackdomain[i] == CBF_CONE_RQUAD) && data.mapstackdim[i] < 2) {
+      printf("Quadratic cone domains of dimension below two are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+  }
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee writeFILE(FILE *pFile, const CBFdata data) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFnametable varname, mapname;
+  CBFdata named = data;
+
+  // Names read from fixed MPS, e.g., may contain spaces and are then replaced
+  if (named.varname && !validnames(named.varname, named.varnum))
+    named.varname = NULL;
+
+  if (named.mapname && !validnames(named.mapname, named.mapnum))
+    named.mapname = NULL;
+
+  res = MPS_initnames(&named, &varname, &mapname);
+
+  if (res == CBF_RES_OK)
+    res = writeOBJECTIVE(pFile, named);
+
+  if (res == CBF_RES_OK)
+    res = writeCONSTRAINTS(pFile, named);
+
+  if (res == CBF_RES_OK)
+    res = writeQUADCONES(pFile, named);
+
+  if (res == CBF_RES_OK)
+    res = writeBOUNDS(pFile, named);
+
+  if (res == CBF_RES_OK)
+    res = writeGENERALS(pFile, named);
+
+  if (res == CBF_RES_OK)
+    if (fprintf(pFile, "End\n") <= 0)
+      res = CBF_RES_ERR;
+
+  MPS_freenames(&varname, &mapname);
+
+  return res;
+}
+
+static int validnames(const CBFnametable *names, long long int num)
+{
+  long long int i;
+  const char *name;
+
+  for (i=0; i<num; ++i) {
+    name = CBFnametable_name(names, i);
+
+    if (name[0] == '\0' || strlen(name) > 255)
+      return 0;
+
+    if ((name[0] >= '0' && name[0] <= '9') || name[0] == '.')
+      return 0;
+
+    if (strpbrk(name, " \t+-*/^:<>=[]") != NULL)
+      return 0;
+  }
+
+  return 1;
+}
+
+static CBFresponsee writeOBJECTIVE(FILE *pFile, const CBFdata data)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int j, linelen;
+  const char *sense = NULL;
+
+  if (data.objsense == CBF_OBJ_MINIMIZE)
+    sense = "Minimize";
+  else if (data.objsense == CBF_OBJ_MAXIMIZE)
+    sense = "Maximize";
+  else
+    res = CBF_RES_ERR;
+
+  if (res == CBF_RES_OK) {
+    linelen = fprintf(pFile, "%s\n obj:", sense);
+    if (linelen <= 0)
+      res = CBF_RES_ERR;
+  }
+
+  for (j=0; j<data.objannz && res==CBF_RES_OK; ++j)
+    res = writeTERM(pFile, data.objaval[j], "", CBFnametable_name(data.varname, data.objasubj[j]), &linelen);
+
+  if (res == CBF_RES_OK)
+    if (data.objbval != 0.0)
+      if (fprintf(pFile, " %c %.16lg", (data.objbval < 0.0 ? '-' : '+'), fabs(data.objbval)) <= 0)
+        res = CBF_RES_ERR;
+
+  if (res == CBF_RES_OK)
+    if (fprintf(pFile, "\n") <= 0)
+      res = CBF_RES_ERR;
+
+  return res;
+}
+
+static CBFresponsee writeCONSTRAINTS(FILE *pFile, const CBFdata data)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, j, k, r, linelen;
+  long long int *rowbeg = NULL, *idx = NULL;
+  double *rhs = NULL;
+  const char *name, *sense;
+
+  if (fprintf(pFile, "Subject To\n") <= 0)
+    res = CBF_RES_ERR;
+
+  if (data.mapnum == 0)
+    return res;
+
+  // Row-major view of the coordinates, so each row is written in a single pass
+  if (res == CBF_RES_OK) {
+    rowbeg = (long long int*) malloc((data.mapnum+1) * sizeof(rowbeg[0]));
+    idx = (long long int*) malloc(data.annz * sizeof(idx[0]));
+    rhs = (double*) calloc(data.mapnum, sizeof(rhs[0]));
+
+    if (!rowbeg || (!idx && data.annz >= 1) || !rhs)
+      res = CBF_RES_ERR;
+  }
+
+  if (res == CBF_RES_OK)
+    res = CBF_transpose(data.annz, data.asubj, data.varnum-1, data.asubi, data.mapnum-1, rowbeg, idx);
+
+  if (res == CBF_RES_OK)
+    for (k=0; k<data.bnnz; ++k)
+      rhs[data.bsubi[k]] -= data.bval[k];
+
+  for (r=0, i=0; r<data.mapstacknum && res==CBF_RES_OK; ++r) {
+    switch (data.mapstackdomain[r]) {
+    case CBF_CONE_POS:    sense = ">=";   break;
+    case CBF_CONE_NEG:    sense = "<=";   break;
+    case CBF_CONE_FREE:   sense = NULL;   break;
+    default:              sense = "=";    break;
+    }
+
+    for (j=0; j<data.mapstackdim[r] && res==CBF_RES_OK; ++j, ++i) {
+      // Free rows do not constrain the problem
+      if (!sense)
+        continue;
+
+      name = CBFnametable_name(data.mapname, i);
+      linelen = fprintf(pFile, " %s:", name);
+      if (linelen <= 0)
+        res = CBF_RES_ERR;
+
+      for (k=rowbeg[i]; k<rowbeg[i+1] && res==CBF_RES_OK; ++k)
+        res = writeTERM(pFile, data.aval[idx[k]], "", CBFnametable_name(data.varname, data.asubj[idx[k]]), &linelen);
+
+      // Cone rows are equal to a slack variable carrying the domain
+      if (res == CBF_RES_OK)
+        if (data.mapstackdomain[r] == CBF_CONE_QUAD || data.mapstackdomain[r] == CBF_CONE_RQUAD)
+          res = writeTERM(pFile, -1.0, "x", name, &linelen);
+
+      if (res == CBF_RES_OK)
+        if (rowbeg[i] == rowbeg[i+1] && data.mapstackdomain[r] != CBF_CONE_QUAD && data.mapstackdomain[r] != CBF_CONE_RQUAD && data.varnum >= 1)
+          if (fprintf(pFile, " 0 %s", CBFnametable_name(data.varname, 0)) <= 0)
+            res = CBF_RES_ERR;
+
+      if (res == CBF_RES_OK)
+        if (fprintf(pFile, " %s %.16lg\n", sense, rhs[i]) <= 0)
+          res = CBF_RES_ERR;
+    }
+  }
+
+  free(rowbeg);
+  free(idx);
+  free(rhs);
+  return res;
+}
+
+static CBFresponsee writeQUADCONES(FILE *pFile, const CBFdata data)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, curvar = 0, curmap = 0;
+
+  for (i=0; i<data.varstacknum && res==CBF_RES_OK; ++i) {
+    if (data.varstackdomain[i] == CBF_CONE_QUAD || data.varstackdomain[i] == CBF_CONE_RQUAD) {
+      if (fprintf(pFile, " xK%lli:", i) <= 0)
+        res = CBF_RES_ERR;
+
+      if (res == CBF_RES_OK)
+        res = writeQUADCONE(pFile, data.varstackdomain[i], data.varstackdim[i], "", data.varname, curvar);
+    }
+    curvar += data.varstackdim[i];
+  }
+
+  for (i=0; i<data.mapstacknum && res==CBF_RES_OK; ++i) {
+    if (data.mapstackdomain[i] == CBF_CONE_QUAD || data.mapstackdomain[i] == CBF_CONE_RQUAD) {
+      if (fprintf(pFile, " xgK%lli:", i) <= 0)
+        res = CBF_RES_ERR;
+
+      if (res == CBF_RES_OK)
+        res = writeQUADCONE(pFile, data.mapstackdomain[i], data.mapstackdim[i], "x", data.mapname, curmap);
+    }
+    curmap += data.mapstackdim[i];
+  }
+
+  return res;
+}
+
+static CBFresponsee writeBOUNDS(FILE *pFile, const CBFdata data)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, curvar = 0, curmap = 0;
+
+  if (fprintf(pFile, "Bounds\n") <= 0)
+    res = CBF_RES_ERR;
+
+  for (i=0; i<data.varstacknum && res==CBF_RES_OK; ++i) {
+    res = writeCONEBOUNDS(pFile, data.varstackdomain[i], data.varstackdim[i], "", data.varname, curvar);
+    curvar += data.varstackdim[i];
+  }
+
+  // Slack variables of the cone rows
+  for (i=0; i<data.mapstacknum && res==CBF_RES_OK; ++i) {
+    if (data.mapstackdomain[i] == CBF_CONE_QUAD || data.mapstackdomain[i] == CBF_CONE_RQUAD)
+      res = writeCONEBOUNDS(pFile, data.mapstackdomain[i], data.mapstackdim[i], "x", data.mapname, curmap);
+    curmap += data.mapstackdim[i];
+  }
+
+  return res;
+}
+
+static CBFresponsee writeGENERALS(FILE *pFile, const CBFdata data)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i;
+
+  if (data.intvarnum >= 1)
+    if (fprintf(pFile, "Generals\n") <= 0)
+      res = CBF_RES_ERR;
+
+  for (i=0; i<data.intvarnum && res==CBF_RES_OK; ++i)
+    if (fprintf(pFile, " %s\n", CBFnametable_name(data.varname, data.intvar[i])) <= 0)
+      res = CBF_RES_ERR;
+
+  return res;
+}
+
+static CBFresponsee writeTERM(FILE *pFile, double val, const char *prefix, const char *name, long long int *linelen)
+{
+  int len;
+
+  if (*linelen >= CBF_LP_LINE) {
+    if (fprintf(pFile, "\n  ") <= 0)
+      return CBF_RES_ERR;
+    *linelen = 2;
+  }
+
+  len = fprintf(pFile, " %c %.16lg %s%s", (val < 0.0 ? '-' : '+'), fabs(val), prefix, name);
+  if (len <= 0)
+    return CBF_RES_ERR;
+
+  *linelen += len;
+  return CBF_RES_OK;
+}
+
+static CBFresponsee writeQUADTERM(FILE *pFile, double val, const char *prefix, const char *name0, const char *name1, long long int *linelen)
+{
+  int len;
+
+  if (*linelen >= CBF_LP_LINE) {
+    if (fprintf(pFile, "\n  ") <= 0)
+      return CBF_RES_ERR;
+    *linelen = 2;
+  }
+
+  if (name0 == name1)
+    len = fprintf(pFile, " %c %.16lg %s%s ^ 2", (val < 0.0 ? '-' : '+'), fabs(val), prefix, name0);
+  else
+    len = fprintf(pFile, " %c %.16lg %s%s * %s%s", (val < 0.0 ? '-' : '+'), fabs(val), prefix, name0, prefix, name1);
+
+  if (len <= 0)
+    return CBF_RES_ERR;
+
+  *linelen += len;
+  return CBF_RES_OK;
+}
+
+static CBFresponsee writeQUADCONE(FILE *pFile, CBFscalarconee domain, long long int dim, const char *prefix, const CBFnametable *names, long long int first)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int j, linelen = 0;
+  const char *name0, *name1;
+
+  name0 = CBFnametable_name(names, first);
+  name1 = CBFnametable_name(names, first+1);
+
+  if (fprintf(pFile, " [") <= 0)
+    res = CBF_RES_ERR;
+
+  // QUAD: x0^2 >= x1^2 + ... + xn^2, and RQUAD: 2*x0*x1 >= x2^2 + ... + xn^2
+  if (res == CBF_RES_OK) {
+    if (domain == CBF_CONE_QUAD) {
+      res = writeQUADTERM(pFile, -1.0, prefix, name0, name0, &linelen);
+      if (res == CBF_RES_OK)
+        res = writeQUADTERM(pFile, 1.0, prefix, name1, name1, &linelen);
+    } else {
+      res = writeQUADTERM(pFile, -2.0, prefix, name0, name1, &linelen);
+    }
+  }
+
+  for (j=2; j<dim && res==CBF_RES_OK; ++j) {
+    name0 = CBFnametable_name(names, first+j);
+    res = writeQUADTERM(pFile, 1.0, prefix, name0, name0, &linelen);
+  }
+
+  if (res == CBF_RES_OK)
+    if (fprintf(pFile, " ] <= 0\n") <= 0)
+      res = CBF_RES_ERR;
+
+  return res;
+}
+
+static CBFresponsee writeCONEBOUNDS(FILE *pFile, CBFscalarconee domain, long long int dim, const char *prefix, const CBFnametable *names, long long int first)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int j, lead = 0;
+  const char *name;
+
+  // Variables are nonnegative unless stated otherwise
+  for (j=0; j<dim && res==CBF_RES_OK; ++j) {
+    name = CBFnametable_name(names, first+j);
+
+    switch (domain) {
+    case CBF_CONE_POS:
+      break;
+
+    case CBF_CONE_NEG:
+      if (fprintf(pFile, " -inf <= %s%s <= 0\n", prefix, name) <= 0)
+        res = CBF_RES_ERR;
+      break;
+
+    case CBF_CONE_ZERO:
+      if (fprintf(pFile, " %s%s = 0\n", prefix, name) <= 0)
+        res = CBF_RES_ERR;
+      break;
+
+    case CBF_CONE_QUAD:
+    case CBF_CONE_RQUAD:
+      lead = (domain == CBF_CONE_QUAD ? 1 : 2);
+      if (j < lead)
+        break;
+      if (fprintf(pFile, " %s%s free\n", prefix, name) <= 0)
+        res = CBF_RES_ERR;
+      break;
+
+    default:
+      if (fprintf(pFile, " %s%s free\n", prefix, name) <= 0)
+        res = CBF_RES_ERR;
+      break;
+    }
+  }
+
+  return res;
+}
@@ -24,6 +24,15 @@
 static CBFresponsee
   write(const char *file, const CBFdata data);
 
+static CBFresponsee
+  stream(const char *file, CBFstream *stream);
+
+static CBFresponsee
+  check(const CBFdata data);
+
+static CBFresponsee
+  writeFILE(FILE *pFile, const CBFdata data, CBFextsort *acoord);
+
 static CBFresponsee
   writeROWS(FILE *pFile, const CBFdata data);
 
@@ -35,7 +44,7 @@ static CBFresponsee
 // Global variable
 // -------------------------------------
 
-CBFbackend const backend_mps_cplex = { "mps-cplex", "mps", write };
+CBFbackend const backend_mps_cplex = { "mps-cplex", "mps", write, stream };
 
 
 // -------------------------------------
@@ -46,9 +55,9 @@ static CBFresponsee write(const char *file, const CBFdata data) {
   CBFresponsee res = CBF_RES_OK;
   FILE *pFile = NULL;
 
-  if (data.psdmapnum >= 1 || data.psdvarnum >= 1) {
-    printf("Positive semidefinite domains are not supported in the selected output file format.\n");
-    return CBF_RES_ERR;
+  res = check(data);
+  if (res != CBF_RES_OK) {
+    return res;
   }
 
   pFile = fopen(file, "wt");
@@ -56,31 +65,90 @@ static CBFresponsee write(const char *file, const CBFdata data) {
     return CBF_RES_ERR;
   }
 
+  res = writeFILE(pFile, data, NULL);
+
+  fclose(pFile);
+  return res;
+}
+
+static CBFresponsee stream(const char *file, CBFstream *stream) {
+  return MPS_stream(file, stream, check, writeFILE);
+}
+
+static CBFresponsee check(const CBFdata data) {
+  long long int i;
+
+  if (data.psdmapnum >= 1 || data.psdvarnum >= 1) {
+    printf("Positive semidefinite domains are not supported in the selected output file format.\n");
+    return CBF_RES_ERR;
+  }
+
+  for (i=0; i<data.varstacknum; ++i) {
+    if (data.varstackdomain[i] == CBF_CONE_PPOW || data.varstackdomain[i] == CBF_CONE_DPOW) {
+      printf("Power cone domains are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+    if (data.varstackdomain[i] == CBF_CONE_PEXP || data.varstackdomain[i] == CBF_CONE_DEXP) {
+      printf("Exponential cone domains are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+    if ((data.varstackdomain[i] == CBF_CONE_QUAD || data.varstackdomain[i] == CBF_CONE_RQUAD) && data.varstackdim[i] < 2) {
+      printf("Quadratic cone domains of dimension below two are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+  }
+
+  for (i=0; i<data.mapstacknum; ++i) {
+    if (data.mapstackdomain[i] == CBF_CONE_PPOW || data.mapstackdomain[i] == CBF_CONE_DPOW) {
+      printf("Power cone domains are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+    if (data.mapstackdomain[i] == CBF_CONE_PEXP || data.mapstackdomain[i] == CBF_CONE_DEXP) {
+      printf("Exponential cone domains are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+    if ((data.mapstackdomain[i] == CBF_CONE_QUAD || data.mapstackdomain[i] == CBF_CONE_RQUAD) && data.mapstackdim[i] < 2) {
+      printf("Quadratic cone domains of dimension below two are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+  }
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee writeFILE(FILE *pFile, const CBFdata data, CBFextsort *acoord) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFnametable varname, mapname;
+  CBFdata named = data;
+
+  res = MPS_initnames(&named, &varname, &mapname);
+
   if (res == CBF_RES_OK)
-    res = MPS_writeNAME(pFile, data);
+    res = MPS_writeNAME(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeOBJSENSE(pFile, data);
+    res = MPS_writeOBJSENSE(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = writeROWS(pFile, data);
+    res = writeROWS(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeCOLUMNS(pFile, data);
+    res = MPS_writeCOLUMNS(pFile, named, acoord);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeRHS(pFile, data);
+    res = MPS_writeRHS(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeBOUNDS(pFile, data);
+    res = MPS_writeBOUNDS(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = writeQCMATRIX(pFile, data);
+    res = writeQCMATRIX(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeENDATA(pFile, data);
+    res = MPS_writeENDATA(pFile, named);
+
+  MPS_freenames(&varname, &mapname);
 
-  fclose(pFile);
   return res;
 }
 
@@ -128,6 +196,7 @@ static CBFresponsee writeQCMATRIX(FILE *pFile, const CBFdata data)
 {
   CBFresponsee res = CBF_RES_OK;
   long long int i, j, curvar = 0, curmap = 0;
+  const char *name0, *name1;
 
   for (i=0; i<data.varstacknum && res==CBF_RES_OK; ++i) {
     switch (data.varstackdomain[i]) {
@@ -138,24 +207,28 @@ static CBFresponsee writeQCMATRIX(FILE *pFile, const CBFdata data)
       continue;
     }
 
+    name0 = CBFnametable_name(data.varname, curvar);
+    name1 = CBFnametable_name(data.varname, curvar+1);
+
     if (res == CBF_RES_OK)
       if (fprintf(pFile, "%-10s xK%lli\n", "QCMATRIX", i) <= 0)
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK) {
       if (data.varstackdomain[i] == CBF_CONE_QUAD) {
-        if (fprintf(pFile, "    x%-8lli x%-8lli %.16lg\n    x%-8lli x%-8lli %.16lg\n", curvar, curvar, -1.0, curvar+1, curvar+1, 1.0) <= 0)
+        if (fprintf(pFile, "    %-9s %-9s %.16lg\n    %-9s %-9s %.16lg\n", name0, name0, -1.0, name1, name1, 1.0) <= 0)
           res = CBF_RES_ERR;
 
       } else if (data.varstackdomain[i] == CBF_CONE_RQUAD) {
-        if (fprintf(pFile, "    x%-8lli x%-8lli %.16lg\n    x%-8lli x%-8lli %.16lg\n", curvar, curvar+1, -1.0, curvar+1, curvar, -1.0) <= 0)
+        if (fprintf(pFile, "    %-9s %-9s %.16lg\n    %-9s %-9s %.16lg\n", name0, name1, -1.0, name1, name0, -1.0) <= 0)
           res = CBF_RES_ERR;
       }
     }
     curvar += 2;
 
     for (j=2; j<data.varstackdim[i] && res==CBF_RES_OK; ++j) {
-      if (fprintf(pFile, "    x%-8lli x%-8lli %.16lg\n", curvar, curvar, 1.0) <= 0)
+      name0 = CBFnametable_name(data.varname, curvar);
+      if (fprintf(pFile, "    %-9s %-9s %.16lg\n", name0, name0, 1.0) <= 0)
         res = CBF_RES_ERR;
       ++curvar;
     }
@@ -170,24 +243,28 @@ static CBFresponsee writeQCMATRIX(FILE *pFile, const CBFdata data)
       continue;
     }
 
+    name0 = CBFnametable_name(data.mapname, curmap);
+    name1 = CBFnametable_name(data.mapname, curmap+1);
+
     if (res == CBF_RES_OK)
       if (fprintf(pFile, "%-10s xgK%lli\n", "QCMATRIX", i) <= 0)
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK) {
       if (data.mapstackdomain[i] == CBF_CONE_QUAD) {
-        if (fprintf(pFile, "    xg%-7lli xg%-7lli %.16lg\n    xg%-7lli xg%-7lli %.16lg\n", curmap, curmap, -1.0, curmap+1, curmap+1, 1.0) <= 0)
+        if (fprintf(pFile, "    x%-8s x%-8s %.16lg\n    x%-8s x%-8s %.16lg\n", name0, name0, -1.0, name1, name1, 1.0) <= 0)
           res = CBF_RES_ERR;
 
       } else if (data.mapstackdomain[i] == CBF_CONE_RQUAD) {
-        if (fprintf(pFile, "    xg%-7lli xg%-7lli %.16lg\n    xg%-7lli xg%-7lli %.16lg\n", curmap, curmap+1, -1.0, curmap+1, curmap, -1.0) <= 0)
+        if (fprintf(pFile, "    x%-8s x%-8s %.16lg\n    x%-8s x%-8s %.16lg\n", name0, name1, -1.0, name1, name0, -1.0) <= 0)
           res = CBF_RES_ERR;
       }
     }
     curmap += 2;
 
     for (j=2; j<data.mapstackdim[i] && res==CBF_RES_OK; ++j) {
-      if (fprintf(pFile, "    xg%-7lli xg%-7lli %.16lg\n", curmap, curmap, 1.0) <= 0)
+      name0 = CBFnametable_name(data.mapname, curmap);
+      if (fprintf(pFile, "    x%-8s x%-8s %.16lg\n", name0, name0, 1.0) <= 0)
         res = CBF_RES_ERR;
       ++curmap;
     }
@@ -24,6 +24,15 @@
 static CBFresponsee
   write(const char *file, const CBFdata data);
 
+static CBFresponsee
+  stream(const char *file, CBFstream *stream);
+
+static CBFresponsee
+  check(const CBFdata data);
+
+static CBFresponsee
+  writeFILE(FILE *pFile, const CBFdata data, CBFextsort *acoord);
+
 static CBFresponsee
   writeCSECTION(FILE *pFile, const CBFdata data);
 
@@ -32,7 +41,7 @@ static CBFresponsee
 // Global variable
 // -------------------------------------
 
-CBFbackend const backend_mps_mosek = { "mps-mosek", "mps", write };
+CBFbackend const backend_mps_mosek = { "mps-mosek", "mps", write, stream };
 
 
 // -------------------------------------
@@ -43,9 +52,9 @@ static CBFresponsee write(const char *file, const CBFdata data) {
   CBFresponsee res = CBF_RES_OK;
   FILE *pFile = NULL;
 
-  if (data.psdmapnum >= 1 || data.psdvarnum >= 1) {
-    printf("Positive semidefinite domains are not supported in the selected output file format.\n");
-    return CBF_RES_ERR;
+  res = check(data);
+  if (res != CBF_RES_OK) {
+    return res;
   }
 
   pFile = fopen(file, "wt");
@@ -53,31 +62,82 @@ static CBFresponsee write(const char *file, const CBFdata data) {
     return CBF_RES_ERR;
   }
 
+  res = writeFILE(pFile, data, NULL);
+
+  fclose(pFile);
+  return res;
+}
+
+static CBFresponsee stream(const char *file, CBFstream *stream) {
+  return MPS_stream(file, stream, check, writeFILE);
+}
+
+static CBFresponsee check(const CBFdata data) {
+  long long int i;
+
+  if (data.psdmapnum >= 1 || data.psdvarnum >= 1) {
+    printf("Positive semidefinite domains are not supported in the selected output file format.\n");
+    return CBF_RES_ERR;
+  }
+
+  for (i=0; i<data.varstacknum; ++i) {
+    if (data.varstackdomain[i] == CBF_CONE_PPOW || data.varstackdomain[i] == CBF_CONE_DPOW) {
+      printf("Power cone domains are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+    if (data.varstackdomain[i] == CBF_CONE_RQUAD && data.varstackdim[i] < 2) {
+      printf("Rotated quadratic cone domains of dimension below two are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+  }
+
+  for (i=0; i<data.mapstacknum; ++i) {
+    if (data.mapstackdomain[i] == CBF_CONE_PPOW || data.mapstackdomain[i] == CBF_CONE_DPOW) {
+      printf("Power cone domains are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+    if (data.mapstackdomain[i] == CBF_CONE_RQUAD && data.mapstackdim[i] < 2) {
+      printf("Rotated quadratic cone domains of dimension below two are not supported in the selected output file format.\n");
+      return CBF_RES_ERR;
+    }
+  }
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee writeFILE(FILE *pFile, const CBFdata data, CBFextsort *acoord) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFnametable varname, mapname;
+  CBFdata named = data;
+
+  res = MPS_initnames(&named, &varname, &mapname);
+
   if (res == CBF_RES_OK)
-    res = MPS_writeNAME(pFile, data);
+    res = MPS_writeNAME(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeOBJSENSE(pFile, data);
+    res = MPS_writeOBJSENSE(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeROWS(pFile, data);
+    res = MPS_writeROWS(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeCOLUMNS(pFile, data);
+    res = MPS_writeCOLUMNS(pFile, named, acoord);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeRHS(pFile, data);
+    res = MPS_writeRHS(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeBOUNDS(pFile, data);
+    res = MPS_writeBOUNDS(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = writeCSECTION(pFile, data);
+    res = writeCSECTION(pFile, named);
 
   if (res == CBF_RES_OK)
-    res = MPS_writeENDATA(pFile, data);
+    res = MPS_writeENDATA(pFile, named);
+
+  MPS_freenames(&varname, &mapname);
 
-  fclose(pFile);
   return res;
 }
 
@@ -91,6 +151,8 @@ static CBFresponsee writeCSECTION(FILE *pFile, const CBFdata data)
     switch (data.varstackdomain[i]) {
     case CBF_CONE_QUAD:       domain = "QUAD";  break;
     case CBF_CONE_RQUAD:      domain = "RQUAD"; break;
+    case CBF_CONE_PEXP:       domain = "PEXP";  break;
+    case CBF_CONE_DEXP:       domain = "DEXP";  break;
     default:
       curvar += data.varstackdim[i];
       continue;
@@ -101,7 +163,7 @@ static CBFresponsee writeCSECTION(FILE *pFile, const CBFdata data)
         res = CBF_RES_ERR;
 
     for (j=0; j<data.varstackdim[i] && res==CBF_RES_OK; ++j) {
-      if (fprintf(pFile, "    x%lli\n", curvar) <= 0)
+      if (fprintf(pFile, "    %s\n", CBFnametable_name(data.varname, curvar)) <= 0)
         res = CBF_RES_ERR;
       ++curvar;
     }
@@ -111,6 +173,8 @@ static CBFresponsee writeCSECTION(FILE *pFile, const CBFdata data)
     switch(data.mapstackdomain[i]) {
     case CBF_CONE_QUAD:       domain = "QUAD";  break;
     case CBF_CONE_RQUAD:      domain = "RQUAD"; break;
+    case CBF_CONE_PEXP:       domain = "PEXP";  break;
+    case CBF_CONE_DEXP:       domain = "DEXP";  break;
     default:
       curmap += data.mapstackdim[i];
       continue;
@@ -121,7 +185,7 @@ static CBFresponsee writeCSECTION(FILE *pFile, const CBFdata data)
         res = CBF_RES_ERR;
 
     for (j=0; j<data.mapstackdim[i] && res==CBF_RES_OK; ++j) {
-      if (fprintf(pFile, "    xg%lli\n", curmap) <= 0)
+      if (fprintf(pFile, "    x%s\n", CBFnametable_name(data.mapname, curmap)) <= 0)
         res = CBF_RES_ERR;
       ++curmap;
     }
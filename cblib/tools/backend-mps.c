@@ -20,10 +20,85 @@
 #include "cbf-helper.h"
 #include <stddef.h>
 #include <stdlib.h>
+#include <string.h>
+
+// Coordinates of A in column-major order, read by index or from an external sort
+typedef struct MPSacursor_struct {
+  const CBFdata *data;
+  const long long int *aidx;
+  CBFextsort *acoord;
+  long long int pos;
+
+  long long int asubi;
+  long long int asubj;
+  double aval;
+} MPSacursor;
+
+typedef struct MPSwriter_struct {
+  FILE *pFile;
+  CBFdata data;           // Structure and all coordinates but those of A
+  CBFdyndata dyndata;
+  CBFextsort acoord;      // Coordinates of A in column-major order
+
+  CBFresponsee (*check)(const CBFdata data);
+  CBFresponsee (*write)(FILE *pFile, const CBFdata data, CBFextsort *acoord);
+} MPSwriter;
 
 static CBFresponsee
-  MPS_writeCOLUMNS_controlINTEGERMARK(FILE *pFile, const CBFdata data, long long int xID, const long long int *intidx, long long int *curint, long long int *curintmark, int *isintegermark);
+  MPS_stream_structure(void *userdata, CBFdata *data);
 
+static CBFresponsee
+  MPS_stream_blockbegin(void *userdata, CBFblocke block, long long int nnz);
+
+static CBFresponsee
+  MPS_stream_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk);
+
+static CBFresponsee
+  MPS_stream_blockend(void *userdata, CBFblocke block);
+
+static CBFresponsee
+  MPS_stream_finish(void *userdata, CBFresponsee res);
+
+static CBFresponsee
+  MPS_writeCOLUMNS_nextA(MPSacursor *acur, int *isend);
+
+static CBFresponsee
+  MPS_writeCOLUMNS_controlINTEGERMARK(FILE *pFile, int isinteger, long long int *curintmark, int *isintegermark);
+
+
+CBFresponsee MPS_initnames(CBFdata *data, CBFnametable *varname, CBFnametable *mapname)
+{
+  CBFresponsee res = CBF_RES_OK;
+  char name[32];
+  long long int i;
+
+  memset(varname, 0, sizeof(*varname));
+  memset(mapname, 0, sizeof(*mapname));
+
+  if (!data->varname) {
+    for (i=0; i<data->varnum && res==CBF_RES_OK; ++i) {
+      sprintf(name, "x%lli", i);
+      res = CBFnametable_push(varname, name);
+    }
+    data->varname = varname;
+  }
+
+  if (!data->mapname) {
+    for (i=0; i<data->mapnum && res==CBF_RES_OK; ++i) {
+      sprintf(name, "g%lli", i);
+      res = CBFnametable_push(mapname, name);
+    }
+    data->mapname = mapname;
+  }
+
+  return res;
+}
+
+void MPS_freenames(CBFnametable *varname, CBFnametable *mapname)
+{
+  CBFnametable_free(varname);
+  CBFnametable_free(mapname);
+}
 
 CBFresponsee MPS_writeNAME(FILE *pFile, const CBFdata data)
 {
@@ -78,13 +153,15 @@ CBFresponsee MPS_writeROWS(FILE *pFile, const CBFdata data)
     case CBF_CONE_ZERO:         domain = "E";   break;
     case CBF_CONE_QUAD:         domain = "E";   break;
     case CBF_CONE_RQUAD:        domain = "E";   break;
+    case CBF_CONE_PEXP:         domain = "E";   break;
+    case CBF_CONE_DEXP:         domain = "E";   break;
     default:
       res = CBF_RES_ERR;
       break;
     }
 
     for (j=0; j<data.mapstackdim[i] && res==CBF_RES_OK; ++j) {
-      if (fprintf(pFile, " %s  g%lli\n", domain, curmap) <= 0)
+      if (fprintf(pFile, " %s  %s\n", domain, CBFnametable_name(data.mapname, curmap)) <= 0)
         res = CBF_RES_ERR;
       ++curmap;
     }
@@ -92,60 +169,69 @@ CBFresponsee MPS_writeROWS(FILE *pFile, const CBFdata data)
   return res;
 }
 
-CBFresponsee MPS_writeCOLUMNS(FILE *pFile, const CBFdata data)
+CBFresponsee MPS_writeCOLUMNS(FILE *pFile, const CBFdata data, CBFextsort *acoord)
 {
   CBFresponsee res = CBF_RES_OK;
   long long int i, j, curmap = 0;
-  long long int *aidx = NULL, *objaidx = NULL, *intidx = NULL;
-  int isintegermark = 0;
-  long long int lastj = -1, curobja = 0, curint = 0, curintmark = 0;
-
-  aidx = (long long int *) malloc(data.annz * sizeof(aidx[0]));
+  long long int *aidx = NULL, *objabeg = NULL, *objaidx = NULL, *intbeg = NULL;
+  const char *colname;
+  int isintegermark = 0, isend = 1;
+  long long int curintmark = 0;
+  long long int key[2];
+  MPSacursor acur;
+  CBFextsort sorter;
+
+  memset(&sorter, 0, sizeof(sorter));
+  memset(&acur, 0, sizeof(acur));
+  acur.data = &data;
+
+  // Coordinates exceeding the memory budget are sorted externally
+  if (!acoord && CBFextsort_required(data.annz))
+    acoord = &sorter;
+
+  aidx    = (long long int *) malloc((acoord ? 0 : data.annz) * sizeof(aidx[0]));
+  objabeg = (long long int *) malloc((data.varnum + 1) * sizeof(objabeg[0]));
   objaidx = (long long int *) malloc(data.objannz * sizeof(objaidx[0]));
-  intidx  = (long long int *) malloc(data.intvarnum * sizeof(intidx[0]));
+  intbeg  = (long long int *) malloc((data.varnum + 1) * sizeof(intbeg[0]));
 
-  if (!aidx || !objaidx || !intidx) {
+  if ((!acoord && data.annz >= 1 && !aidx) || !objabeg || (data.objannz >= 1 && !objaidx) || !intbeg) {
     if (aidx)           free(aidx);
+    if (objabeg)        free(objabeg);
     if (objaidx)        free(objaidx);
-    if (intidx)         free(intidx);
+    if (intbeg)         free(intbeg);
     return CBF_RES_ERR;
   }
 
   //
-  // Sort a-coefficients, obja-coefficients, and integer variable indexes
+  // Transpose a-coefficients, obja-coefficients, and integer variable indexes to columns
   //
-  if (data.annz >= 1)
+  if (acoord == &sorter)
   {
-    if (res == CBF_RES_OK)
-      for (i=0; i<data.annz; ++i)
-        aidx[i] = i;
+    res = CBFextsort_init(&sorter, 2);
 
-    if (res == CBF_RES_OK)
-      res = CBF_bucketsort(data.mapnum-1, data.annz, data.asubi, aidx);   // secondarily by asubi
+    for (i=0; i<data.annz && res==CBF_RES_OK; ++i) {
+      key[0] = data.asubj[i];                                             // primarily by asubj
+      key[1] = data.asubi[i];                                             // secondarily by asubi
+      res = CBFextsort_add(&sorter, key, data.aval[i]);
+    }
 
-    if ( res==CBF_RES_OK )
-      res = CBF_bucketsort(data.varnum-1, data.annz, data.asubj, aidx);   // primarily by asubj
+    if (res == CBF_RES_OK)
+      res = CBFextsort_merge(&sorter);
   }
-
-  if (data.objannz >= 1)
+  else if (!acoord)
   {
     if (res == CBF_RES_OK)
-      for (i=0; i<data.objannz; ++i)
-        objaidx[i] = i;
-
-    if (res == CBF_RES_OK)
-      res = CBF_bucketsort(data.varnum-1, data.objannz, data.objasubj, objaidx);
+      res = CBF_transpose(data.annz, data.asubi, data.mapnum-1, data.asubj, data.varnum-1, NULL, aidx);
   }
 
-  if (data.intvarnum >= 1)
-  {
-    if (res == CBF_RES_OK)
-      for (i=0; i<data.intvarnum; ++i)
-        intidx[i] = i;
+  acur.aidx = aidx;
+  acur.acoord = acoord;
 
-    if ( res==CBF_RES_OK )
-      res = CBF_bucketsort(data.varnum-1, data.intvarnum, data.intvar, intidx);
-  }
+  if (res == CBF_RES_OK)
+    res = CBF_transpose(data.objannz, NULL, 0, data.objasubj, data.varnum-1, objabeg, objaidx);
+
+  if (res == CBF_RES_OK)
+    res = CBF_transpose(data.intvarnum, NULL, 0, data.intvar, data.varnum-1, intbeg, NULL);
 
   //
   // Write data
@@ -154,68 +240,34 @@ CBFresponsee MPS_writeCOLUMNS(FILE *pFile, const CBFdata data)
     if (fprintf(pFile, "COLUMNS\n") <= 0)
       res = CBF_RES_ERR;
 
-  for (i=0; i<data.annz && res==CBF_RES_OK; ++i) {
-
-    // Insert objective coefficient of variables
-    // that do not appear in any column.
-    for (j=lastj+1; j<data.asubj[aidx[i]] && res==CBF_RES_OK; ++j) {
-      res = MPS_writeCOLUMNS_controlINTEGERMARK(pFile, data, j, intidx, &curint, &curintmark, &isintegermark);
-
-      if ( res==CBF_RES_OK ) {
-        if ( curobja < data.objannz && data.objasubj[objaidx[curobja]] == j ) {
-          if (fprintf(pFile, "    x%-8lli %-9s %.16lg\n", j, "obj", data.objaval[objaidx[curobja]]) <= 0) {
-            res = CBF_RES_ERR;
-          }
-          ++curobja;
-        
-        } else {
-          if (fprintf(pFile, "    x%-8lli %-9s %.16lg\n", j, "obj", 0.0) <= 0)
-            res = CBF_RES_ERR;
-        }
-      }
-    }
-    
-    // Insert coefficients of current variable
-    if ( res==CBF_RES_OK )
-      res = MPS_writeCOLUMNS_controlINTEGERMARK(pFile, data, data.asubj[aidx[i]], intidx, &curint, &curintmark, &isintegermark);
-    
-    if ( res==CBF_RES_OK ) {
-      if ( lastj != data.asubj[aidx[i]] ) {
-        if ( curobja < data.objannz && data.objasubj[objaidx[curobja]] == j ) {
-          if (fprintf(pFile, "    x%-8lli %-9s %.16lg\n", j, "obj", data.objaval[objaidx[curobja]]) <= 0) {
-            res = CBF_RES_ERR;
-          }
-          ++curobja;
-        }
-      }
-    }
-    
-    if ( res==CBF_RES_OK )
-      if (fprintf(pFile, "    x%-8lli g%-8lli %.16lg\n", data.asubj[aidx[i]], data.asubi[aidx[i]], data.aval[aidx[i]]) <= 0)
-        res = CBF_RES_ERR;
-    
-    lastj = data.asubj[aidx[i]];
-  }
+  if (res == CBF_RES_OK)
+    res = MPS_writeCOLUMNS_nextA(&acur, &isend);
 
-  // Insert objective coefficient of variables
-  // that do not appear in any column.
-  for (j=lastj+1; j<data.varnum && res==CBF_RES_OK; ++j) {
-    res = MPS_writeCOLUMNS_controlINTEGERMARK(pFile, data, j, intidx, &curint, &curintmark, &isintegermark);
+  for (j=0; j<data.varnum && res==CBF_RES_OK; ++j) {
+    colname = CBFnametable_name(data.varname, j);
+    res = MPS_writeCOLUMNS_controlINTEGERMARK(pFile, (intbeg[j+1] > intbeg[j]), &curintmark, &isintegermark);
 
-    if ( res==CBF_RES_OK )
-    {
-      if ( curobja < data.objannz && data.objasubj[objaidx[curobja]] == j )
-      {
-        if (fprintf(pFile, "    x%-8lli %-9s %.16lg\n", j, "obj", data.objaval[objaidx[curobja]]) <= 0)
+    // Insert objective coefficient of variable,
+    // also when zero if it does not appear in any row.
+    if ( res==CBF_RES_OK ) {
+      if ( objabeg[j+1] > objabeg[j] ) {
+        if (fprintf(pFile, "    %-9s %-9s %.16lg\n", colname, "obj", data.objaval[objaidx[objabeg[j]]]) <= 0)
           res = CBF_RES_ERR;
-        ++curobja;
-      }
-      else
-      {
-        if (fprintf(pFile, "    x%-8lli %-9s %.16lg\n", j, "obj", 0.0) <= 0)
+
+      } else if ( isend || acur.asubj != j ) {
+        if (fprintf(pFile, "    %-9s %-9s %.16lg\n", colname, "obj", 0.0) <= 0)
           res = CBF_RES_ERR;
       }
     }
+
+    // Insert coefficients of current variable
+    while (!isend && acur.asubj == j && res==CBF_RES_OK) {
+      if (fprintf(pFile, "    %-9s %-9s %.16lg\n", colname, CBFnametable_name(data.mapname, acur.asubi), acur.aval) <= 0)
+        res = CBF_RES_ERR;
+
+      if ( res==CBF_RES_OK )
+        res = MPS_writeCOLUMNS_nextA(&acur, &isend);
+    }
   }
 
   // Close integer mark if still open
@@ -235,8 +287,10 @@ CBFresponsee MPS_writeCOLUMNS(FILE *pFile, const CBFdata data)
     {
     case CBF_CONE_QUAD:
     case CBF_CONE_RQUAD:
+    case CBF_CONE_PEXP:
+    case CBF_CONE_DEXP:
       for (j=0; j<data.mapstackdim[i] && res==CBF_RES_OK; ++j) {
-        if (fprintf(pFile, "    xg%-7lli g%-8lli %.16lg\n", curmap, curmap, -1.0) <= 0)
+        if (fprintf(pFile, "    x%-8s %-9s %.16lg\n", CBFnametable_name(data.mapname, curmap), CBFnametable_name(data.mapname, curmap), -1.0) <= 0)
           res = CBF_RES_ERR;
         ++curmap;
       }
@@ -247,45 +301,59 @@ CBFresponsee MPS_writeCOLUMNS(FILE *pFile, const CBFdata data)
     }
   }
 
+  CBFextsort_free(&sorter);
   free(aidx);
-  free(intidx);
+  free(objabeg);
+  free(objaidx);
+  free(intbeg);
+
+  return res;
+}
+
+static CBFresponsee MPS_writeCOLUMNS_nextA(MPSacursor *acur, int *isend)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int k, key[2];
+
+  if (acur->acoord) {
+    res = CBFextsort_next(acur->acoord, key, &acur->aval, isend);
+    acur->asubj = key[0];
+    acur->asubi = key[1];
+
+  } else {
+    *isend = (acur->pos == acur->data->annz);
+    if (!*isend) {
+      k = acur->aidx[acur->pos++];
+      acur->asubj = acur->data->asubj[k];
+      acur->asubi = acur->data->asubi[k];
+      acur->aval = acur->data->aval[k];
+    }
+  }
 
   return res;
 }
 
-static CBFresponsee MPS_writeCOLUMNS_controlINTEGERMARK(FILE *pFile, const CBFdata data, long long int xID,
-                                                        const long long int *intidx,
-                                                        long long int       *curint,
+static CBFresponsee MPS_writeCOLUMNS_controlINTEGERMARK(FILE *pFile, int isinteger,
                                                         long long int       *curintmark,
                                                         int                 *isintegermark)
 {
   CBFresponsee res = CBF_RES_OK;
 
   // Handle integer mark
-  if (data.intvarnum >= 1)
-  {
-    while (*curint < data.intvarnum-1 && data.intvar[intidx[*curint]] < xID)
-      ++(*curint);
-
-    if ( res==CBF_RES_OK ) {
-      if (!*isintegermark && data.intvar[intidx[*curint]] == xID) {
-        if (fprintf(pFile, "    MARK%04lli  %-24s %s\n", *curintmark, "'MARKER'", "'INTORG'") <= 0)
-          res = CBF_RES_ERR;
+  if (!*isintegermark && isinteger) {
+    if (fprintf(pFile, "    MARK%04lli  %-24s %s\n", *curintmark, "'MARKER'", "'INTORG'") <= 0)
+      res = CBF_RES_ERR;
 
-        *isintegermark = 1;
-        *curintmark = (*curintmark+1) % 10000;
-      }
-    }
+    *isintegermark = 1;
+    *curintmark = (*curintmark+1) % 10000;
+  }
 
-    if ( res==CBF_RES_OK ) {
-      if (*isintegermark && data.intvar[intidx[*curint]] != xID) {
-        if (fprintf(pFile, "    MARK%04lli  %-24s %s\n", *curintmark, "'MARKER'", "'INTEND'") <= 0)
-          res = CBF_RES_ERR;
+  if (*isintegermark && !isinteger) {
+    if (fprintf(pFile, "    MARK%04lli  %-24s %s\n", *curintmark, "'MARKER'", "'INTEND'") <= 0)
+      res = CBF_RES_ERR;
 
-        *isintegermark = 0;
-        *curintmark = (*curintmark+1) % 10000;
-      }
-    }
+    *isintegermark = 0;
+    *curintmark = (*curintmark+1) % 10000;
   }
 
   return res;
@@ -308,7 +376,7 @@ CBFresponsee MPS_writeRHS(FILE *pFile, const CBFdata data)
           res = CBF_RES_ERR;
 
     for (i=0; i<data.bnnz && res==CBF_RES_OK; ++i)
-      if (fprintf(pFile, "    %-9s g%-8lli %.16lg\n", "BVEC", data.bsubi[i], -data.bval[i]) <= 0)
+      if (fprintf(pFile, "    %-9s %-9s %.16lg\n", "BVEC", CBFnametable_name(data.mapname, data.bsubi[i]), -data.bval[i]) <= 0)
         res = CBF_RES_ERR;
   }
 
@@ -337,14 +405,18 @@ CBFresponsee MPS_writeBOUNDS(FILE *pFile, const CBFdata data)
     case CBF_CONE_ZERO:
       stackidx = 0;     domain1 = NULL; domain2 = "FX";  break;
     case CBF_CONE_QUAD:
-      if (fprintf(pFile, " %s %-9s x%-8lli\n", "PL", "DOMAIN", curvar) <= 0)
+      if (fprintf(pFile, " %s %-9s %-9s\n", "PL", "DOMAIN", CBFnametable_name(data.varname, curvar)) <= 0)
         res = CBF_RES_ERR;
       stackidx = 1;     domain1 = "FR"; domain2 = NULL;  break;
     case CBF_CONE_RQUAD:
-      if (fprintf(pFile, " %s %-9s x%-8lli\n"
-                         " %s %-9s x%-8lli\n", "PL", "DOMAIN", curvar, "PL", "DOMAIN", curvar+1) <= 0)
+      if (fprintf(pFile, " %s %-9s %-9s\n"
+                         " %s %-9s %-9s\n", "PL", "DOMAIN", CBFnametable_name(data.varname, curvar),
+                                             "PL", "DOMAIN", CBFnametable_name(data.varname, curvar+1)) <= 0)
         res = CBF_RES_ERR;
       stackidx = 2;     domain1 = "FR"; domain2 = NULL;  break;
+    case CBF_CONE_PEXP:
+    case CBF_CONE_DEXP:
+      stackidx = 0;     domain1 = "FR"; domain2 = NULL;  break;         // Cone membership is left to the conic section
     default:
       res = CBF_RES_ERR;
       break;
@@ -353,10 +425,10 @@ CBFresponsee MPS_writeBOUNDS(FILE *pFile, const CBFdata data)
     curvar += stackidx;
     for (j=stackidx; j<data.varstackdim[i] && res==CBF_RES_OK; ++j) {
       if (domain1 != NULL)
-        if (fprintf(pFile, " %s %-9s x%-8lli\n", domain1, "DOMAIN", curvar) <= 0)
+        if (fprintf(pFile, " %s %-9s %-9s\n", domain1, "DOMAIN", CBFnametable_name(data.varname, curvar)) <= 0)
           res = CBF_RES_ERR;
       if (domain2 != NULL)
-        if (fprintf(pFile, " %s %-9s x%-8lli %.16lg\n", domain2, "DOMAIN", curvar, 0.0) <= 0)
+        if (fprintf(pFile, " %s %-9s %-9s %.16lg\n", domain2, "DOMAIN", CBFnametable_name(data.varname, curvar), 0.0) <= 0)
           res = CBF_RES_ERR;
       ++curvar;
     }
@@ -367,16 +439,20 @@ CBFresponsee MPS_writeBOUNDS(FILE *pFile, const CBFdata data)
     switch(data.mapstackdomain[i])
     {
     case CBF_CONE_QUAD:
-      if (fprintf(pFile, " %s %-9s xg%-7lli\n", "PL", "DOMAIN", curmap) <= 0)
+      if (fprintf(pFile, " %s %-9s x%-8s\n", "PL", "DOMAIN", CBFnametable_name(data.mapname, curmap)) <= 0)
         res = CBF_RES_ERR;
       stackidx = 1;     domain1 = "FR";  break;
       break;
     case CBF_CONE_RQUAD:
-      if (fprintf(pFile, " %s %-9s xg%-7lli\n"
-                         " %s %-9s xg%-7lli\n", "PL", "DOMAIN", curmap, "PL", "DOMAIN", curmap+1) <= 0)
+      if (fprintf(pFile, " %s %-9s x%-8s\n"
+                         " %s %-9s x%-8s\n", "PL", "DOMAIN", CBFnametable_name(data.mapname, curmap),
+                                              "PL", "DOMAIN", CBFnametable_name(data.mapname, curmap+1)) <= 0)
         res = CBF_RES_ERR;
       stackidx = 2;     domain1 = "FR";  break;
       break;
+    case CBF_CONE_PEXP:
+    case CBF_CONE_DEXP:
+      stackidx = 0;     domain1 = "FR";  break;
     default:
       curmap += data.mapstackdim[i];
       continue;
@@ -384,7 +460,7 @@ CBFresponsee MPS_writeBOUNDS(FILE *pFile, const CBFdata data)
 
     curmap += stackidx;
     for (j=stackidx; j<data.mapstackdim[i] && res==CBF_RES_OK; ++j) {
-      if (fprintf(pFile, " %s %-9s xg%-7lli\n", domain1, "DOMAIN", curmap) <= 0)
+      if (fprintf(pFile, " %s %-9s x%-8s\n", domain1, "DOMAIN", CBFnametable_name(data.mapname, curmap)) <= 0)
         res = CBF_RES_ERR;
       ++curmap;
     }
@@ -402,3 +478,150 @@ CBFresponsee MPS_writeENDATA(FILE *pFile, const CBFdata data)
 
   return res;
 }
+
+CBFresponsee MPS_stream(const char *file, CBFstream *stream,
+                        CBFresponsee (*check)(const CBFdata data),
+                        CBFresponsee (*write)(FILE *pFile, const CBFdata data, CBFextsort *acoord))
+{
+  CBFresponsee res = CBF_RES_OK;
+  MPSwriter *writer = NULL;
+
+  writer = (MPSwriter*) calloc(1, sizeof(*writer));
+  if (!writer) {
+    return CBF_RES_ERR;
+  }
+
+  writer->dyndata.data = &writer->data;
+  writer->check = check;
+  writer->write = write;
+
+  res = CBFextsort_init(&writer->acoord, 2);
+
+  if (res == CBF_RES_OK) {
+    writer->pFile = fopen(file, "wt");
+    if (!writer->pFile)
+      res = CBF_RES_ERR;
+  }
+
+  if (res != CBF_RES_OK) {
+    free(writer);
+    return res;
+  }
+
+  stream->userdata   = writer;
+  stream->structure  = MPS_stream_structure;
+  stream->blockbegin = MPS_stream_blockbegin;
+  stream->blockchunk = MPS_stream_blockchunk;
+  stream->blockend   = MPS_stream_blockend;
+  stream->finish     = MPS_stream_finish;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee MPS_stream_structure(void *userdata, CBFdata *data)
+{
+  CBFresponsee res = CBF_RES_OK;
+  MPSwriter *writer = (MPSwriter*) userdata;
+
+  res = writer->check(*data);
+
+  // The structure is copied, as it is not kept by the caller until the end of the stream
+  if (res == CBF_RES_OK)
+    res = CBFdyn_map_capacitysurplus(&writer->dyndata, data->mapstacknum);
+
+  if (res == CBF_RES_OK)
+    res = CBFdyn_var_capacitysurplus(&writer->dyndata, data->varstacknum);
+
+  if (res == CBF_RES_OK)
+    res = CBFdyn_intvar_capacitysurplus(&writer->dyndata, data->intvarnum);
+
+  if (res == CBF_RES_OK) {
+    writer->data.ver = data->ver;
+    writer->data.objsense = data->objsense;
+
+    writer->data.mapnum = data->mapnum;
+    writer->data.mapstacknum = data->mapstacknum;
+    memcpy(writer->data.mapstackdim, data->mapstackdim, data->mapstacknum * sizeof(data->mapstackdim[0]));
+    memcpy(writer->data.mapstackdomain, data->mapstackdomain, data->mapstacknum * sizeof(data->mapstackdomain[0]));
+
+    writer->data.varnum = data->varnum;
+    writer->data.varstacknum = data->varstacknum;
+    memcpy(writer->data.varstackdim, data->varstackdim, data->varstacknum * sizeof(data->varstackdim[0]));
+    memcpy(writer->data.varstackdomain, data->varstackdomain, data->varstacknum * sizeof(data->varstackdomain[0]));
+
+    writer->data.intvarnum = data->intvarnum;
+    memcpy(writer->data.intvar, data->intvar, data->intvarnum * sizeof(data->intvar[0]));
+  }
+
+  return res;
+}
+
+static CBFresponsee MPS_stream_blockbegin(void *userdata, CBFblocke block, long long int nnz)
+{
+  MPSwriter *writer = (MPSwriter*) userdata;
+
+  switch (block) {
+  case CBF_BLOCK_OBJACOORD:     return CBFdyn_obja_capacitysurplus(&writer->dyndata, nnz);
+  case CBF_BLOCK_BCOORD:        return CBFdyn_b_capacitysurplus(&writer->dyndata, nnz);
+  default:                      return CBF_RES_OK;
+  }
+}
+
+static CBFresponsee MPS_stream_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk)
+{
+  CBFresponsee res = CBF_RES_OK;
+  MPSwriter *writer = (MPSwriter*) userdata;
+  long long int i, key[2];
+
+  switch (block) {
+  case CBF_BLOCK_OBJACOORD:
+    for (i=0; i<chunk->objannz && res==CBF_RES_OK; ++i)
+      res = CBFdyn_obja_add(&writer->dyndata, chunk->objasubj[i], chunk->objaval[i]);
+    break;
+
+  case CBF_BLOCK_OBJBCOORD:
+    res = CBFdyn_objb_set(&writer->dyndata, chunk->objbval);
+    break;
+
+  case CBF_BLOCK_ACOORD:
+    for (i=0; i<chunk->annz && res==CBF_RES_OK; ++i) {
+      key[0] = chunk->asubj[i];
+      key[1] = chunk->asubi[i];
+      res = CBFextsort_add(&writer->acoord, key, chunk->aval[i]);
+    }
+    break;
+
+  case CBF_BLOCK_BCOORD:
+    for (i=0; i<chunk->bnnz && res==CBF_RES_OK; ++i)
+      res = CBFdyn_b_add(&writer->dyndata, chunk->bsubi[i], chunk->bval[i]);
+    break;
+
+  default:
+    res = CBF_RES_ERR;      // Positive semidefinite coordinates are rejected by 'check'
+    break;
+  }
+
+  return res;
+}
+
+static CBFresponsee MPS_stream_blockend(void *userdata, CBFblocke block)
+{
+  return CBF_RES_OK;
+}
+
+static CBFresponsee MPS_stream_finish(void *userdata, CBFresponsee res)
+{
+  MPSwriter *writer = (MPSwriter*) userdata;
+
+  if (res == CBF_RES_OK)
+    res = CBFextsort_merge(&writer->acoord);
+
+  if (res == CBF_RES_OK)
+    res = writer->write(writer->pFile, writer->data, &writer->acoord);
+
+  fclose(writer->pFile);
+  CBFextsort_free(&writer->acoord);
+  CBFdyn_freedynamicallocations(&writer->dyndata);
+  free(writer);
+  return res;
+}
@@ -21,8 +21,22 @@
 
 #include "cbf-data.h"
 #include "programmingstyle.h"
+#include "cbf-helper.h"
+#include "stream.h"
 #include <stdio.h>      // Unfortunately, no portable forward declaration of FILE
 
+/*
+ * Variables and maps keep the names of 'data' if known, and are otherwise
+ * named 'x<j>' and 'g<i>' in tables written to 'varname' and 'mapname' and
+ * referenced from 'data'. Each name is thereby formatted once, rather than
+ * once per coordinate. MPS_freenames releases the tables.
+ */
+CBFresponsee
+  MPS_initnames(CBFdata *data, CBFnametable *varname, CBFnametable *mapname);
+
+void
+  MPS_freenames(CBFnametable *varname, CBFnametable *mapname);
+
 CBFresponsee
   MPS_writeNAME(FILE *pFile, const CBFdata data);
 
@@ -32,8 +46,9 @@ CBFresponsee
 CBFresponsee
   MPS_writeROWS(FILE *pFile, const CBFdata data);
 
+// Coordinates of A are taken from 'acoord' if given, with keys (asubj, asubi)
 CBFresponsee
-  MPS_writeCOLUMNS(FILE *pFile, const CBFdata data);
+  MPS_writeCOLUMNS(FILE *pFile, const CBFdata data, CBFextsort *acoord);
 
 CBFresponsee
   MPS_writeRHS(FILE *pFile, const CBFdata data);
@@ -44,4 +59,16 @@ CBFresponsee
 CBFresponsee
   MPS_writeENDATA(FILE *pFile, const CBFdata data);
 
+/*
+ * Streams a problem to an MPS file. The coordinates of A are passed through
+ * CBFextsort, and thus held within the memory budget of CBF_SORT_MEMLIMIT,
+ * while the structure and remaining coordinates are kept until the stream
+ * finishes. The file is then written by 'write'. A structure not supported
+ * by the format is rejected up front by 'check'.
+ */
+CBFresponsee
+  MPS_stream(const char *file, CBFstream *stream,
+             CBFresponsee (*check)(const CBFdata data),
+             CBFresponsee (*write)(FILE *pFile, const CBFdata data, CBFextsort *acoord));
+
 #endif
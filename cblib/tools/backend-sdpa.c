@@ -17,10 +17,14 @@
 // 3. This notice may not be removed or altered from any source distribution.
 
 #include "backend-sdpa.h"
+#include "cbf-helper.h"
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
 
+// Size of the output buffer used when writing coordinates
+#define CBF_SDPA_BUFFER  (1 << 20)
+
 static CBFresponsee
   write(const char *file, const CBFdata data);
 
@@ -55,6 +59,7 @@ static CBFresponsee write(const char *file, const CBFdata data) {
   CBFresponsee res = CBF_RES_OK;
   long long int i;
   FILE *pFile = NULL;
+  char *buffer = NULL;
 
   if (data.mapnum >= 1) {
     printf("Scalar map constraints are not supported in the selected output file format.\n");
@@ -88,6 +93,11 @@ static CBFresponsee write(const char *file, const CBFdata data) {
     return CBF_RES_ERR;
   }
 
+  // Coordinates are written one per line, so the default buffer is quickly exhausted
+  buffer = (char*) malloc(CBF_SDPA_BUFFER * sizeof(buffer[0]));
+  if (buffer)
+    setvbuf(pFile, buffer, _IOFBF, CBF_SDPA_BUFFER);
+
   if (res == CBF_RES_OK)
     res = writeVAR(pFile, data);
 
@@ -103,7 +113,10 @@ static CBFresponsee write(const char *file, const CBFdata data) {
   if (res == CBF_RES_OK)
     res = writeINTVAR(pFile, data);
 
-  fclose(pFile);
+  if (fclose(pFile) != 0)
+    res = CBF_RES_ERR;
+
+  free(buffer);
   return res;
 }
 
@@ -170,15 +183,53 @@ static CBFresponsee writeMAPZERO(FILE *pFile, const CBFdata data)
 static CBFresponsee writePSDCON(FILE *pFile, const CBFdata data)
 {
   CBFresponsee res = CBF_RES_OK;
-  long long int i;
+  long long int i, k;
+  long long int *didx = NULL, *hidx = NULL;
+
+  didx = (long long int *) malloc(data.dnnz * sizeof(didx[0]));
+  hidx = (long long int *) malloc(data.hnnz * sizeof(hidx[0]));
+
+  if ((data.dnnz >= 1 && !didx) || (data.hnnz >= 1 && !hidx)) {
+    if (didx)           free(didx);
+    if (hidx)           free(hidx);
+    return CBF_RES_ERR;
+  }
+
+  //
+  // Group coordinates by matrix and block, keeping their order within each
+  //
+  for (i=0; i<data.dnnz; ++i)
+    didx[i] = i;
 
-  for (i=0; i<data.dnnz && res==CBF_RES_OK; ++i)
-    if (fprintf(pFile, "%lli %i %i %i %.16lg\n", 0LL, data.dsubi[i]+1, data.dsubk[i]+1, data.dsubl[i]+1, -data.dval[i]) <= 0)
+  for (i=0; i<data.hnnz; ++i)
+    hidx[i] = i;
+
+  if (res == CBF_RES_OK)
+    res = CBF_bucketsort(data.psdmapnum-1, data.dnnz, data.dsubi, didx);   // by block
+
+  if (res == CBF_RES_OK)
+    res = CBF_bucketsort(data.psdmapnum-1, data.hnnz, data.hsubi, hidx);   // secondarily by block
+
+  if (res == CBF_RES_OK)
+    res = CBF_bucketsort(data.varnum-1, data.hnnz, data.hsubj, hidx);      // primarily by matrix
+
+  //
+  // Write data
+  //
+  for (i=0; i<data.dnnz && res==CBF_RES_OK; ++i) {
+    k = didx[i];
+    if (fprintf(pFile, "%lli %i %i %i %.16lg\n", 0LL, data.dsubi[k]+1, data.dsubk[k]+1, data.dsubl[k]+1, -data.dval[k]) <= 0)
       res = CBF_RES_ERR;
+  }
 
-  for (i=0; i<data.hnnz && res==CBF_RES_OK; ++i)
-    if (fprintf(pFile, "%lli %i %i %i %.16lg\n", data.hsubj[i]+1, data.hsubi[i]+1, data.hsubk[i]+1, data.hsubl[i]+1, data.hval[i]) <= 0)
+  for (i=0; i<data.hnnz && res==CBF_RES_OK; ++i) {
+    k = hidx[i];
+    if (fprintf(pFile, "%lli %i %i %i %.16lg\n", data.hsubj[k]+1, data.hsubi[k]+1, data.hsubk[k]+1, data.hsubl[k]+1, data.hval[k]) <= 0)
       res = CBF_RES_ERR;
+  }
+
+  free(didx);
+  free(hidx);
 
   return res;
 }
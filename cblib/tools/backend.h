@@ -20,6 +20,7 @@
 #define CBF_BACKEND_H
 
 #include "cbf-data.h"
+#include "stream.h"
 #include "programmingstyle.h"
 
 typedef struct CBFbackend_struct {
@@ -27,6 +28,7 @@ typedef struct CBFbackend_struct {
   const char *name;
   const char *format;
   CBFresponsee (*write)(const char *file, const CBFdata data);
+  CBFresponsee (*stream)(const char *file, CBFstream *stream);
 
 } CBFbackend;
 
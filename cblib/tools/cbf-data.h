@@ -19,7 +19,7 @@
 #ifndef CBF_CBF_DATA_H
 #define CBF_CBF_DATA_H
 
-#define CBF_VERSION     2
+#define CBF_VERSION     3
 #define CBF_MAX_LINE  512       // Last 3 chars reserved for '\r\n\0'
 #define CBF_MAX_NAME  512
 
@@ -35,7 +35,7 @@ typedef enum CBFobjsense_enum {
 
 typedef enum CBFscalarcone_enum {
   CBF_CONE_BEGIN = 0,
-  CBF_CONE_END = 8,
+  CBF_CONE_END = 10,
 
   CBF_CONE_FREE = 0,
   CBF_CONE_POS = 1,
@@ -44,10 +44,27 @@ typedef enum CBFscalarcone_enum {
   CBF_CONE_QUAD = 4,
   CBF_CONE_RQUAD = 5,
   CBF_CONE_PEXP = 6,
-  CBF_CONE_DEXP = 7
+  CBF_CONE_DEXP = 7,
+  CBF_CONE_PPOW = 8,
+  CBF_CONE_DPOW = 9
 } CBFscalarconee;
 
 
+typedef enum CBFblock_enum {
+  CBF_BLOCK_BEGIN = 0,
+  CBF_BLOCK_END = 8,
+
+  CBF_BLOCK_OBJFCOORD = 0,
+  CBF_BLOCK_OBJACOORD = 1,
+  CBF_BLOCK_OBJBCOORD = 2,
+  CBF_BLOCK_FCOORD = 3,
+  CBF_BLOCK_ACOORD = 4,
+  CBF_BLOCK_BCOORD = 5,
+  CBF_BLOCK_HCOORD = 6,
+  CBF_BLOCK_DCOORD = 7
+} CBFblocke;
+
+
 typedef struct CBFdata_struct {
 
   //
@@ -64,11 +81,13 @@ typedef struct CBFdata_struct {
   long long int   mapstacknum;
   long long int  *mapstackdim;
   CBFscalarconee *mapstackdomain;
+  long long int  *mapstackparam;     // Index of cone parameters per stack (NULL if no stack has any)
 
   long long int   varnum;
   long long int   varstacknum;
   long long int  *varstackdim;
   CBFscalarconee *varstackdomain;
+  long long int  *varstackparam;     // Index of cone parameters per stack (NULL if no stack has any)
 
   long long int   intvarnum;
   long long int  *intvar;
@@ -79,6 +98,20 @@ typedef struct CBFdata_struct {
   int             psdvarnum;
   int            *psdvardim;
 
+  //
+  // Parameters of power cones, shared by all stacks referring to them.
+  // Cone k has parameters powalpha[powalphabeg[k]] to powalpha[powalphabeg[k+1]-1].
+  //
+  long long int   powconenum;
+  long long int   powalphanum;
+  long long int  *powalphabeg;
+  double         *powalpha;
+
+  long long int   dpowconenum;
+  long long int   dpowalphanum;
+  long long int  *dpowalphabeg;
+  double         *dpowalpha;
+
   //
   // Coefficients of the objective scalar map
   //
@@ -129,6 +162,13 @@ typedef struct CBFdata_struct {
   int           *dsubl;
   double        *dval;
 
+  //
+  // Names of variables and maps if known (e.g., as read from MPS), or NULL.
+  // Variable j is named CBFnametable_name(varname, j) (see cbf-helper.h).
+  //
+  struct CBFnametable_struct *varname;
+  struct CBFnametable_struct *mapname;
+
 } CBFdata;
 
 #endif
@@ -17,6 +17,7 @@
 // 3. This notice may not be removed or altered from any source distribution.
 
 #include "cbf-format.h"
+#include <stdio.h>
 #include <string.h>
 
 
@@ -37,11 +38,23 @@ const char * CBF_CONENAM_QUAD = "Q";
 const char * CBF_CONENAM_RQUAD = "QR";
 const char * CBF_CONENAM_PEXP = "EXP";
 const char * CBF_CONENAM_DEXP = "EXP*";
+const char * CBF_CONENAM_PPOW = "POW";
+const char * CBF_CONENAM_DPOW = "POW*";
 
 // Names of the objective senses
 const char * CBF_OBJSENSENAM_MIN = "MIN";
 const char * CBF_OBJSENSENAM_MAX = "MAX";
 
+// Names of the coordinate blocks
+const char * CBF_BLOCKNAM_OBJFCOORD = "OBJFCOORD";
+const char * CBF_BLOCKNAM_OBJACOORD = "OBJACOORD";
+const char * CBF_BLOCKNAM_OBJBCOORD = "OBJBCOORD";
+const char * CBF_BLOCKNAM_FCOORD = "FCOORD";
+const char * CBF_BLOCKNAM_ACOORD = "ACOORD";
+const char * CBF_BLOCKNAM_BCOORD = "BCOORD";
+const char * CBF_BLOCKNAM_HCOORD = "HCOORD";
+const char * CBF_BLOCKNAM_DCOORD = "DCOORD";
+
 // -------------------------------------
 // Function definitions
 // -------------------------------------
@@ -66,11 +79,19 @@ CBFresponsee CBF_conetostr(CBFscalarconee cone, const char **str)
     break;
   case CBF_CONE_RQUAD:
     *str = CBF_CONENAM_RQUAD;
+    break;
   case CBF_CONE_PEXP:
     *str = CBF_CONENAM_PEXP;
+    break;
   case CBF_CONE_DEXP:
     *str = CBF_CONENAM_DEXP;
     break;
+  case CBF_CONE_PPOW:
+    *str = CBF_CONENAM_PPOW;
+    break;
+  case CBF_CONE_DPOW:
+    *str = CBF_CONENAM_DPOW;
+    break;
   default:
     return CBF_RES_ERR;
   }
@@ -95,12 +116,42 @@ CBFresponsee CBF_strtocone(const char *str, CBFscalarconee *cone)
     *cone = CBF_CONE_PEXP;
   else if (strcmp(str, CBF_CONENAM_DEXP) == 0)
     *cone = CBF_CONE_DEXP;
+  else if (strcmp(str, CBF_CONENAM_PPOW) == 0)
+    *cone = CBF_CONE_PPOW;
+  else if (strcmp(str, CBF_CONENAM_DPOW) == 0)
+    *cone = CBF_CONE_DPOW;
   else
     return CBF_RES_ERR;
 
   return CBF_RES_OK;
 }
 
+CBFresponsee CBF_strtoparamcone(const char *str, CBFscalarconee *cone, long long int *param)
+{
+  int offset = 0;
+
+  // Parametric cones are written as @k:NAME, where k is the index of the parameters
+  *param = -1;
+  if (str[0] == '@') {
+    if (sscanf(str, "@%lli:%n", param, &offset) != 1 || offset == 0 || *param < 0)
+      return CBF_RES_ERR;
+  }
+
+  if (CBF_strtocone(str + offset, cone) != CBF_RES_OK)
+    return CBF_RES_ERR;
+
+  // Parameters must be given if, and only if, the cone is parametric
+  if (CBF_coneisparametric(*cone) != (*param >= 0))
+    return CBF_RES_ERR;
+
+  return CBF_RES_OK;
+}
+
+int CBF_coneisparametric(CBFscalarconee cone)
+{
+  return (cone == CBF_CONE_PPOW || cone == CBF_CONE_DPOW);
+}
+
 CBFresponsee CBF_objsensetostr(CBFobjsensee objsense, const char **str)
 {
   switch (objsense) {
@@ -127,3 +178,60 @@ CBFresponsee CBF_strtoobjsense(const char *str, CBFobjsensee *objsense)
 
   return CBF_RES_OK;
 }
+
+CBFresponsee CBF_blocktostr(CBFblocke block, const char **str)
+{
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:
+    *str = CBF_BLOCKNAM_OBJFCOORD;
+    break;
+  case CBF_BLOCK_OBJACOORD:
+    *str = CBF_BLOCKNAM_OBJACOORD;
+    break;
+  case CBF_BLOCK_OBJBCOORD:
+    *str = CBF_BLOCKNAM_OBJBCOORD;
+    break;
+  case CBF_BLOCK_FCOORD:
+    *str = CBF_BLOCKNAM_FCOORD;
+    break;
+  case CBF_BLOCK_ACOORD:
+    *str = CBF_BLOCKNAM_ACOORD;
+    break;
+  case CBF_BLOCK_BCOORD:
+    *str = CBF_BLOCKNAM_BCOORD;
+    break;
+  case CBF_BLOCK_HCOORD:
+    *str = CBF_BLOCKNAM_HCOORD;
+    break;
+  case CBF_BLOCK_DCOORD:
+    *str = CBF_BLOCKNAM_DCOORD;
+    break;
+  default:
+    return CBF_RES_ERR;
+  }
+  return CBF_RES_OK;
+}
+
+CBFresponsee CBF_strtoblock(const char *str, CBFblocke *block)
+{
+  if (strcmp(str, CBF_BLOCKNAM_OBJFCOORD) == 0)
+    *block = CBF_BLOCK_OBJFCOORD;
+  else if (strcmp(str, CBF_BLOCKNAM_OBJACOORD) == 0)
+    *block = CBF_BLOCK_OBJACOORD;
+  else if (strcmp(str, CBF_BLOCKNAM_OBJBCOORD) == 0)
+    *block = CBF_BLOCK_OBJBCOORD;
+  else if (strcmp(str, CBF_BLOCKNAM_FCOORD) == 0)
+    *block = CBF_BLOCK_FCOORD;
+  else if (strcmp(str, CBF_BLOCKNAM_ACOORD) == 0)
+    *block = CBF_BLOCK_ACOORD;
+  else if (strcmp(str, CBF_BLOCKNAM_BCOORD) == 0)
+    *block = CBF_BLOCK_BCOORD;
+  else if (strcmp(str, CBF_BLOCKNAM_HCOORD) == 0)
+    *block = CBF_BLOCK_HCOORD;
+  else if (strcmp(str, CBF_BLOCKNAM_DCOORD) == 0)
+    *block = CBF_BLOCK_DCOORD;
+  else
+    return CBF_RES_ERR;
+
+  return CBF_RES_OK;
+}
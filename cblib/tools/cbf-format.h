@@ -24,8 +24,12 @@
 
 CBFresponsee CBF_conetostr(CBFscalarconee cone, const char **str);
 CBFresponsee CBF_strtocone(const char *str, CBFscalarconee *cone);
+CBFresponsee CBF_strtoparamcone(const char *str, CBFscalarconee *cone, long long int *param);
+int CBF_coneisparametric(CBFscalarconee cone);
 CBFresponsee CBF_objsensetostr(CBFobjsensee cone, const char **str);
 CBFresponsee CBF_strtoobjsense(const char *str, CBFobjsensee *cone);
+CBFresponsee CBF_blocktostr(CBFblocke block, const char **str);
+CBFresponsee CBF_strtoblock(const char *str, CBFblocke *block);
 
 // Use CBF_NAME_FORMAT instead of %s when parsing lines,
 // to avoid buffer overflow.
@@ -44,9 +48,20 @@ extern const char * CBF_CONENAM_QUAD;
 extern const char * CBF_CONENAM_RQUAD;
 extern const char * CBF_CONENAM_PEXP;
 extern const char * CBF_CONENAM_DEXP;
+extern const char * CBF_CONENAM_PPOW;
+extern const char * CBF_CONENAM_DPOW;
 
 extern const char * CBF_OBJSENSENAM_MIN;
 extern const char * CBF_OBJSENSENAM_MAX;
 
+extern const char * CBF_BLOCKNAM_OBJFCOORD;
+extern const char * CBF_BLOCKNAM_OBJACOORD;
+extern const char * CBF_BLOCKNAM_OBJBCOORD;
+extern const char * CBF_BLOCKNAM_FCOORD;
+extern const char * CBF_BLOCKNAM_ACOORD;
+extern const char * CBF_BLOCKNAM_BCOORD;
+extern const char * CBF_BLOCKNAM_HCOORD;
+extern const char * CBF_BLOCKNAM_DCOORD;
+
 #endif
 
@@ -20,6 +20,8 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <stddef.h>
+#include <string.h>
+#include <algorithm>
 /*
 
  * ------------------------------------------------
@@ -145,6 +147,31 @@ CBFresponsee CBF_coordinatesort(long long int *i, double *v, long long int nnz,
   long long int *itmp = NULL;
   double *vtmp = NULL;
 
+  // Coordinates exceeding the memory budget are sorted externally
+  if (CBFextsort_required(nnz)) {
+    CBFextsort sorter;
+    long long int key[4];
+    int isend;
+
+    res = CBFextsort_init(&sorter, 1);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      key[0] = i[idx];
+      res = CBFextsort_add(&sorter, key, v[idx]);
+    }
+
+    if (res == CBF_RES_OK)
+      res = CBFextsort_merge(&sorter);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      res = CBFextsort_next(&sorter, key, &v[idx], &isend);
+      i[idx] = key[0];
+    }
+
+    CBFextsort_free(&sorter);
+    return res;
+  }
+
   if (nnz == 0) {
     return CBF_RES_OK;
   } else {
@@ -191,6 +218,33 @@ CBFresponsee CBF_coordinatesort(long long int *i, long long int *j, double *v, l
   long long int *jtmp = NULL;
   double *vtmp = NULL;
 
+  // Coordinates exceeding the memory budget are sorted externally
+  if (CBFextsort_required(nnz)) {
+    CBFextsort sorter;
+    long long int key[4];
+    int isend;
+
+    res = CBFextsort_init(&sorter, 2);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      key[0] = i[idx];
+      key[1] = j[idx];
+      res = CBFextsort_add(&sorter, key, v[idx]);
+    }
+
+    if (res == CBF_RES_OK)
+      res = CBFextsort_merge(&sorter);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      res = CBFextsort_next(&sorter, key, &v[idx], &isend);
+      i[idx] = key[0];
+      j[idx] = key[1];
+    }
+
+    CBFextsort_free(&sorter);
+    return res;
+  }
+
   if (nnz == 0) {
     return CBF_RES_OK;
   } else {
@@ -246,6 +300,35 @@ CBFresponsee CBF_coordinatesort(int *i, int *j, int *k, double *v, long long int
   int *ktmp = NULL;
   double *vtmp = NULL;
 
+  // Coordinates exceeding the memory budget are sorted externally
+  if (CBFextsort_required(nnz)) {
+    CBFextsort sorter;
+    long long int key[4];
+    int isend;
+
+    res = CBFextsort_init(&sorter, 3);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      key[0] = i[idx];
+      key[1] = j[idx];
+      key[2] = k[idx];
+      res = CBFextsort_add(&sorter, key, v[idx]);
+    }
+
+    if (res == CBF_RES_OK)
+      res = CBFextsort_merge(&sorter);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      res = CBFextsort_next(&sorter, key, &v[idx], &isend);
+      i[idx] = key[0];
+      j[idx] = key[1];
+      k[idx] = key[2];
+    }
+
+    CBFextsort_free(&sorter);
+    return res;
+  }
+
   if (nnz == 0) {
     return CBF_RES_OK;
   } else {
@@ -311,6 +394,37 @@ CBFresponsee CBF_coordinatesort(long long int *i, int *j, int *k, int *l, double
   int *ltmp = NULL;
   double *vtmp = NULL;
 
+  // Coordinates exceeding the memory budget are sorted externally
+  if (CBFextsort_required(nnz)) {
+    CBFextsort sorter;
+    long long int key[4];
+    int isend;
+
+    res = CBFextsort_init(&sorter, 4);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      key[0] = i[idx];
+      key[1] = j[idx];
+      key[2] = k[idx];
+      key[3] = l[idx];
+      res = CBFextsort_add(&sorter, key, v[idx]);
+    }
+
+    if (res == CBF_RES_OK)
+      res = CBFextsort_merge(&sorter);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      res = CBFextsort_next(&sorter, key, &v[idx], &isend);
+      i[idx] = key[0];
+      j[idx] = key[1];
+      k[idx] = key[2];
+      l[idx] = key[3];
+    }
+
+    CBFextsort_free(&sorter);
+    return res;
+  }
+
   if (nnz == 0) {
     return CBF_RES_OK;
   } else {
@@ -384,6 +498,37 @@ CBFresponsee CBF_coordinatesort(int *i, long long int *j, int *k, int *l, double
   int *ltmp = NULL;
   double *vtmp = NULL;
 
+  // Coordinates exceeding the memory budget are sorted externally
+  if (CBFextsort_required(nnz)) {
+    CBFextsort sorter;
+    long long int key[4];
+    int isend;
+
+    res = CBFextsort_init(&sorter, 4);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      key[0] = i[idx];
+      key[1] = j[idx];
+      key[2] = k[idx];
+      key[3] = l[idx];
+      res = CBFextsort_add(&sorter, key, v[idx]);
+    }
+
+    if (res == CBF_RES_OK)
+      res = CBFextsort_merge(&sorter);
+
+    for (idx = 0; idx < nnz && res == CBF_RES_OK; ++idx) {
+      res = CBFextsort_next(&sorter, key, &v[idx], &isend);
+      i[idx] = key[0];
+      j[idx] = key[1];
+      k[idx] = key[2];
+      l[idx] = key[3];
+    }
+
+    CBFextsort_free(&sorter);
+    return res;
+  }
+
   if (nnz == 0) {
     return CBF_RES_OK;
   } else {
@@ -488,6 +633,552 @@ CBFresponsee CBF_coordinatesort_rowmajor_psdmap(CBFdata *data) {
   return res;
 }
 
+CBFresponsee CBF_transpose(long long int nnz, const long long int *subi, long long int maxi, const long long int *subj, long long int maxj,
+    long long int *colbeg, long long int *idx) {
+  CBFresponsee res = CBF_RES_OK;
+  long long int k, q, *count = NULL, *rowbeg = NULL, *rowidx = NULL;
+
+  count = (colbeg ? colbeg : (long long int *) malloc((maxj + 2) * sizeof(count[0])));
+  if (!count)
+    return CBF_RES_ERR;
+
+  // Column counts, shifted by one so that their prefix sum gives column starts
+  for (k = 0; k <= maxj + 1; ++k)
+    count[k] = 0;
+
+  for (k = 0; k < nnz; ++k)
+    ++count[subj[k] + 1];
+
+  for (k = 0; k <= maxj; ++k)
+    count[k + 1] += count[k];
+
+  if (idx && subi && nnz >= 1) {
+    rowbeg = (long long int *) calloc(maxi + 2, sizeof(rowbeg[0]));
+    rowidx = (long long int *) malloc(nnz * sizeof(rowidx[0]));
+
+    if (rowbeg && rowidx) {
+      // First pass distributes coordinates into rows...
+      for (k = 0; k < nnz; ++k)
+        ++rowbeg[subi[k] + 1];
+
+      for (k = 0; k <= maxi; ++k)
+        rowbeg[k + 1] += rowbeg[k];
+
+      for (k = 0; k < nnz; ++k)
+        rowidx[rowbeg[subi[k]]++] = k;
+
+      // ...and the second, taking rows in order, into columns
+      for (k = 0; k < nnz; ++k) {
+        q = rowidx[k];
+        idx[count[subj[q]]++] = q;
+      }
+
+    } else {
+      res = CBF_RES_ERR;
+    }
+
+    free(rowbeg);
+    free(rowidx);
+
+  } else if (idx) {
+    for (k = 0; k < nnz; ++k)
+      idx[count[subj[k]]++] = k;
+  }
+
+  // Distribution has moved each column start to the next
+  if (idx && res == CBF_RES_OK) {
+    for (k = maxj + 1; k >= 1; --k)
+      count[k] = count[k - 1];
+    count[0] = 0;
+  }
+
+  if (!colbeg)
+    free(count);
+
+  return res;
+}
+
+/*
+ * ------------------------------------------------
+ * External sort
+ * ------------------------------------------------
+ */
+
+long long int CBF_SORT_MEMLIMIT = 0;
+
+// A sorted run in the temporary file, and its block of the buffer during merge
+typedef struct CBFsortrun_struct {
+  long long int next;       // Next record of the run still on disk
+  long long int end;        // One past the last record of the run
+  long long int blockpos;   // Next record of the block in the buffer
+  long long int blocknum;   // Number of records in the block
+} CBFsortrun;
+
+static int extsort_compare(int keynum, const CBFsortrecord *a, const CBFsortrecord *b) {
+  int k;
+
+  for (k = 0; k < keynum; ++k)
+    if (a->key[k] != b->key[k])
+      return (a->key[k] < b->key[k] ? -1 : 1);
+
+  return 0;
+}
+
+struct CBFsortrecord_less {
+  int keynum;
+  CBFsortrecord_less(int keynum) : keynum(keynum) {}
+  bool operator()(const CBFsortrecord &a, const CBFsortrecord &b) const { return extsort_compare(keynum, &a, &b) < 0; }
+};
+
+static CBFresponsee extsort_spill(CBFextsort *sorter) {
+  long long int *runbeg;
+
+  if (sorter->num == 0)
+    return CBF_RES_OK;
+
+  if (!sorter->pFile) {
+    sorter->pFile = tmpfile();
+    if (!sorter->pFile)
+      return CBF_RES_ERR;
+  }
+
+  runbeg = (long long int *) realloc(sorter->runbeg, (sorter->runnum + 2) * sizeof(runbeg[0]));
+  if (!runbeg)
+    return CBF_RES_ERR;
+
+  sorter->runbeg = runbeg;
+  if (sorter->runnum == 0)
+    runbeg[0] = 0;
+
+  std::stable_sort(sorter->buf, sorter->buf + sorter->num, CBFsortrecord_less(sorter->keynum));
+
+  if (fseek(sorter->pFile, 0, SEEK_END) != 0 || fwrite(sorter->buf, sizeof(sorter->buf[0]), sorter->num, sorter->pFile) != (size_t) sorter->num)
+    return CBF_RES_ERR;
+
+  runbeg[sorter->runnum + 1] = runbeg[sorter->runnum] + sorter->num;
+  ++sorter->runnum;
+  sorter->num = 0;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee extsort_load(CBFextsort *sorter, long long int r) {
+  CBFsortrun *run = &sorter->run[r];
+  long long int n;
+
+  n = run->end - run->next;
+  if (n > sorter->blocksize)
+    n = sorter->blocksize;
+
+  if (fseek(sorter->pFile, (long) (run->next * sizeof(sorter->buf[0])), SEEK_SET) != 0 ||
+      fread(sorter->buf + r * sorter->blocksize, sizeof(sorter->buf[0]), n, sorter->pFile) != (size_t) n)
+    return CBF_RES_ERR;
+
+  run->next += n;
+  run->blockpos = 0;
+  run->blocknum = n;
+
+  return CBF_RES_OK;
+}
+
+// Equal records are taken from the earliest run, so that the merge is stable
+static int extsort_heapless(const CBFextsort *sorter, long long int a, long long int b) {
+  int cmp = extsort_compare(sorter->keynum,
+      &sorter->buf[a * sorter->blocksize + sorter->run[a].blockpos],
+      &sorter->buf[b * sorter->blocksize + sorter->run[b].blockpos]);
+
+  return (cmp < 0 || (cmp == 0 && a < b));
+}
+
+static void extsort_siftdown(CBFextsort *sorter, long long int h) {
+  long long int c, tmp;
+
+  while ((c = 2 * h + 1) < sorter->heapnum) {
+    if (c + 1 < sorter->heapnum && extsort_heapless(sorter, sorter->heap[c + 1], sorter->heap[c]))
+      ++c;
+
+    if (!extsort_heapless(sorter, sorter->heap[c], sorter->heap[h]))
+      break;
+
+    tmp = sorter->heap[h];
+    sorter->heap[h] = sorter->heap[c];
+    sorter->heap[c] = tmp;
+    h = c;
+  }
+}
+
+int CBFextsort_required(long long int nnz) {
+  return (CBF_SORT_MEMLIMIT > 0 && nnz > CBF_SORT_MEMLIMIT / (long long int) sizeof(CBFsortrecord));
+}
+
+CBFresponsee CBFextsort_init(CBFextsort *sorter, int keynum) {
+  memset(sorter, 0, sizeof(*sorter));
+
+  if (keynum < 1 || keynum > 4)
+    return CBF_RES_ERR;
+
+  sorter->keynum = keynum;
+
+  if (CBF_SORT_MEMLIMIT > 0) {
+    sorter->cap = CBF_SORT_MEMLIMIT / sizeof(CBFsortrecord);
+    if (sorter->cap < 1)
+      sorter->cap = 1;
+  }
+
+  return CBF_RES_OK;
+}
+
+CBFresponsee CBFextsort_add(CBFextsort *sorter, const long long int *key, double val) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFsortrecord *buf;
+  long long int bufcap;
+
+  if (sorter->num == sorter->bufcap) {
+    if (sorter->cap >= 1 && sorter->num == sorter->cap) {
+      res = extsort_spill(sorter);
+
+    } else {
+      bufcap = (sorter->bufcap >= 1024 ? 2 * sorter->bufcap : 1024);
+      if (sorter->cap >= 1 && bufcap > sorter->cap)
+        bufcap = sorter->cap;
+
+      buf = (CBFsortrecord *) realloc(sorter->buf, bufcap * sizeof(buf[0]));
+      if (buf) {
+        sorter->buf = buf;
+        sorter->bufcap = bufcap;
+      } else {
+        res = CBF_RES_ERR;
+      }
+    }
+  }
+
+  if (res == CBF_RES_OK) {
+    buf = &sorter->buf[sorter->num++];
+    memcpy(buf->key, key, sorter->keynum * sizeof(key[0]));
+    buf->val = val;
+  }
+
+  return res;
+}
+
+CBFresponsee CBFextsort_merge(CBFextsort *sorter) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFsortrecord *buf;
+  long long int r;
+
+  if (!sorter->pFile) {
+    std::stable_sort(sorter->buf, sorter->buf + sorter->num, CBFsortrecord_less(sorter->keynum));
+    sorter->pos = 0;
+    return CBF_RES_OK;
+  }
+
+  res = extsort_spill(sorter);
+
+  // The buffer is divided into one block per run
+  if (res == CBF_RES_OK) {
+    sorter->blocksize = sorter->cap / sorter->runnum;
+    if (sorter->blocksize < 1)
+      sorter->blocksize = 1;
+
+    if (sorter->blocksize * sorter->runnum > sorter->bufcap) {
+      buf = (CBFsortrecord *) realloc(sorter->buf, sorter->blocksize * sorter->runnum * sizeof(buf[0]));
+      if (buf) {
+        sorter->buf = buf;
+        sorter->bufcap = sorter->blocksize * sorter->runnum;
+      } else {
+        res = CBF_RES_ERR;
+      }
+    }
+  }
+
+  if (res == CBF_RES_OK) {
+    sorter->run = (CBFsortrun *) calloc(sorter->runnum, sizeof(sorter->run[0]));
+    sorter->heap = (long long int *) calloc(sorter->runnum, sizeof(sorter->heap[0]));
+    if (!sorter->run || !sorter->heap)
+      res = CBF_RES_ERR;
+  }
+
+  for (r = 0; r < sorter->runnum && res == CBF_RES_OK; ++r) {
+    sorter->run[r].next = sorter->runbeg[r];
+    sorter->run[r].end = sorter->runbeg[r + 1];
+    sorter->heap[r] = r;
+    res = extsort_load(sorter, r);
+  }
+
+  if (res == CBF_RES_OK) {
+    sorter->heapnum = sorter->runnum;
+    for (r = sorter->heapnum / 2 - 1; r >= 0; --r)
+      extsort_siftdown(sorter, r);
+  }
+
+  return res;
+}
+
+CBFresponsee CBFextsort_next(CBFextsort *sorter, long long int *key, double *val, int *isend) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFsortrecord rec;
+  CBFsortrun *run;
+  long long int r;
+
+  if (!sorter->pFile) {
+    *isend = (sorter->pos == sorter->num);
+    if (!*isend)
+      rec = sorter->buf[sorter->pos++];
+
+  } else {
+    *isend = (sorter->heapnum == 0);
+    if (!*isend) {
+      r = sorter->heap[0];
+      run = &sorter->run[r];
+      rec = sorter->buf[r * sorter->blocksize + run->blockpos++];
+
+      // Refill the block of the run, or retire the run once exhausted
+      if (run->blockpos == run->blocknum) {
+        if (run->next < run->end)
+          res = extsort_load(sorter, r);
+        else
+          sorter->heap[0] = sorter->heap[--sorter->heapnum];
+      }
+
+      if (res == CBF_RES_OK)
+        extsort_siftdown(sorter, 0);
+    }
+  }
+
+  if (res == CBF_RES_OK && !*isend) {
+    memcpy(key, rec.key, sorter->keynum * sizeof(key[0]));
+    *val = rec.val;
+  }
+
+  return res;
+}
+
+void CBFextsort_free(CBFextsort *sorter) {
+  if (sorter->pFile)
+    fclose(sorter->pFile);
+
+  free(sorter->buf);
+  free(sorter->runbeg);
+  free(sorter->run);
+  free(sorter->heap);
+  memset(sorter, 0, sizeof(*sorter));
+}
+
+/*
+ * ------------------------------------------------
+ * Name tables
+ * ------------------------------------------------
+ */
+
+// FNV-1a hash of a name
+static unsigned long long int namehash(const char *name) {
+  unsigned long long int h = 0xCBF29CE484222325ULL;
+
+  for (; *name; ++name)
+    h = (h ^ (unsigned char) *name) * 0x100000001B3ULL;
+
+  return h;
+}
+
+// Returns the slot holding 'name', or the empty slot where it belongs
+static long long int nametable_slot(const CBFnametable *table, const char *name) {
+  long long int s;
+
+  s = (long long int) (namehash(name) & (table->cap - 1));
+  while (table->slot[s] != 0) {
+    if (strcmp(table->pool + table->beg[table->slot[s] - 1], name) == 0)
+      break;
+    s = (s + 1) & (table->cap - 1);
+  }
+
+  return s;
+}
+
+// Indexes all names in a hash table with room for at least 'num' more
+static CBFresponsee nametable_reindex(CBFnametable *table, long long int num) {
+  long long int *slot, cap, i;
+
+  for (cap = 1024; cap < 2 * (table->num + num); cap *= 2) {}
+
+  slot = (long long int *) calloc(cap, sizeof(slot[0]));
+  if (!slot)
+    return CBF_RES_ERR;
+
+  free(table->slot);
+  table->slot = slot;
+  table->cap = cap;
+
+  for (i = 0; i < table->num; ++i)
+    table->slot[nametable_slot(table, table->pool + table->beg[i])] = i + 1;
+
+  return CBF_RES_OK;
+}
+
+// Appends a name to the string pool
+static CBFresponsee nametable_store(CBFnametable *table, const char *name) {
+  long long int len, cap;
+  long long int *beg;
+  char *pool;
+
+  if (table->num + 1 > table->begcap) {
+    cap = (table->begcap == 0 ? 1024 : 2 * table->begcap);
+    beg = (long long int *) realloc(table->beg, cap * sizeof(beg[0]));
+    if (!beg)
+      return CBF_RES_ERR;
+    table->beg = beg;
+    table->begcap = cap;
+  }
+
+  len = (long long int) strlen(name) + 1;
+  if (table->poolsize + len > table->poolcap) {
+    for (cap = (table->poolcap == 0 ? 65536 : 2 * table->poolcap); cap < table->poolsize + len; cap *= 2) {}
+    pool = (char *) realloc(table->pool, cap);
+    if (!pool)
+      return CBF_RES_ERR;
+    table->pool = pool;
+    table->poolcap = cap;
+  }
+
+  memcpy(table->pool + table->poolsize, name, len);
+  table->beg[table->num++] = table->poolsize;
+  table->poolsize += len;
+
+  return CBF_RES_OK;
+}
+
+CBFresponsee CBFnametable_add(CBFnametable *table, const char *name, long long int *idx, int *isnew) {
+  long long int s;
+
+  // Keep the load factor below one half, doubling the number of names indexed for
+  if (2 * (table->num + 1) > table->cap)
+    if (nametable_reindex(table, table->num + 1) != CBF_RES_OK)
+      return CBF_RES_ERR;
+
+  s = nametable_slot(table, name);
+  if (table->slot[s] != 0) {
+    *idx = table->slot[s] - 1;
+    if (isnew)
+      *isnew = 0;
+    return CBF_RES_OK;
+  }
+
+  if (nametable_store(table, name) != CBF_RES_OK)
+    return CBF_RES_ERR;
+
+  table->slot[s] = table->num;
+  *idx = table->num - 1;
+  if (isnew)
+    *isnew = 1;
+
+  return CBF_RES_OK;
+}
+
+CBFresponsee CBFnametable_push(CBFnametable *table, const char *name) {
+  if (table->cap != 0) {
+    free(table->slot);
+    table->slot = NULL;
+    table->cap = 0;
+  }
+
+  return nametable_store(table, name);
+}
+
+static CBFresponsee nametable_generate(const char *prefix, long long int idx, long long int extra, char **buf, size_t *bufcap) {
+  size_t len = strlen(prefix) + 24 + extra;
+  char *tmp;
+
+  if (len > *bufcap) {
+    tmp = (char*) realloc(*buf, len);
+    if (!tmp)
+      return CBF_RES_ERR;
+
+    *buf = tmp;
+    *bufcap = len;
+  }
+
+  len = sprintf(*buf, "%s%lli", prefix, idx);
+  memset(*buf + len, '_', extra);
+  (*buf)[len + extra] = '\0';
+
+  return CBF_RES_OK;
+}
+
+CBFresponsee CBFnametable_pushnew(CBFnametable *table, const char *prefix, long long int first, long long int num) {
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, *extra = NULL;
+  size_t bufcap = 0;
+  char *buf = NULL;
+
+  if (num <= 0)
+    return CBF_RES_OK;
+
+  extra = (long long int*) calloc(num, sizeof(extra[0]));
+  if (!extra)
+    return CBF_RES_ERR;
+
+  // All names are made new before any is pushed, as pushing drops the index
+  for (i = 0; i < num && res == CBF_RES_OK; ++i) {
+    while ((res = nametable_generate(prefix, first + i, extra[i], &buf, &bufcap)) == CBF_RES_OK) {
+      if (CBFnametable_find(table, buf) < 0)
+        break;
+      ++extra[i];
+    }
+  }
+
+  for (i = 0; i < num && res == CBF_RES_OK; ++i) {
+    res = nametable_generate(prefix, first + i, extra[i], &buf, &bufcap);
+    if (res == CBF_RES_OK)
+      res = CBFnametable_push(table, buf);
+  }
+
+  free(buf);
+  free(extra);
+  return res;
+}
+
+CBFresponsee CBFnametable_compress(CBFnametable *table, long long int num, const char *del) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFnametable kept;
+  long long int i;
+
+  memset(&kept, 0, sizeof(kept));
+
+  for (i = 0; i < num && res == CBF_RES_OK; ++i)
+    if (del[i] != 1)
+      res = CBFnametable_push(&kept, CBFnametable_name(table, i));
+
+  if (res == CBF_RES_OK) {
+    CBFnametable_free(table);
+    *table = kept;
+  } else {
+    CBFnametable_free(&kept);
+  }
+
+  return res;
+}
+
+long long int CBFnametable_find(CBFnametable *table, const char *name) {
+  if (table->num == 0)
+    return -1;
+
+  if (table->cap == 0)
+    if (nametable_reindex(table, 0) != CBF_RES_OK)
+      return -1;
+
+  return table->slot[nametable_slot(table, name)] - 1;
+}
+
+const char * CBFnametable_name(const CBFnametable *table, long long int idx) {
+  return table->pool + table->beg[idx];
+}
+
+void CBFnametable_free(CBFnametable *table) {
+  free(table->slot);
+  free(table->beg);
+  free(table->pool);
+  memset(table, 0, sizeof(*table));
+}
+
 /*
  * ------------------------------------------------
  * Find nnz's of map and psdmap
@@ -633,6 +1324,8 @@ CBFresponsee CBF_compress_maps(CBFdata *data, const char *delmap) {
     if (mapstackdim) {
       data->mapstackdomain[mapstacknum] = data->mapstackdomain[k];
       data->mapstackdim[mapstacknum] = mapstackdim;
+      if (data->mapstackparam)
+        data->mapstackparam[mapstacknum] = data->mapstackparam[k];
       ++mapstacknum;
     }
 
@@ -648,6 +1341,90 @@ CBFresponsee CBF_compress_maps(CBFdata *data, const char *delmap) {
   return res;
 }
 
+CBFresponsee CBF_compress_vars(CBFdata *data, const char *delvar) {
+  CBFresponsee res = CBF_RES_OK;
+  long long int k, j, jbeg, varstackdim, *newidx = NULL;
+  long long int varnum = 0, varstacknum = 0, objannz = 0, annz = 0, hnnz = 0, intvarnum = 0;
+
+  newidx = (long long int*) malloc(data->varnum * sizeof(newidx[0]));
+  if (!newidx && data->varnum >= 1)
+    return CBF_RES_ERR;
+
+  // Renumber variables
+  jbeg = 0;
+  for (k = 0; k < data->varstacknum; ++k) {
+    varstackdim = 0;
+
+    for (j = jbeg; j < jbeg + data->varstackdim[k]; ++j) {
+      if (!delvar || delvar[j] != 1) {
+        newidx[j] = varnum++;
+        ++varstackdim;
+      } else {
+        newidx[j] = -1;
+      }
+    }
+
+    if (varstackdim) {
+      data->varstackdomain[varstacknum] = data->varstackdomain[k];
+      data->varstackdim[varstacknum] = varstackdim;
+      if (data->varstackparam)
+        data->varstackparam[varstacknum] = data->varstackparam[k];
+      ++varstacknum;
+    }
+
+    jbeg = j;
+  }
+
+  // OBJACOORD
+  for (k = 0; k < data->objannz; ++k) {
+    if (newidx[data->objasubj[k]] >= 0 && data->objaval[k] != 0.0) {
+      data->objasubj[objannz] = newidx[data->objasubj[k]];
+      data->objaval[objannz] = data->objaval[k];
+      ++objannz;
+    }
+  }
+
+  // ACOORD
+  for (k = 0; k < data->annz; ++k) {
+    if (newidx[data->asubj[k]] >= 0 && data->aval[k] != 0.0) {
+      data->asubi[annz] = data->asubi[k];
+      data->asubj[annz] = newidx[data->asubj[k]];
+      data->aval[annz] = data->aval[k];
+      ++annz;
+    }
+  }
+
+  // HCOORD
+  for (k = 0; k < data->hnnz; ++k) {
+    if (newidx[data->hsubj[k]] >= 0 && data->hval[k] != 0.0) {
+      data->hsubi[hnnz] = data->hsubi[k];
+      data->hsubj[hnnz] = newidx[data->hsubj[k]];
+      data->hsubk[hnnz] = data->hsubk[k];
+      data->hsubl[hnnz] = data->hsubl[k];
+      data->hval[hnnz] = data->hval[k];
+      ++hnnz;
+    }
+  }
+
+  // INT
+  for (k = 0; k < data->intvarnum; ++k) {
+    if (newidx[data->intvar[k]] >= 0) {
+      data->intvar[intvarnum] = newidx[data->intvar[k]];
+      ++intvarnum;
+    }
+  }
+
+  data->objannz = objannz;
+  data->annz = annz;
+  data->hnnz = hnnz;
+  data->intvarnum = intvarnum;
+  data->varnum = varnum;
+  data->varstacknum = varstacknum;
+
+  free(newidx);
+  return res;
+}
+
 CBFresponsee CBF_compress_psdmaps(CBFdata *data, const char *delpsdmap) {
   CBFresponsee res = CBF_RES_OK;
   long long int r, row, hbeg, dbeg;
@@ -660,6 +1437,7 @@ CBFresponsee CBF_compress_psdmaps(CBFdata *data, const char *delpsdmap) {
   r = row = hbeg = dbeg = 0;
   while (r < data->psdmapnum && res == CBF_RES_OK) {
     if (delpsdmap[r] != 1) {
+      data->psdmapdim[psdmapnum] = data->psdmapdim[r];
       ++psdmapnum;
 
       // HCOORD
@@ -701,6 +1479,162 @@ CBFresponsee CBF_compress_psdmaps(CBFdata *data, const char *delpsdmap) {
   return res;
 }
 
+void CBF_release_empty(CBFdata *data) {
+  if (data->mapstacknum == 0 && data->mapstackdim) {
+    free(data->mapstackdim);
+    free(data->mapstackdomain);
+    free(data->mapstackparam);
+    data->mapstackdim = NULL;
+    data->mapstackdomain = NULL;
+    data->mapstackparam = NULL;
+  }
+
+  if (data->varstacknum == 0 && data->varstackdim) {
+    free(data->varstackdim);
+    free(data->varstackdomain);
+    free(data->varstackparam);
+    data->varstackdim = NULL;
+    data->varstackdomain = NULL;
+    data->varstackparam = NULL;
+  }
+
+  if (data->intvarnum == 0 && data->intvar) {
+    free(data->intvar);
+    data->intvar = NULL;
+  }
+
+  if (data->psdmapnum == 0 && data->psdmapdim) {
+    free(data->psdmapdim);
+    data->psdmapdim = NULL;
+  }
+
+  if (data->psdvarnum == 0 && data->psdvardim) {
+    free(data->psdvardim);
+    data->psdvardim = NULL;
+  }
+
+  if (data->objfnnz == 0 && data->objfsubj) {
+    free(data->objfsubj);
+    free(data->objfsubk);
+    free(data->objfsubl);
+    free(data->objfval);
+    data->objfsubj = NULL;
+    data->objfsubk = NULL;
+    data->objfsubl = NULL;
+    data->objfval = NULL;
+  }
+
+  if (data->objannz == 0 && data->objasubj) {
+    free(data->objasubj);
+    free(data->objaval);
+    data->objasubj = NULL;
+    data->objaval = NULL;
+  }
+
+  if (data->fnnz == 0 && data->fsubi) {
+    free(data->fsubi);
+    free(data->fsubj);
+    free(data->fsubk);
+    free(data->fsubl);
+    free(data->fval);
+    data->fsubi = NULL;
+    data->fsubj = NULL;
+    data->fsubk = NULL;
+    data->fsubl = NULL;
+    data->fval = NULL;
+  }
+
+  if (data->annz == 0 && data->asubi) {
+    free(data->asubi);
+    free(data->asubj);
+    free(data->aval);
+    data->asubi = NULL;
+    data->asubj = NULL;
+    data->aval = NULL;
+  }
+
+  if (data->bnnz == 0 && data->bsubi) {
+    free(data->bsubi);
+    free(data->bval);
+    data->bsubi = NULL;
+    data->bval = NULL;
+  }
+
+  if (data->hnnz == 0 && data->hsubi) {
+    free(data->hsubi);
+    free(data->hsubj);
+    free(data->hsubk);
+    free(data->hsubl);
+    free(data->hval);
+    data->hsubi = NULL;
+    data->hsubj = NULL;
+    data->hsubk = NULL;
+    data->hsubl = NULL;
+    data->hval = NULL;
+  }
+
+  if (data->dnnz == 0 && data->dsubi) {
+    free(data->dsubi);
+    free(data->dsubk);
+    free(data->dsubl);
+    free(data->dval);
+    data->dsubi = NULL;
+    data->dsubk = NULL;
+    data->dsubl = NULL;
+    data->dval = NULL;
+  }
+}
+
+CBFresponsee CBF_compress_psdvars(CBFdata *data, const char *delpsdvar) {
+  long long int k, objfnnz = 0, fnnz = 0;
+  int j, psdvarnum = 0, *newidx;
+
+  newidx = (int*) malloc(data->psdvarnum * sizeof(newidx[0]));
+  if (!newidx && data->psdvarnum >= 1)
+    return CBF_RES_ERR;
+
+  // New index of each psdvar, or -1 if deleted
+  for (j = 0; j < data->psdvarnum; ++j) {
+    if (delpsdvar[j] != 1) {
+      newidx[j] = psdvarnum;
+      data->psdvardim[psdvarnum] = data->psdvardim[j];
+      ++psdvarnum;
+    } else {
+      newidx[j] = -1;
+    }
+  }
+
+  // OBJFCOORD
+  for (k = 0; k < data->objfnnz; ++k) {
+    if (newidx[data->objfsubj[k]] >= 0 && data->objfval[k] != 0.0) {
+      data->objfsubj[objfnnz] = newidx[data->objfsubj[k]];
+      data->objfsubk[objfnnz] = data->objfsubk[k];
+      data->objfsubl[objfnnz] = data->objfsubl[k];
+      data->objfval[objfnnz] = data->objfval[k];
+      ++objfnnz;
+    }
+  }
+
+  // FCOORD
+  for (k = 0; k < data->fnnz; ++k) {
+    if (newidx[data->fsubj[k]] >= 0 && data->fval[k] != 0.0) {
+      data->fsubi[fnnz] = data->fsubi[k];
+      data->fsubj[fnnz] = newidx[data->fsubj[k]];
+      data->fsubk[fnnz] = data->fsubk[k];
+      data->fsubl[fnnz] = data->fsubl[k];
+      data->fval[fnnz] = data->fval[k];
+      ++fnnz;
+    }
+  }
+
+  data->objfnnz = objfnnz;
+  data->fnnz = fnnz;
+  data->psdvarnum = psdvarnum;
+
+  free(newidx);
+  return CBF_RES_OK;
+}
+
 /*
  * ------------------------------------------------
  * Integer array
@@ -858,34 +1792,35 @@ CBFresponsee CBFdyn_append(CBFdyndata *dyndata, CBFdata *data) {
 }
 
 CBFresponsee CBFdyn_freedynamicallocations(CBFdyndata *dyndata) {
-  if (dyndata->mapstackdyncap >= 1) {
+  // Arrays are released whenever allocated, also if grown by others than dyndata
+  if (dyndata->data->mapstackdim) {
     free(dyndata->data->mapstackdim);
     free(dyndata->data->mapstackdomain);
     dyndata->data->mapstacknum = 0;
   }
 
-  if (dyndata->varstackdyncap >= 1) {
+  if (dyndata->data->varstackdim) {
     free(dyndata->data->varstackdim);
     free(dyndata->data->varstackdomain);
     dyndata->data->varstacknum = 0;
   }
 
-  if (dyndata->intvardyncap >= 1) {
+  if (dyndata->data->intvar) {
     free(dyndata->data->intvar);
     dyndata->data->intvarnum = 0;
   }
 
-  if (dyndata->psdmapdyncap >= 1) {
+  if (dyndata->data->psdmapdim) {
     free(dyndata->data->psdmapdim);
     dyndata->data->psdmapnum = 0;
   }
 
-  if (dyndata->psdvardyncap >= 1) {
+  if (dyndata->data->psdvardim) {
     free(dyndata->data->psdvardim);
     dyndata->data->psdvarnum = 0;
   }
 
-  if (dyndata->objfdyncap >= 1) {
+  if (dyndata->data->objfsubj) {
     free(dyndata->data->objfsubj);
     free(dyndata->data->objfsubk);
     free(dyndata->data->objfsubl);
@@ -893,7 +1828,7 @@ CBFresponsee CBFdyn_freedynamicallocations(CBFdyndata *dyndata) {
     dyndata->data->objfnnz = 0;
   }
 
-  if (dyndata->objadyncap >= 1) {
+  if (dyndata->data->objasubj) {
     free(dyndata->data->objasubj);
     free(dyndata->data->objaval);
     dyndata->data->objannz = 0;
@@ -901,7 +1836,7 @@ CBFresponsee CBFdyn_freedynamicallocations(CBFdyndata *dyndata) {
 
   dyndata->data->objbval = 0;
 
-  if (dyndata->fdyncap >= 1) {
+  if (dyndata->data->fsubi) {
     free(dyndata->data->fsubi);
     free(dyndata->data->fsubj);
     free(dyndata->data->fsubk);
@@ -910,20 +1845,20 @@ CBFresponsee CBFdyn_freedynamicallocations(CBFdyndata *dyndata) {
     dyndata->data->fnnz = 0;
   }
 
-  if (dyndata->adyncap >= 1) {
+  if (dyndata->data->asubi) {
     free(dyndata->data->asubi);
     free(dyndata->data->asubj);
     free(dyndata->data->aval);
     dyndata->data->annz = 0;
   }
 
-  if (dyndata->bdyncap >= 1) {
+  if (dyndata->data->bsubi) {
     free(dyndata->data->bsubi);
     free(dyndata->data->bval);
     dyndata->data->bnnz = 0;
   }
 
-  if (dyndata->hdyncap >= 1) {
+  if (dyndata->data->hsubi) {
     free(dyndata->data->hsubi);
     free(dyndata->data->hsubj);
     free(dyndata->data->hsubk);
@@ -932,7 +1867,7 @@ CBFresponsee CBFdyn_freedynamicallocations(CBFdyndata *dyndata) {
     dyndata->data->hnnz = 0;
   }
 
-  if (dyndata->ddyncap >= 1) {
+  if (dyndata->data->dsubi) {
     free(dyndata->data->dsubi);
     free(dyndata->data->dsubk);
     free(dyndata->data->dsubl);
@@ -945,7 +1880,7 @@ CBFresponsee CBFdyn_freedynamicallocations(CBFdyndata *dyndata) {
 
 CBFresponsee CBFdyn_map_capacitysurplus(CBFdyndata *dyndata, long long int surplus) {
   long long int size;
-  long long int *buf1;
+  long long int *buf1, *buf3;
   CBFscalarconee *buf2;
 
   if (dyndata->data->mapstacknum > dyndata->mapstackdyncap)
@@ -960,10 +1895,21 @@ CBFresponsee CBFdyn_map_capacitysurplus(CBFdyndata *dyndata, long long int surpl
     if (buf1 && buf2) {
       dyndata->data->mapstackdim = buf1;
       dyndata->data->mapstackdomain = buf2;
-      dyndata->mapstackdyncap = size;
     } else {
       return CBF_RES_ERR;
     }
+
+    // Cone parameters grow along, if any stack has some
+    if (dyndata->data->mapstackparam) {
+      buf3 = (long long int*) realloc(dyndata->data->mapstackparam, size * sizeof(dyndata->data->mapstackparam[0]));
+
+      if (buf3)
+        dyndata->data->mapstackparam = buf3;
+      else
+        return CBF_RES_ERR;
+    }
+
+    dyndata->mapstackdyncap = size;
   }
   return CBF_RES_OK;
 }
@@ -983,6 +1929,9 @@ CBFresponsee CBFdyn_map_adddomain(CBFdyndata *dyndata, CBFscalarconee domain, lo
     dyndata->data->mapstackdim[dyndata->data->mapstacknum - 1] = 0;
     dyndata->data->mapstackdomain[dyndata->data->mapstacknum - 1] = domain;
 
+    if (dyndata->data->mapstackparam)
+      dyndata->data->mapstackparam[dyndata->data->mapstacknum - 1] = -1;
+
   }
   // Increase dimension of current domain
   dyndata->data->mapstackdim[dyndata->data->mapstacknum - 1] += dim;
@@ -993,7 +1942,7 @@ CBFresponsee CBFdyn_map_adddomain(CBFdyndata *dyndata, CBFscalarconee domain, lo
 
 CBFresponsee CBFdyn_var_capacitysurplus(CBFdyndata *dyndata, long long int surplus) {
   long long int size;
-  long long int *buf1;
+  long long int *buf1, *buf3;
   CBFscalarconee *buf2;
 
   if (dyndata->data->varstacknum > dyndata->varstackdyncap)
@@ -1008,10 +1957,21 @@ CBFresponsee CBFdyn_var_capacitysurplus(CBFdyndata *dyndata, long long int surpl
     if (buf1 && buf2) {
       dyndata->data->varstackdim = buf1;
       dyndata->data->varstackdomain = buf2;
-      dyndata->varstackdyncap = size;
     } else {
       return CBF_RES_ERR;
     }
+
+    // Cone parameters grow along, if any stack has some
+    if (dyndata->data->varstackparam) {
+      buf3 = (long long int*) realloc(dyndata->data->varstackparam, size * sizeof(dyndata->data->varstackparam[0]));
+
+      if (buf3)
+        dyndata->data->varstackparam = buf3;
+      else
+        return CBF_RES_ERR;
+    }
+
+    dyndata->varstackdyncap = size;
   }
   return CBF_RES_OK;
 }
@@ -1031,6 +1991,9 @@ CBFresponsee CBFdyn_var_adddomain(CBFdyndata *dyndata, CBFscalarconee domain, lo
     dyndata->data->varstackdim[dyndata->data->varstacknum - 1] = 0;
     dyndata->data->varstackdomain[dyndata->data->varstacknum - 1] = domain;
 
+    if (dyndata->data->varstackparam)
+      dyndata->data->varstackparam[dyndata->data->varstacknum - 1] = -1;
+
   }
   // Increase dimension of current domain
   dyndata->data->varstackdim[dyndata->data->varstacknum - 1] += dim;
@@ -1484,3 +2447,247 @@ CBFresponsee CBFdyn_varbound_addfix(CBFdyndata *dyndata, long long int idx, doub
 
   return res;
 }
+
+
+/*
+ * ------------------------------------------------
+ * Problem sequences (CHANGE)
+ * ------------------------------------------------
+ */
+
+// Open addressing index from coordinates to their position in a block
+typedef struct CBFcoordindex_struct {
+  long long int cap;      // Number of slots (power of two), 0 if not built
+  long long int num;      // Number of indexed coordinates
+  long long int *slot;    // Position plus one, 0 if empty
+} CBFcoordindex;
+
+typedef struct CBFsequence_struct {
+  CBFdata data;
+  CBFdyndata dyndata;
+  CBFcoordindex index[CBF_BLOCK_END];
+  int isdelta;
+
+  CBFresponsee (*problem)(void *userdata, const CBFdata *data, long long int index);
+  void *userdata;
+} CBFsequence;
+
+static unsigned long long int coordmix(unsigned long long int h, long long int v) {
+  h = (h ^ (unsigned long long int) v) * 0x9E3779B97F4A7C15ULL;
+  return h ^ (h >> 29);
+}
+
+static unsigned long long int coordhash(const CBFdata *data, CBFblocke block, long long int k) {
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:  return coordmix(coordmix(coordmix(0, data->objfsubj[k]), data->objfsubk[k]), data->objfsubl[k]);
+  case CBF_BLOCK_OBJACOORD:  return coordmix(0, data->objasubj[k]);
+  case CBF_BLOCK_FCOORD:     return coordmix(coordmix(coordmix(coordmix(0, data->fsubi[k]), data->fsubj[k]), data->fsubk[k]), data->fsubl[k]);
+  case CBF_BLOCK_ACOORD:     return coordmix(coordmix(0, data->asubi[k]), data->asubj[k]);
+  case CBF_BLOCK_BCOORD:     return coordmix(0, data->bsubi[k]);
+  case CBF_BLOCK_HCOORD:     return coordmix(coordmix(coordmix(coordmix(0, data->hsubi[k]), data->hsubj[k]), data->hsubk[k]), data->hsubl[k]);
+  case CBF_BLOCK_DCOORD:     return coordmix(coordmix(coordmix(0, data->dsubi[k]), data->dsubk[k]), data->dsubl[k]);
+  default:                   return 0;
+  }
+}
+
+static int coordequal(const CBFdata *data, CBFblocke block, long long int a, long long int b) {
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:  return data->objfsubj[a] == data->objfsubj[b] && data->objfsubk[a] == data->objfsubk[b] && data->objfsubl[a] == data->objfsubl[b];
+  case CBF_BLOCK_OBJACOORD:  return data->objasubj[a] == data->objasubj[b];
+  case CBF_BLOCK_FCOORD:     return data->fsubi[a] == data->fsubi[b] && data->fsubj[a] == data->fsubj[b] && data->fsubk[a] == data->fsubk[b] && data->fsubl[a] == data->fsubl[b];
+  case CBF_BLOCK_ACOORD:     return data->asubi[a] == data->asubi[b] && data->asubj[a] == data->asubj[b];
+  case CBF_BLOCK_BCOORD:     return data->bsubi[a] == data->bsubi[b];
+  case CBF_BLOCK_HCOORD:     return data->hsubi[a] == data->hsubi[b] && data->hsubj[a] == data->hsubj[b] && data->hsubk[a] == data->hsubk[b] && data->hsubl[a] == data->hsubl[b];
+  case CBF_BLOCK_DCOORD:     return data->dsubi[a] == data->dsubi[b] && data->dsubk[a] == data->dsubk[b] && data->dsubl[a] == data->dsubl[b];
+  default:                   return 0;
+  }
+}
+
+// Returns the position of an earlier coordinate equal to 'k', or -1 after indexing 'k'
+static long long int coordindex_insert(CBFcoordindex *index, const CBFdata *data, CBFblocke block, long long int k) {
+  long long int s;
+
+  s = (long long int) (coordhash(data, block, k) & (index->cap - 1));
+  while (index->slot[s] != 0) {
+    if (coordequal(data, block, index->slot[s] - 1, k))
+      return index->slot[s] - 1;
+    s = (s + 1) & (index->cap - 1);
+  }
+
+  index->slot[s] = k + 1;
+  ++index->num;
+  return -1;
+}
+
+// Ensures room for one more coordinate, indexing the first 'nnz' from scratch if needed
+static CBFresponsee coordindex_reserve(CBFcoordindex *index, const CBFdata *data, CBFblocke block, long long int nnz) {
+  long long int cap, k;
+
+  if (2 * (index->num + 1) <= index->cap)
+    return CBF_RES_OK;
+
+  for (cap = 1024; cap < 4 * (nnz + 1); cap *= 2) {}
+
+  free(index->slot);
+  index->slot = (long long int *) calloc(cap, sizeof(index->slot[0]));
+  index->cap = (index->slot ? cap : 0);
+  index->num = 0;
+
+  if (!index->slot)
+    return CBF_RES_ERR;
+
+  // Duplicates within the base problem keep their first position
+  for (k = 0; k < nnz; ++k)
+    coordindex_insert(index, data, block, k);
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee sequence_structure(void *userdata, CBFdata *data) {
+  CBFsequence *seq = (CBFsequence *) userdata;
+
+  // Structure is borrowed from the frontend, coordinates are owned by the sequence
+  seq->data = *data;
+  seq->data.objfnnz = 0;  seq->data.objfsubj = NULL;  seq->data.objfsubk = NULL;  seq->data.objfsubl = NULL;  seq->data.objfval = NULL;
+  seq->data.objannz = 0;  seq->data.objasubj = NULL;  seq->data.objaval = NULL;
+  seq->data.objbval = 0;
+  seq->data.fnnz = 0;     seq->data.fsubi = NULL;  seq->data.fsubj = NULL;  seq->data.fsubk = NULL;  seq->data.fsubl = NULL;  seq->data.fval = NULL;
+  seq->data.annz = 0;     seq->data.asubi = NULL;  seq->data.asubj = NULL;  seq->data.aval = NULL;
+  seq->data.bnnz = 0;     seq->data.bsubi = NULL;  seq->data.bval = NULL;
+  seq->data.hnnz = 0;     seq->data.hsubi = NULL;  seq->data.hsubj = NULL;  seq->data.hsubk = NULL;  seq->data.hsubl = NULL;  seq->data.hval = NULL;
+  seq->data.dnnz = 0;     seq->data.dsubi = NULL;  seq->data.dsubk = NULL;  seq->data.dsubl = NULL;  seq->data.dval = NULL;
+
+  memset(&seq->dyndata, 0, sizeof(seq->dyndata));
+  seq->dyndata.data = &seq->data;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee sequence_blockbegin(void *userdata, CBFblocke block, long long int nnz) {
+  CBFsequence *seq = (CBFsequence *) userdata;
+  CBFdyndata *dyndata = &seq->dyndata;
+  CBFdata *data = &seq->data;
+
+  // Capacities grow geometrically, as a sequence may have many small changes
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:
+    return CBFdyn_objf_capacitysurplus(dyndata, (data->objfnnz + nnz > dyndata->objfdyncap && data->objfnnz > nnz) ? data->objfnnz : nnz);
+  case CBF_BLOCK_OBJACOORD:
+    return CBFdyn_obja_capacitysurplus(dyndata, (data->objannz + nnz > dyndata->objadyncap && data->objannz > nnz) ? data->objannz : nnz);
+  case CBF_BLOCK_OBJBCOORD:
+    return CBF_RES_OK;
+  case CBF_BLOCK_FCOORD:
+    return CBFdyn_f_capacitysurplus(dyndata, (data->fnnz + nnz > dyndata->fdyncap && data->fnnz > nnz) ? data->fnnz : nnz);
+  case CBF_BLOCK_ACOORD:
+    return CBFdyn_a_capacitysurplus(dyndata, (data->annz + nnz > dyndata->adyncap && data->annz > nnz) ? data->annz : nnz);
+  case CBF_BLOCK_BCOORD:
+    return CBFdyn_b_capacitysurplus(dyndata, (data->bnnz + nnz > dyndata->bdyncap && data->bnnz > nnz) ? data->bnnz : nnz);
+  case CBF_BLOCK_HCOORD:
+    return CBFdyn_h_capacitysurplus(dyndata, (data->hnnz + nnz > dyndata->hdyncap && data->hnnz > nnz) ? data->hnnz : nnz);
+  case CBF_BLOCK_DCOORD:
+    return CBFdyn_d_capacitysurplus(dyndata, (data->dnnz + nnz > dyndata->ddyncap && data->dnnz > nnz) ? data->dnnz : nnz);
+  default:
+    return CBF_RES_ERR;
+  }
+}
+
+static CBFresponsee sequence_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk) {
+  CBFsequence *seq = (CBFsequence *) userdata;
+  CBFdyndata *dyndata = &seq->dyndata;
+  CBFdata *data = &seq->data;
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, n, *nnz, last, prev;
+  double *val;
+
+  switch (block) {
+  case CBF_BLOCK_OBJBCOORD:
+    return CBFdyn_objb_set(dyndata, chunk->objbval);
+  case CBF_BLOCK_OBJFCOORD:  n = chunk->objfnnz;  nnz = &data->objfnnz;  break;
+  case CBF_BLOCK_OBJACOORD:  n = chunk->objannz;  nnz = &data->objannz;  break;
+  case CBF_BLOCK_FCOORD:     n = chunk->fnnz;     nnz = &data->fnnz;     break;
+  case CBF_BLOCK_ACOORD:     n = chunk->annz;     nnz = &data->annz;     break;
+  case CBF_BLOCK_BCOORD:     n = chunk->bnnz;     nnz = &data->bnnz;     break;
+  case CBF_BLOCK_HCOORD:     n = chunk->hnnz;     nnz = &data->hnnz;     break;
+  case CBF_BLOCK_DCOORD:     n = chunk->dnnz;     nnz = &data->dnnz;     break;
+  default:                   return CBF_RES_ERR;
+  }
+
+  for (i = 0; i < n && res == CBF_RES_OK; ++i) {
+    switch (block) {
+    case CBF_BLOCK_OBJFCOORD:  res = CBFdyn_objf_add(dyndata, chunk->objfsubj[i], chunk->objfsubk[i], chunk->objfsubl[i], chunk->objfval[i]);  val = data->objfval;  break;
+    case CBF_BLOCK_OBJACOORD:  res = CBFdyn_obja_add(dyndata, chunk->objasubj[i], chunk->objaval[i]);  val = data->objaval;  break;
+    case CBF_BLOCK_FCOORD:     res = CBFdyn_f_add(dyndata, chunk->fsubi[i], chunk->fsubj[i], chunk->fsubk[i], chunk->fsubl[i], chunk->fval[i]);  val = data->fval;  break;
+    case CBF_BLOCK_ACOORD:     res = CBFdyn_a_add(dyndata, chunk->asubi[i], chunk->asubj[i], chunk->aval[i]);  val = data->aval;  break;
+    case CBF_BLOCK_BCOORD:     res = CBFdyn_b_add(dyndata, chunk->bsubi[i], chunk->bval[i]);  val = data->bval;  break;
+    case CBF_BLOCK_HCOORD:     res = CBFdyn_h_add(dyndata, chunk->hsubi[i], chunk->hsubj[i], chunk->hsubk[i], chunk->hsubl[i], chunk->hval[i]);  val = data->hval;  break;
+    case CBF_BLOCK_DCOORD:     res = CBFdyn_d_add(dyndata, chunk->dsubi[i], chunk->dsubk[i], chunk->dsubl[i], chunk->dval[i]);  val = data->dval;  break;
+    default:                   res = CBF_RES_ERR;  val = NULL;  break;
+    }
+
+    // Coordinates of a change overwrite those of the previous problem
+    if (res == CBF_RES_OK && seq->isdelta) {
+      last = *nnz - 1;
+      res = coordindex_reserve(&seq->index[block], data, block, last);
+
+      if (res == CBF_RES_OK) {
+        prev = coordindex_insert(&seq->index[block], data, block, last);
+        if (prev >= 0) {
+          val[prev] = val[last];
+          --(*nnz);
+        }
+      }
+    }
+  }
+
+  return res;
+}
+
+static CBFresponsee sequence_blockend(void *userdata, CBFblocke block) {
+  return CBF_RES_OK;
+}
+
+static CBFresponsee sequence_problemend(void *userdata, long long int index) {
+  CBFsequence *seq = (CBFsequence *) userdata;
+
+  seq->isdelta = 1;
+  return seq->problem(seq->userdata, &seq->data, index);
+}
+
+CBFresponsee CBF_readsequence(const CBFfrontend *frontend, const char *file, CBFresponsee (*problem)(void *userdata, const CBFdata *data, long long int index), void *userdata) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFsequence seq;
+  CBFstream stream = { 0, };
+  int i;
+
+  if (!frontend->stream)
+    return CBF_RES_ERR;
+
+  memset(&seq, 0, sizeof(seq));
+  seq.dyndata.data = &seq.data;
+  seq.problem = problem;
+  seq.userdata = userdata;
+
+  stream.userdata   = &seq;
+  stream.structure  = sequence_structure;
+  stream.blockbegin = sequence_blockbegin;
+  stream.blockchunk = sequence_blockchunk;
+  stream.blockend   = sequence_blockend;
+  stream.problemend = sequence_problemend;
+
+  res = frontend->stream(file, &stream);
+
+  // The borrowed structure is left to the frontend
+  seq.data.mapstackdim = NULL;
+  seq.data.mapstackdomain = NULL;
+  seq.data.varstackdim = NULL;
+  seq.data.varstackdomain = NULL;
+  seq.data.intvar = NULL;
+  seq.data.psdmapdim = NULL;
+  seq.data.psdvardim = NULL;
+
+  CBFdyn_freedynamicallocations(&seq.dyndata);
+  for (i = 0; i < CBF_BLOCK_END; ++i)
+    free(seq.index[i].slot);
+
+  return res;
+}
@@ -21,6 +21,8 @@
 
 #include "programmingstyle.h"
 #include "cbf-data.h"
+#include "frontend.h"
+#include <stdio.h>      // Unfortunately, no portable forward declaration of FILE
 
 
 /*
@@ -55,6 +57,124 @@ CBFresponsee
 CBF_coordinatesort_rowmajor_psdmap(CBFdata *data);
 
 
+/*
+ * CBF_transpose is a counting sort of the coordinates (subi, subj) into
+ * column-major order, i.e., by 'subj' (primarily) followed by 'subi', in two
+ * linear passes. Column j is idx[colbeg[j]] to idx[colbeg[j+1]-1], and 'colbeg'
+ * must have room for maxj+2 elements. Either output may be NULL if not needed,
+ * and so may 'subi' in which case columns keep the order of appearance.
+ */
+CBFresponsee
+CBF_transpose(long long int nnz, const long long int *subi, long long int maxi, const long long int *subj, long long int maxj, long long int *colbeg, long long int *idx);
+
+
+/*
+ * CBFextsort is a stable sort of records lexicographically by their first
+ * 'keynum' keys, holding no more than CBF_SORT_MEMLIMIT bytes of records in
+ * memory (0 means no limit). Once the buffer is full, it is sorted and
+ * spilled to a temporary file as a run, and CBFextsort_merge prepares a k-way
+ * merge of the runs. Records are then read back in order by CBFextsort_next,
+ * which sets 'isend' when all have been read.
+ *
+ * CBF_coordinatesort falls back to it when CBFextsort_required(nnz) is true.
+ */
+extern long long int CBF_SORT_MEMLIMIT;
+
+typedef struct CBFsortrecord_struct {
+  long long int key[4];
+  double val;
+} CBFsortrecord;
+
+typedef struct CBFextsort_struct {
+
+  int keynum;
+  long long int cap;              // Records held in memory at most (0 if no limit)
+  long long int bufcap;
+  long long int num;
+  long long int pos;
+  CBFsortrecord *buf;
+
+  FILE *pFile;                    // Spilled runs (NULL if all records fit in memory)
+  long long int runnum;
+  long long int *runbeg;          // Run r holds records runbeg[r] to runbeg[r+1]-1
+  struct CBFsortrun_struct *run;
+  long long int *heap;
+  long long int heapnum;
+  long long int blocksize;
+
+} CBFextsort;
+
+int
+CBFextsort_required(long long int nnz);
+
+CBFresponsee
+CBFextsort_init(CBFextsort *sorter, int keynum);
+
+CBFresponsee
+CBFextsort_add(CBFextsort *sorter, const long long int *key, double val);
+
+CBFresponsee
+CBFextsort_merge(CBFextsort *sorter);
+
+CBFresponsee
+CBFextsort_next(CBFextsort *sorter, long long int *key, double *val, int *isend);
+
+void
+CBFextsort_free(CBFextsort *sorter);
+
+
+/*
+ * CBFnametable interns names in a string pool, and maps each of them to its
+ * index in order of insertion through an open addressing hash table.
+ * CBFnametable_add returns the index of a name, adding it if not already
+ * present, and sets 'isnew' accordingly. CBFnametable_find returns -1 if the
+ * name is unknown. A zero-initialized CBFnametable is empty.
+ *
+ * CBFnametable_push appends a name known to be new without indexing it, as
+ * for tables that are only written out. The hash table is then rebuilt by
+ * the next call to CBFnametable_add or CBFnametable_find.
+ *
+ * CBFnametable_pushnew appends names for 'num' indices added from 'first'
+ * on, as 'prefix' followed by the index and as many '_' as needed to be new.
+ * CBFnametable_compress keeps the names of the first 'num' indices that are
+ * not deleted, i.e., del[i] != 1, as done by CBF_compress_maps/vars.
+ */
+typedef struct CBFnametable_struct {
+
+  long long int num;
+  long long int cap;              // Number of slots (power of two), 0 if not indexed
+  long long int *slot;            // Name index plus one, 0 if empty
+
+  long long int *beg;             // Name i is the string at pool+beg[i]
+  long long int begcap;
+  char *pool;
+  long long int poolsize;
+  long long int poolcap;
+
+} CBFnametable;
+
+CBFresponsee
+CBFnametable_add(CBFnametable *table, const char *name, long long int *idx, int *isnew);
+
+CBFresponsee
+CBFnametable_push(CBFnametable *table, const char *name);
+
+CBFresponsee
+CBFnametable_pushnew(CBFnametable *table, const char *prefix, long long int first, long long int num);
+
+CBFresponsee
+CBFnametable_compress(CBFnametable *table, long long int num, const char *del);
+
+long long int
+CBFnametable_find(CBFnametable *table, const char *name);
+
+const char *
+CBFnametable_name(const CBFnametable *table, long long int idx);
+
+void
+CBFnametable_free(CBFnametable *table);
+
+
 /*
  * These methods can find the nnz's of a particular map or psdmap.
  * WARNING: Assumes coordinates are sorted row-major
@@ -89,9 +209,26 @@ CBFintegerarray_free(char **integertable);
 CBFresponsee
 CBF_compress_maps(CBFdata *data, const char *delmap);
 
+/*
+ * Helps you delete variables and get rid of empty nnz. Coordinates of deleted
+ * variables are dropped, so their contribution is for the caller to account for.
+ */
+CBFresponsee
+CBF_compress_vars(CBFdata *data, const char *delvar);
+
 CBFresponsee
 CBF_compress_psdmaps(CBFdata *data, const char *delpsdmap);
 
+CBFresponsee
+CBF_compress_psdvars(CBFdata *data, const char *delpsdvar);
+
+/*
+ * Frontends release arrays by their number of elements or by pointer, so arrays
+ * emptied by a transform are released and set to NULL here to not leak them.
+ */
+void
+CBF_release_empty(CBFdata *data);
+
 
 /*
  * The CBFdyndata structure, makes it easy to populate
@@ -226,4 +363,17 @@ CBFdyn_varbound_addupper(CBFdyndata *dyndata, long long int idx, double val);
 CBFresponsee
 CBFdyn_varbound_addfix(CBFdyndata *dyndata, long long int idx, double val);
 
+
+/*
+ * Reads a file with a sequence of problems separated by CHANGE, and calls
+ * 'problem' with each of them in turn. The streaming interface of 'frontend'
+ * is used, and the modifications following a CHANGE are applied in place
+ * with CBFdyndata: new coordinates are added and existing ones overwritten.
+ * The cost of a CHANGE is thereby proportional to its own size.
+ *
+ * The data passed to 'problem' is only valid for the duration of the call.
+ */
+CBFresponsee
+CBF_readsequence(const CBFfrontend *frontend, const char *file, CBFresponsee (*problem)(void *userdata, const CBFdata *data, long long int index), void *userdata);
+
 #endif
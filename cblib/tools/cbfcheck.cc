@@ -0,0 +1,711 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "frontend-cbf.h"
+#include "solution-cbf.h"
+#include "cbf-format.h"
+#include "cbf-helper.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+#include <thread>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Solution with the values of PSD variables split into one vector per matrix
+struct CBFsplitsolution {
+  std::string claim;
+  std::vector<double> primvar;
+  std::vector<std::vector<double> > primpsdvar;
+  std::vector<double> dualvar;
+  std::vector<std::vector<double> > dualpsdvar;
+};
+
+// Coordinates grouped by the output they contribute to
+struct CBFgroup {
+  long long int num;
+  std::vector<long long int> beg;
+  std::vector<long long int> perm;
+};
+
+// Error per domain in order of first appearance, as printed by summary.py
+typedef std::vector<std::pair<std::string, double> > CBFdomainerr;
+
+// Options and outcome shared by all problems of a CHANGE sequence
+struct CBFcheck {
+  const char *solfile;
+  int threads;
+  CBFresponsee res;
+};
+
+static CBFresponsee
+  checkproblem(void *userdata, const CBFdata *data, long long int index);
+
+static CBFresponsee
+  splitsol(const CBFdata &data, const CBFsolution &in, CBFsplitsolution *sol);
+
+template <typename T> static void
+  groupby(const T *out, long long int nnz, long long int num, CBFgroup *group);
+
+template <typename F> static void
+  parallel_foreach(const CBFgroup &group, int threads, F fn);
+
+static double
+  primdist(CBFscalarconee cone, const double *x, long long int n);
+
+static double
+  dualdist(CBFscalarconee cone, const double *x, long long int n);
+
+static double
+  expproj(const double *x, double *p);
+
+static double
+  psddist(const std::vector<double> &vech, int n);
+
+static void
+  adderr(CBFdomainerr *err, const std::string &domain, double dist);
+
+static void
+  printerr(const CBFdomainerr &err);
+
+static void
+  summary(const CBFdata &data, const CBFsplitsolution &sol, int threads);
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+int main (int argc, char *argv[])
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFcheck check = { NULL, 1, CBF_RES_OK };
+  const char *probfile = NULL;
+  const char *solfile = NULL;
+  int threads;
+  int i;
+
+  // Default options
+  threads = std::max(1u, std::thread::hardware_concurrency());
+
+  // User defined options
+  for (i=1; i<argc && res==CBF_RES_OK; ++i) {
+    if (strcmp(argv[i], "-threads") == 0) {
+      if (i + 1 < argc && sscanf(argv[i+1], "%i", &threads) == 1 && threads >= 1)
+        ++i;
+      else
+        res = CBF_RES_ERR;
+    }
+    else if (!probfile)
+      probfile = argv[i];
+    else if (!solfile)
+      solfile = argv[i];
+    else
+      res = CBF_RES_ERR;
+  }
+
+  if (res != CBF_RES_OK || !probfile || !solfile)
+  {
+    printf("\nBad command, syntax is:\n");
+    printf(">> cbfcheck [OPTIONS] probfile.cbf solfile.sol\n\n");
+    printf("OPTIONS:\n");
+    printf("  -threads n  : Number of threads in sparse matrix products.\n");
+    printf("\n\n");
+    return CBF_RES_ERR;
+  }
+
+  check.solfile = solfile;
+  check.threads = threads;
+
+  // Problems of a CHANGE sequence are checked against the solutions in turn
+  res = CBF_readsequence(&frontend_cbf, probfile, checkproblem, &check);
+
+  if (res != CBF_RES_OK)
+    printf("Failed to read file: %s\n", probfile);
+
+  return (res != CBF_RES_OK ? res : check.res);
+}
+
+static CBFresponsee checkproblem(void *userdata, const CBFdata *data, long long int index)
+{
+  CBFcheck *check = (CBFcheck*) userdata;
+  CBFsolution sol = { { 0, }, };
+  CBFsplitsolution split;
+
+  if (index >= 1)
+    printf("CHANGE\n");
+
+  if (CBF_readsol(check->solfile, index, &sol) != CBF_RES_OK) {
+    printf("Failed to read file: %s\n", check->solfile);
+    check->res = CBF_RES_ERR;
+
+  } else {
+    if (splitsol(*data, sol, &split) != CBF_RES_OK)
+      printf("Mismatch between problem and solution\n");
+    else
+      summary(*data, split, check->threads);
+  }
+
+  CBF_cleansol(&sol);
+  return CBF_RES_OK;
+}
+
+static CBFresponsee splitsol(const CBFdata &data, const CBFsolution &in, CBFsplitsolution *sol)
+{
+  long long int i, n;
+  int j;
+
+  sol->claim = in.claim;
+  sol->primvar.assign(in.primvar, in.primvar + in.primvarnum);
+  sol->dualvar.assign(in.dualvar, in.dualvar + in.dualvarnum);
+
+  // Split PSD values into one vector per matrix
+  if (in.primpsdvarnnz >= 1) {
+    for (n=0, j=0; j<data.psdvarnum; ++j)
+      n += (long long int) data.psdvardim[j] * (data.psdvardim[j]+1) / 2;
+
+    if (n != in.primpsdvarnnz)
+      return CBF_RES_ERR;
+
+    sol->primpsdvar.resize(data.psdvarnum);
+    for (i=0, j=0; j<data.psdvarnum; ++j) {
+      n = (long long int) data.psdvardim[j] * (data.psdvardim[j]+1) / 2;
+      sol->primpsdvar[j].assign(in.primpsdvar + i, in.primpsdvar + i + n);
+      i += n;
+    }
+  }
+
+  if (in.dualpsdvarnnz >= 1) {
+    for (n=0, j=0; j<data.psdmapnum; ++j)
+      n += (long long int) data.psdmapdim[j] * (data.psdmapdim[j]+1) / 2;
+
+    if (n != in.dualpsdvarnnz)
+      return CBF_RES_ERR;
+
+    sol->dualpsdvar.resize(data.psdmapnum);
+    for (i=0, j=0; j<data.psdmapnum; ++j) {
+      n = (long long int) data.psdmapdim[j] * (data.psdmapdim[j]+1) / 2;
+      sol->dualpsdvar[j].assign(in.dualpsdvar + i, in.dualpsdvar + i + n);
+      i += n;
+    }
+  }
+
+  return CBF_RES_OK;
+}
+
+template <typename T> static void groupby(const T *out, long long int nnz, long long int num, CBFgroup *group)
+{
+  long long int i;
+
+  // Counting sort of coordinates by output
+  group->num = num;
+  group->beg.assign(num + 1, 0);
+  group->perm.resize(nnz);
+
+  for (i=0; i<nnz; ++i)
+    ++group->beg[out[i] + 1];
+
+  for (i=0; i<num; ++i)
+    group->beg[i+1] += group->beg[i];
+
+  std::vector<long long int> next(group->beg.begin(), group->beg.end() - 1);
+  for (i=0; i<nnz; ++i)
+    group->perm[next[out[i]]++] = i;
+}
+
+template <typename F> static void parallel_foreach(const CBFgroup &group, int threads, F fn)
+{
+  std::vector<std::thread> pool;
+  long long int nnz = group.beg[group.num];
+  long long int from = 0, to;
+  int t;
+
+  // Outputs are split in ranges of about the same number of coordinates,
+  // so that no two threads ever write to the same output
+  for (t=1; t<=threads && from<group.num; ++t) {
+    to = std::upper_bound(group.beg.begin() + from, group.beg.end() - 1, nnz * t / threads) - group.beg.begin();
+    to = std::max(to, from + 1);
+    if (t == threads)
+      to = group.num;
+
+    pool.push_back(std::thread([&group, fn, from, to]() {
+      for (long long int o=from; o<to; ++o)
+        for (long long int e=group.beg[o]; e<group.beg[o+1]; ++e)
+          fn(o, group.perm[e]);
+    }));
+
+    from = to;
+  }
+
+  for (t=0; t<(int)pool.size(); ++t)
+    pool[t].join();
+}
+
+static double primdist(CBFscalarconee cone, const double *x, long long int n)
+{
+  double d = 0.0, ss1, ss2;
+  double Tx[3], p[3];
+  long long int i;
+
+  switch (cone) {
+  case CBF_CONE_FREE:
+    return 0.0;
+
+  case CBF_CONE_ZERO:
+    for (i=0; i<n; ++i)
+      d = std::max(d, fabs(x[i]));
+    return d;
+
+  case CBF_CONE_POS:
+    for (i=0; i<n; ++i)
+      d = std::max(d, -x[i]);
+    return d;
+
+  case CBF_CONE_NEG:
+    for (i=0; i<n; ++i)
+      d = std::max(d, x[i]);
+    return d;
+
+  case CBF_CONE_QUAD:
+    if (n == 0)
+      return 0.0;
+
+    ss1 = x[0]*x[0];
+    for (ss2=0.0, i=1; i<n; ++i)
+      ss2 += x[i]*x[i];
+
+    if (ss1 >= ss2)
+      return 0.0;
+    else if (-ss1 >= ss2)
+      return sqrt(ss1 + ss2);
+    else
+      return (sqrt(ss2) - x[0]) / sqrt(2.0);
+
+  case CBF_CONE_RQUAD:
+    if (n < 2)
+      return 0.0;
+
+    // Rotation into the quadratic cone
+    ss1 = (x[0] + x[1]) * (x[0] + x[1]) / 2.0;
+    for (ss2=(x[0] - x[1]) * (x[0] - x[1]) / 2.0, i=2; i<n; ++i)
+      ss2 += x[i]*x[i];
+
+    if (ss1 >= ss2)
+      return 0.0;
+    else if (-ss1 >= ss2)
+      return sqrt(ss1 + ss2);
+    else
+      return (sqrt(ss2) - (x[0] + x[1]) / sqrt(2.0)) / sqrt(2.0);
+
+  case CBF_CONE_PEXP:
+    return expproj(x, p);
+
+  case CBF_CONE_DEXP:
+    // Moreau: the distance to the dual cone is the norm of the projection onto the primal cone at -x
+    for (i=0; i<3; ++i)
+      Tx[i] = -x[i];
+    expproj(Tx, p);
+    return sqrt(p[0]*p[0] + p[1]*p[1] + p[2]*p[2]);
+
+  default:
+    return HUGE_VAL;
+  }
+}
+
+static double dualdist(CBFscalarconee cone, const double *x, long long int n)
+{
+  switch (cone) {
+  case CBF_CONE_FREE:   return primdist(CBF_CONE_ZERO, x, n);
+  case CBF_CONE_ZERO:   return primdist(CBF_CONE_FREE, x, n);
+  case CBF_CONE_PEXP:   return primdist(CBF_CONE_DEXP, x, n);
+  case CBF_CONE_DEXP:   return primdist(CBF_CONE_PEXP, x, n);
+  default:              return primdist(cone, x, n);
+  }
+}
+
+static double expproj(const double *x, double *p)
+{
+  double r = x[0], s = x[1], t = x[2];
+  double lo = -500.0, hi = 500.0, hlo, hhi, rho, e, step, best, cand;
+  int i;
+
+  // At ratio rho, the last two entries of x decompose uniquely as a*(1, rho) + b*(1-rho, 1) with
+  // a = ((rho-1)*t + s) / q and b = (t - rho*s) / q where q = rho*(rho-1) + 1. The projection is
+  // a*(exp(rho), 1, rho) at the root of the residual in the first entry, b*(-exp(-rho)) being the
+  // first entry of the polar part (Friberg, 2021).
+  struct hfun {
+    static double eval(double r, double s, double t, double rho) {
+      return ((rho-1)*t + s) * exp(rho) - (t - rho*s) * exp(-rho) - (rho*(rho-1) + 1) * r;
+    }
+  };
+
+  // Inside the cone
+  if ((s > 0 && r > 0 && log(r) - log(s) >= t / s) || (s == 0 && r >= 0 && t <= 0)) {
+    p[0] = r;  p[1] = s;  p[2] = t;
+    return 0.0;
+  }
+
+  // Inside the polar cone
+  if ((t > 0 && r < 0 && log(-r) - log(t) >= s / t - 1) || (t == 0 && r <= 0 && s <= 0)) {
+    p[0] = 0.0;  p[1] = 0.0;  p[2] = 0.0;
+    return sqrt(r*r + s*s + t*t);
+  }
+
+  // Candidate on the face s = 0, which is the projection if s <= 0 and t <= 0 as the residual
+  // (min(r,0), s, 0) is then in the polar cone
+  p[0] = std::max(r, 0.0);  p[1] = 0.0;  p[2] = std::min(t, 0.0);
+  best = (r-p[0])*(r-p[0]) + s*s + (t-p[2])*(t-p[2]);
+
+  if (s <= 0 && t <= 0)
+    return sqrt(best);
+
+  // Otherwise a > 0 and b > 0 at the projection, which brackets its ratio as the unique root
+  if (s > 0)
+    hi = std::min(hi, t / s);
+  else if (s < 0)
+    lo = std::max(lo, t / s);
+
+  if (t > 0)
+    lo = std::max(lo, 1 - s / t);
+  else if (t < 0)
+    hi = std::min(hi, 1 - s / t);
+
+  hlo = hfun::eval(r, s, t, lo);
+  hhi = hfun::eval(r, s, t, hi);
+
+  // The face candidate remains if the root is out of numerical range
+  if (lo < hi && (hlo < 0) != (hhi < 0)) {
+    for (i=0; i<200; ++i) {
+      rho = 0.5*(lo + hi);
+      if ((hfun::eval(r, s, t, rho) < 0) == (hlo < 0))
+        lo = rho;
+      else
+        hi = rho;
+    }
+
+    rho = 0.5*(lo + hi);
+    e = exp(rho);
+    step = ((rho-1)*t + s) / (rho*(rho-1) + 1);
+    cand = (r-step*e)*(r-step*e) + (s-step)*(s-step) + (t-step*rho)*(t-step*rho);
+    if (cand < best) {
+      p[0] = step*e;  p[1] = step;  p[2] = step*rho;
+      best = cand;
+    }
+  }
+
+  return sqrt(best);
+}
+
+static double psddist(const std::vector<double> &vech, int n)
+{
+  std::vector<double> A(n*n);
+  double off, theta, tt, c, sn, akp, akq, d = 0.0;
+  int k, l, m, p, q, sweep;
+
+  for (k=0; k<n; ++k)
+    for (l=0; l<=k; ++l)
+      A[k*n+l] = A[l*n+k] = vech[k*(k+1)/2 + l];
+
+  // Cyclic Jacobi eigenvalue iterations
+  for (sweep=0; sweep<100; ++sweep) {
+    for (off=0.0, k=0; k<n; ++k)
+      for (l=0; l<k; ++l)
+        off += A[k*n+l]*A[k*n+l];
+
+    if (off <= 1e-30)
+      break;
+
+    for (p=0; p<n; ++p) {
+      for (q=p+1; q<n; ++q) {
+        if (A[p*n+q] == 0.0)
+          continue;
+
+        theta = (A[q*n+q] - A[p*n+p]) / (2*A[p*n+q]);
+        tt = (theta >= 0 ? 1.0 : -1.0) / (fabs(theta) + sqrt(theta*theta + 1));
+        c = 1 / sqrt(tt*tt + 1);
+        sn = tt*c;
+
+        for (m=0; m<n; ++m) {
+          akp = A[m*n+p];
+          akq = A[m*n+q];
+          A[m*n+p] = c*akp - sn*akq;
+          A[m*n+q] = sn*akp + c*akq;
+        }
+        for (m=0; m<n; ++m) {
+          akp = A[p*n+m];
+          akq = A[q*n+m];
+          A[p*n+m] = c*akp - sn*akq;
+          A[q*n+m] = sn*akp + c*akq;
+        }
+      }
+    }
+  }
+
+  // Violation by the most negative eigenvalue
+  for (k=0; k<n; ++k)
+    d = std::max(d, -A[k*n+k]);
+
+  return d;
+}
+
+static void adderr(CBFdomainerr *err, const std::string &domain, double dist)
+{
+  size_t i;
+
+  for (i=0; i<err->size(); ++i) {
+    if ((*err)[i].first == domain) {
+      (*err)[i].second = std::max((*err)[i].second, dist);
+      return;
+    }
+  }
+
+  err->push_back(std::make_pair(domain, dist));
+}
+
+static void printerr(const CBFdomainerr &err)
+{
+  size_t i;
+
+  printf("  {");
+  for (i=0; i<err.size(); ++i)
+    printf("%s'%s': %.16g", (i == 0 ? "" : ", "), err[i].first.c_str(), err[i].second);
+  printf("}\n");
+}
+
+static void summary(const CBFdata &data, const CBFsplitsolution &sol, int threads)
+{
+  CBFgroup group;
+  CBFdomainerr psol_err, pray_err, dsol_err, dray_err;
+  std::vector<double> map_activity, var_activity;
+  std::vector<std::vector<double> > psd_activity;
+  double pobj = 0.0, dobj = 0.0, vardomainfactor, mapdomainfactor, dist;
+  const char *conenam;
+  std::string domain;
+  long long int i, j, k;
+  bool priminfo, dualinfo, isminimize;
+
+  priminfo = (sol.primvar.size() + sol.primpsdvar.size() != 0);
+  dualinfo = (sol.dualvar.size() + sol.dualpsdvar.size() != 0);
+  isminimize = (data.objsense == CBF_OBJ_MINIMIZE);
+
+  // Validate information
+  if ((priminfo && ((long long int) sol.primvar.size() != data.varnum || (long long int) sol.primpsdvar.size() != data.psdvarnum)) ||
+      (dualinfo && ((long long int) sol.dualvar.size() != data.mapnum || (long long int) sol.dualpsdvar.size() != data.psdmapnum))) {
+    printf("Mismatch between problem and solution\n");
+    return;
+  }
+
+  if (priminfo)
+  {
+    const double *x = sol.primvar.empty() ? NULL : &sol.primvar[0];
+    const std::vector<std::vector<double> > &X = sol.primpsdvar;
+
+    // Objective and variable activities are where solutions and rays agree
+    pobj = data.objbval;
+    for (k=0; k<data.objannz; ++k)
+      pobj += data.objaval[k] * x[data.objasubj[k]];
+
+    for (k=0; k<data.objfnnz; ++k)
+      pobj += data.objfval[k] * X[data.objfsubj[k]][data.objfsubk[k]*(data.objfsubk[k]+1)/2 + data.objfsubl[k]] * (data.objfsubk[k] == data.objfsubl[k] ? 1 : 2);
+
+    for (i=0, j=0; j<data.varstacknum; ++j) {
+      CBF_conetostr(data.varstackdomain[j], &conenam);
+      adderr(&psol_err, conenam, primdist(data.varstackdomain[j], x + i, data.varstackdim[j]));
+      i += data.varstackdim[j];
+    }
+
+    for (j=0; j<data.psdvarnum; ++j)
+      adderr(&psol_err, "PSD", psddist(X[j], data.psdvardim[j]));
+
+    // Map activities and integer requirements are where solutions and rays differ
+    pray_err = psol_err;
+
+    map_activity.assign(data.mapnum, 0.0);
+    groupby(data.asubi, data.annz, data.mapnum, &group);
+    parallel_foreach(group, threads, [&](long long int o, long long int e) {
+      map_activity[o] += data.aval[e] * x[data.asubj[e]];
+    });
+
+    groupby(data.fsubi, data.fnnz, data.mapnum, &group);
+    parallel_foreach(group, threads, [&](long long int o, long long int e) {
+      map_activity[o] += data.fval[e] * X[data.fsubj[e]][data.fsubk[e]*(data.fsubk[e]+1)/2 + data.fsubl[e]] * (data.fsubk[e] == data.fsubl[e] ? 1 : 2);
+    });
+
+    psd_activity.resize(data.psdmapnum);
+    for (j=0; j<data.psdmapnum; ++j)
+      psd_activity[j].assign((long long int) data.psdmapdim[j] * (data.psdmapdim[j]+1) / 2, 0.0);
+
+    groupby(data.hsubi, data.hnnz, data.psdmapnum, &group);
+    parallel_foreach(group, threads, [&](long long int o, long long int e) {
+      psd_activity[o][data.hsubk[e]*(data.hsubk[e]+1)/2 + data.hsubl[e]] += data.hval[e] * x[data.hsubj[e]];
+    });
+
+    for (i=0, j=0; j<data.mapstacknum; ++j) {
+      CBF_conetostr(data.mapstackdomain[j], &conenam);
+      adderr(&pray_err, conenam, primdist(data.mapstackdomain[j], &map_activity[0] + i, data.mapstackdim[j]));
+      i += data.mapstackdim[j];
+    }
+
+    for (j=0; j<data.psdmapnum; ++j)
+      adderr(&pray_err, "PSD", psddist(psd_activity[j], data.psdmapdim[j]));
+
+    for (k=0; k<data.bnnz; ++k)
+      map_activity[data.bsubi[k]] += data.bval[k];
+
+    for (k=0; k<data.dnnz; ++k)
+      psd_activity[data.dsubi[k]][data.dsubk[k]*(data.dsubk[k]+1)/2 + data.dsubl[k]] += data.dval[k];
+
+    for (i=0, j=0; j<data.mapstacknum; ++j) {
+      CBF_conetostr(data.mapstackdomain[j], &conenam);
+      adderr(&psol_err, conenam, primdist(data.mapstackdomain[j], &map_activity[0] + i, data.mapstackdim[j]));
+      i += data.mapstackdim[j];
+    }
+
+    for (j=0; j<data.psdmapnum; ++j)
+      adderr(&psol_err, "PSD", psddist(psd_activity[j], data.psdmapdim[j]));
+
+    if (data.intvarnum >= 1) {
+      for (dist=0.0, k=0; k<data.intvarnum; ++k)
+        dist = std::max(dist, fabs(x[data.intvar[k]] - floor(x[data.intvar[k]] + 0.5)));
+      adderr(&psol_err, "INTEGER", dist);
+    }
+  }
+
+  if (dualinfo)
+  {
+    const double *y = sol.dualvar.empty() ? NULL : &sol.dualvar[0];
+    const std::vector<std::vector<double> > &Y = sol.dualpsdvar;
+    std::vector<double> v;
+
+    vardomainfactor = (isminimize ? 1.0 : -1.0);
+    mapdomainfactor = (isminimize ? -1.0 : 1.0);
+
+    // Objective and variable activities are where solutions and rays agree
+    dobj = data.objbval;
+    for (k=0; k<data.bnnz; ++k)
+      dobj -= data.bval[k] * y[data.bsubi[k]];
+
+    for (k=0; k<data.dnnz; ++k)
+      dobj -= data.dval[k] * Y[data.dsubi[k]][data.dsubk[k]*(data.dsubk[k]+1)/2 + data.dsubl[k]] * (data.dsubk[k] == data.dsubl[k] ? 1 : 2);
+
+    for (i=0, j=0; j<data.mapstacknum; ++j) {
+      CBF_conetostr(data.mapstackdomain[j], &conenam);
+      v.assign(y + i, y + i + data.mapstackdim[j]);
+      for (k=0; k<(long long int)v.size(); ++k)
+        v[k] *= vardomainfactor;
+      adderr(&dsol_err, std::string(conenam) + "*", dualdist(data.mapstackdomain[j], v.empty() ? NULL : &v[0], v.size()));
+      i += data.mapstackdim[j];
+    }
+
+    for (j=0; j<data.psdmapnum; ++j) {
+      v = Y[j];
+      for (k=0; k<(long long int)v.size(); ++k)
+        v[k] *= vardomainfactor;
+      adderr(&dsol_err, "PSD*", psddist(v, data.psdmapdim[j]));
+    }
+
+    // Map activities are where solutions and rays differ
+    dray_err = dsol_err;
+
+    var_activity.assign(data.varnum, 0.0);
+    groupby(data.asubj, data.annz, data.varnum, &group);
+    parallel_foreach(group, threads, [&](long long int o, long long int e) {
+      var_activity[o] += data.aval[e] * y[data.asubi[e]];
+    });
+
+    groupby(data.hsubj, data.hnnz, data.varnum, &group);
+    parallel_foreach(group, threads, [&](long long int o, long long int e) {
+      var_activity[o] += data.hval[e] * Y[data.hsubi[e]][data.hsubk[e]*(data.hsubk[e]+1)/2 + data.hsubl[e]] * (data.hsubk[e] == data.hsubl[e] ? 1 : 2);
+    });
+
+    psd_activity.resize(data.psdvarnum);
+    for (j=0; j<data.psdvarnum; ++j)
+      psd_activity[j].assign((long long int) data.psdvardim[j] * (data.psdvardim[j]+1) / 2, 0.0);
+
+    groupby(data.fsubj, data.fnnz, data.psdvarnum, &group);
+    parallel_foreach(group, threads, [&](long long int o, long long int e) {
+      psd_activity[o][data.fsubk[e]*(data.fsubk[e]+1)/2 + data.fsubl[e]] += data.fval[e] * y[data.fsubi[e]];
+    });
+
+    for (int pass=0; pass<2; ++pass)
+    {
+      CBFdomainerr *err = (pass == 0 ? &dray_err : &dsol_err);
+
+      // The objective enters the solution but not the ray
+      if (pass == 1) {
+        for (k=0; k<data.objannz; ++k)
+          var_activity[data.objasubj[k]] -= data.objaval[k];
+
+        for (k=0; k<data.objfnnz; ++k)
+          psd_activity[data.objfsubj[k]][data.objfsubk[k]*(data.objfsubk[k]+1)/2 + data.objfsubl[k]] -= data.objfval[k];
+      }
+
+      for (i=0, j=0; j<data.varstacknum; ++j) {
+        CBF_conetostr(data.varstackdomain[j], &conenam);
+        v.assign(var_activity.begin() + i, var_activity.begin() + i + data.varstackdim[j]);
+        for (k=0; k<(long long int)v.size(); ++k)
+          v[k] *= mapdomainfactor;
+        adderr(err, std::string(conenam) + "*", dualdist(data.varstackdomain[j], v.empty() ? NULL : &v[0], v.size()));
+        i += data.varstackdim[j];
+      }
+
+      for (j=0; j<data.psdvarnum; ++j) {
+        v = psd_activity[j];
+        for (k=0; k<(long long int)v.size(); ++k)
+          v[k] *= mapdomainfactor;
+        adderr(err, "PSD*", psddist(v, data.psdvardim[j]));
+      }
+    }
+  }
+
+  // Report summary
+  domain = (data.intvarnum >= 1 ? " (for continuous relaxation)" : "");
+
+  if (!sol.claim.empty()) {
+    printf("CLAIM\n");
+    printf("  %s\n", sol.claim.c_str());
+  }
+
+  if (priminfo) {
+    printf("PRIMAL SOLUTION\n");
+    printf("  %.16g\n", pobj);
+    printerr(psol_err);
+  }
+
+  if (dualinfo && ((isminimize && dobj > 0) || (!isminimize && dobj < 0))) {
+    printf("PRIMAL INFEASIBILITY CERTIFICATE%s\n", domain.c_str());
+    printf("  %.16g\n", dobj);
+    printerr(dray_err);
+  }
+
+  if (dualinfo) {
+    printf("DUAL SOLUTION%s\n", domain.c_str());
+    printf("  %.16g\n", dobj);
+    printerr(dsol_err);
+  }
+
+  if (priminfo && ((isminimize && pobj < 0) || (!isminimize && pobj > 0))) {
+    printf("DUAL INFEASIBILITY CERTIFICATE%s\n", domain.c_str());
+    printf("  %.16g\n", pobj);
+    printerr(pray_err);
+  }
+}
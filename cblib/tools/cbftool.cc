@@ -17,14 +17,26 @@
 // 3. This notice may not be removed or altered from any source distribution.
 
 #include "frontend-cbf.h"
+#include "frontend-sdpa.h"
+#include "frontend-mps.h"
 #include "backend-cbf.h"
 #include "backend-mps-mosek.h"
 #include "backend-mps-cplex.h"
 #include "backend-sdpa.h"
+#include "backend-lp.h"
 #include "transform-none.h"
 #include "transform-dual.h"
+#include "transform-presolve.h"
+#include "transform-reorder.h"
+#include "transform-chordal.h"
+#include "transform-facial.h"
+#include "transform-svec.h"
+#include "transform-relax.h"
+#include "transform-intpattern.h"
+#include "transform-scale.h"
 
 #include "console.h"
+#include "cbf-helper.h"
 
 #include <string>
 #include <stdio.h>
@@ -40,11 +52,15 @@ int main (int argc, char *argv[])
   const CBFfrontend  *default_frontend,  *frontend;
   const CBFbackend   *default_backend,   *backend;
   const CBFtransform *default_transform, *transform;
-  std::string ofile;
+  std::string ofile, solfile;
   const char *ifile;
   const char *opath;
   const char *pfix;
+  const char *revert;
   bool verbose;
+  bool stream;
+  bool split;
+  long long int memlimit;
   int i;
 
   // For debugging crashes
@@ -52,16 +68,27 @@ int main (int argc, char *argv[])
 
   // List of plugins
   const CBFfrontend *plugs_frontend[] = {&frontend_cbf,
+                                         &frontend_sdpa,
+                                         &frontend_mps,
                                          NULL};
 
   const CBFbackend  *plugs_backend[]  = {&backend_cbf,
                                          &backend_mps_cplex,
                                          &backend_mps_mosek,
                                          &backend_sdpa,
+                                         &backend_lp,
                                          NULL};
 
   const CBFtransform *plugs_transform[] = {&transform_none,
                                            &transform_dual,
+                                           &transform_presolve,
+                                           &transform_reorder,
+                                           &transform_chordal,
+                                           &transform_facial,
+                                           &transform_svec,
+                                           &transform_relax,
+                                           &transform_intpattern,
+                                           &transform_scale,
                                            NULL};
 
   // Default options
@@ -71,6 +98,10 @@ int main (int argc, char *argv[])
   opath = NULL;
   pfix  = NULL;
   verbose = true;
+  stream = false;
+  split = false;
+  memlimit = 0;
+  revert = NULL;
 
   // User defined options
   res = getoptions(argc, argv, plugs_frontend, plugs_backend, plugs_transform,
@@ -79,7 +110,17 @@ int main (int argc, char *argv[])
                    &transform,
                    &opath,
                    &pfix,
-                   &verbose);
+                   &verbose,
+                   &stream,
+                   &split,
+                   &memlimit,
+                   &revert);
+
+  CBF_SORT_MEMLIMIT = memlimit;
+
+  // Parts are split from input files as read
+  if (split && (stream || transform != default_transform))
+    res = CBF_RES_ERR;
 
   if (argc <= 1 || res != CBF_RES_OK)
   {
@@ -94,9 +135,25 @@ int main (int argc, char *argv[])
     for (i=1; i<argc && res==CBF_RES_OK; ++i) {
       if (argv[i]) {
         ifile = argv[i];
-        ofile = swapfiledirandext(ifile, opath, pfix, backend->format);
 
-        res = processfile(frontend, backend, transform, ifile, ofile.c_str(), verbose);
+        if (split) {
+          if (revert)
+            res = mergefile(ifile, opath, pfix, revert, verbose);
+          else
+            res = splitfile(frontend, backend, ifile, opath, pfix, verbose);
+
+        } else if (revert) {
+          // Solutions are read from where the transformed files were written
+          solfile = swapfiledirandext(ifile, opath, pfix, revert);
+          ofile = swapfiledirandext(ifile, NULL, NULL, revert);
+
+          res = revertfile(frontend, transform, ifile, solfile.c_str(), ofile.c_str(), verbose);
+
+        } else {
+          ofile = swapfiledirandext(ifile, opath, pfix, backend->format);
+
+          res = processfile(frontend, backend, transform, ifile, ofile.c_str(), verbose, stream);
+        }
       }
     }
   }
@@ -17,12 +17,19 @@
 // 3. This notice may not be removed or altered from any source distribution.
 
 #include "console.h"
+#include "split-cbf.h"
 
 #include <string>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
 
+static CBFresponsee
+  processstream(const CBFfrontend *frontend, const CBFbackend *backend, const CBFtransform *transform, const char *ifile, const char *ofile, bool verbose);
+
+static const std::string
+  partpostfix(const char *pfix, long long int part);
+
 // -------------------------------------
 // Function definitions
 // -------------------------------------
@@ -71,12 +78,19 @@ void printoptions(const CBFfrontend **plugs_frontend, const CBFbackend **plugs_b
   printf("  -opath path : Output destination.\n");
   printf("  -pfix name  : Postfix for output files.\n");
   printf("  -v          : Verbose.\n");
+  printf("  -stream     : Convert in chunks without holding the coordinates in memory.\n");
+  printf("  -split      : Write the independent parts of input files to files of their own,\n");
+  printf("                numbered by part, along with a .split file to merge their solutions.\n");
+  printf("  -mem-limit m: Sort coordinates on disk when exceeding m megabytes of memory.\n");
+  printf("  -revert ext : Revert solutions (.ext) of transformed files in the output destination,\n");
+  printf("                writing solutions of the input files to the working directory.\n");
+  printf("                With -split, merges the solutions of the parts instead.\n");
 
   printf("\n\n");
 }
 
 CBFresponsee getoptions(int argc, char *argv[], const CBFfrontend **plugs_frontend, const CBFbackend **plugs_backend, const CBFtransform **plugs_transform,
-    const CBFfrontend **frontend, const CBFbackend **backend, const CBFtransform **transform, const char **opath, const char **pfix, bool *verbose) {
+    const CBFfrontend **frontend, const CBFbackend **backend, const CBFtransform **transform, const char **opath, const char **pfix, bool *verbose, bool *stream, bool *split, long long int *memlimit, const char **revert) {
   CBFresponsee res = CBF_RES_OK;
   char const *frontend_name = "";
   char const *backend_name = "";
@@ -143,6 +157,36 @@ CBFresponsee getoptions(int argc, char *argv[], const CBFfrontend **plugs_fronte
         *verbose = true;
         argv[i] = NULL;
       }
+
+      else if (strcmp(argv[i], "-stream") == 0) {
+        *stream = true;
+        argv[i] = NULL;
+      }
+
+      else if (strcmp(argv[i], "-split") == 0) {
+        *split = true;
+        argv[i] = NULL;
+      }
+
+      else if (strcmp(argv[i], "-mem-limit") == 0) {
+        if (i + 1 < argc && atoll(argv[i + 1]) >= 1) {
+          *memlimit = atoll(argv[i + 1]) * 1024 * 1024;
+          argv[i] = NULL;
+          argv[i + 1] = NULL;
+        } else {
+          res = CBF_RES_ERR;
+        }
+      }
+
+      else if (strcmp(argv[i], "-revert") == 0) {
+        if (i + 1 < argc) {
+          *revert = argv[i + 1];
+          argv[i] = NULL;
+          argv[i + 1] = NULL;
+        } else {
+          res = CBF_RES_ERR;
+        }
+      }
     }
   }
 
@@ -214,12 +258,16 @@ const std::string swapfiledirandext(const char *ifile, const char *newpath, cons
   return ofilestr;
 }
 
-CBFresponsee processfile(const CBFfrontend *frontend, const CBFbackend *backend, const CBFtransform *transform, const char *ifile, const char *ofile, bool verbose) {
+CBFresponsee processfile(const CBFfrontend *frontend, const CBFbackend *backend, const CBFtransform *transform, const char *ifile, const char *ofile, bool verbose, bool stream) {
   CBFresponsee res = CBF_RES_OK;
   CBFfrontendmemory mem = { 0, };
   CBFtransform_param param;
   CBFdata data = { 0, };
 
+  if (stream) {
+    return processstream(frontend, backend, transform, ifile, ofile, verbose);
+  }
+
   // Read file
   if (verbose) {
     printf("Reading %s\n", ifile);
@@ -256,3 +304,272 @@ CBFresponsee processfile(const CBFfrontend *frontend, const CBFbackend *backend,
 
   return res;
 }
+
+CBFresponsee revertfile(const CBFfrontend *frontend, const CBFtransform *transform, const char *ifile, const char *solfile, const char *ofile, bool verbose) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFfrontendmemory mem = { 0, };
+  CBFtransform_param param;
+  CBFsolution sol;
+  CBFdata data = { 0, };
+
+  if (!transform->revert) {
+    printf("Reverting solutions is not supported by the chosen transform: -t %s\n", transform->name);
+    return CBF_RES_ERR;
+  }
+
+  // Read file
+  if (verbose) {
+    printf("Reading %s\n", ifile);
+  }
+  res = frontend->read(ifile, &data, &mem);
+
+  if (res != CBF_RES_OK) {
+    printf("Failed to read file: %s\n", ifile);
+
+  } else {
+    // Read solution of the transformed file
+    if (verbose) {
+      printf("Reading %s\n", solfile);
+    }
+    res = CBF_readsol(solfile, 0, &sol);
+
+    if (res != CBF_RES_OK) {
+      printf("Failed to read file: %s\n", solfile);
+
+    } else {
+      // Initialize parameters
+      param.init(&data);
+      param.sol = &sol;
+
+      // Revert solution
+      res = transform->revert(&data, param);
+
+      if (res != CBF_RES_OK) {
+        printf("Failed to revert solution: %s\n", solfile);
+
+      } else {
+        // Write solution
+        if (verbose) {
+          printf("Writing %s\n", ofile);
+        }
+        res = CBF_writesol(ofile, &sol, 1);
+
+        if (res != CBF_RES_OK)
+          printf("Failed to write file: %s\n", ofile);
+      }
+
+      CBF_cleansol(&sol);
+    }
+
+    // Clean data structure
+    frontend->clean(&data, &mem);
+  }
+
+  return res;
+}
+
+CBFresponsee splitfile(const CBFfrontend *frontend, const CBFbackend *backend, const char *ifile, const char *opath, const char *pfix, bool verbose) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFfrontendmemory mem = { 0, };
+  CBFdata data = { 0, };
+  CBFdata *parts = NULL;
+  CBFsplit split;
+  std::string ofile;
+  long long int p;
+
+  // Read file
+  if (verbose) {
+    printf("Reading %s\n", ifile);
+  }
+  res = frontend->read(ifile, &data, &mem);
+
+  if (res != CBF_RES_OK) {
+    printf("Failed to read file: %s\n", ifile);
+
+  } else {
+    // Split file into independent parts
+    res = CBF_split(&data, &split);
+
+    if (res == CBF_RES_OK) {
+      parts = (CBFdata*) calloc(split.partnum, sizeof(parts[0]));
+      if (split.partnum >= 1 && !parts)
+        res = CBF_RES_ERR;
+    }
+
+    if (res == CBF_RES_OK)
+      res = CBF_splitdata(&data, &split, parts);
+
+    if (res != CBF_RES_OK) {
+      printf("Failed to split file: %s\n", ifile);
+
+    } else {
+      // Write parts
+      for (p=0; p<split.partnum && res==CBF_RES_OK; ++p) {
+        ofile = swapfiledirandext(ifile, opath, partpostfix(pfix, p).c_str(), backend->format);
+
+        if (verbose) {
+          printf("Writing %s\n", ofile.c_str());
+        }
+        res = backend->write(ofile.c_str(), parts[p]);
+
+        if (res != CBF_RES_OK)
+          printf("Failed to write file: %s\n", ofile.c_str());
+      }
+
+      // Write partition
+      if (res == CBF_RES_OK) {
+        ofile = swapfiledirandext(ifile, opath, pfix, "split");
+
+        if (verbose) {
+          printf("Writing %s\n", ofile.c_str());
+        }
+        res = CBF_writesplit(ofile.c_str(), &split);
+
+        if (res != CBF_RES_OK)
+          printf("Failed to write file: %s\n", ofile.c_str());
+      }
+    }
+
+    // Clean data structures
+    if (parts)
+      CBF_cleansplitdata(&split, parts);
+
+    free(parts);
+    CBF_cleansplit(&split);
+    frontend->clean(&data, &mem);
+  }
+
+  return res;
+}
+
+CBFresponsee mergefile(const char *ifile, const char *opath, const char *pfix, const char *ext, bool verbose) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFsolution *sols = NULL;
+  CBFsolution sol;
+  CBFsplit split;
+  std::string file;
+  long long int p;
+
+  // Read partition
+  file = swapfiledirandext(ifile, opath, pfix, "split");
+
+  if (verbose) {
+    printf("Reading %s\n", file.c_str());
+  }
+  res = CBF_readsplit(file.c_str(), &split);
+
+  if (res != CBF_RES_OK) {
+    printf("Failed to read file: %s\n", file.c_str());
+
+  } else {
+    sols = (CBFsolution*) calloc(split.partnum, sizeof(sols[0]));
+    if (split.partnum >= 1 && !sols)
+      res = CBF_RES_ERR;
+
+    // Read solutions of the parts
+    for (p=0; p<split.partnum && res==CBF_RES_OK; ++p) {
+      file = swapfiledirandext(ifile, opath, partpostfix(pfix, p).c_str(), ext);
+
+      if (verbose) {
+        printf("Reading %s\n", file.c_str());
+      }
+      res = CBF_readsol(file.c_str(), 0, &sols[p]);
+
+      if (res != CBF_RES_OK)
+        printf("Failed to read file: %s\n", file.c_str());
+    }
+
+    if (res == CBF_RES_OK) {
+      // Merge solutions
+      res = CBF_mergesol(&split, sols, &sol);
+
+      if (res != CBF_RES_OK) {
+        printf("Failed to merge solutions of file: %s\n", ifile);
+
+      } else {
+        // Write solution
+        file = swapfiledirandext(ifile, NULL, NULL, ext);
+
+        if (verbose) {
+          printf("Writing %s\n", file.c_str());
+        }
+        res = CBF_writesol(file.c_str(), &sol, 1);
+
+        if (res != CBF_RES_OK)
+          printf("Failed to write file: %s\n", file.c_str());
+
+        CBF_cleansol(&sol);
+      }
+    }
+
+    for (p=0; sols && p<split.partnum; ++p)
+      CBF_cleansol(&sols[p]);
+
+    free(sols);
+    CBF_cleansplit(&split);
+  }
+
+  return res;
+}
+
+static CBFresponsee processstream(const CBFfrontend *frontend, const CBFbackend *backend, const CBFtransform *transform, const char *ifile, const char *ofile, bool verbose) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_param param;
+  CBFstream backendstream = { 0, };
+  CBFstream transformstream = { 0, };
+
+  if (!frontend->stream || !transform->stream || !backend->stream) {
+    printf("Streaming is not supported by the chosen plugins: -i %s -t %s -o %s\n", frontend->name, transform->name, backend->name);
+    return CBF_RES_ERR;
+  }
+
+  // Output is opened before input is read
+  if (strcmp(ifile, ofile) == 0) {
+    printf("Cannot stream a file onto itself: %s\n", ifile);
+    return CBF_RES_ERR;
+  }
+
+  // Open output
+  if (verbose) {
+    printf("Streaming %s to %s\n", ifile, ofile);
+  }
+  res = backend->stream(ofile, &backendstream);
+
+  if (res != CBF_RES_OK) {
+    printf("Failed to write file: %s\n", ofile);
+
+  } else {
+    // Initialize parameters, as no problem data is at hand when streaming
+    param.init(NULL);
+
+    // Chain transformation in front of output
+    res = transform->stream(&transformstream, backendstream, param);
+
+    if (res != CBF_RES_OK) {
+      printf("Failed to transform file: %s\n", ifile);
+      backendstream.finish(backendstream.userdata, res);
+
+    } else {
+      // Read input through the chain
+      res = frontend->stream(ifile, &transformstream);
+
+      if (res != CBF_RES_OK)
+        printf("Failed to stream file: %s\n", ifile);
+
+      res = transformstream.finish(transformstream.userdata, res);
+    }
+  }
+
+  return res;
+}
+
+static const std::string partpostfix(const char *pfix, long long int part) {
+  char num[32];
+
+  sprintf(num, "_%lli", part);
+
+  if (pfix)
+    return std::string(pfix) + num;
+  else
+    return std::string(num);
+}
@@ -43,7 +43,11 @@ CBFresponsee getoptions(int argc, char *argv[],
     const CBFtransform **transform,
     const char         **opath,
     const char         **pfix,
-    bool                *verbose);
+    bool                *verbose,
+    bool                *stream,
+    bool                *split,
+    long long int       *memlimit,
+    const char         **revert);
 
 const std::string swapfiledirandext(
     const char *ifile,
@@ -57,6 +61,30 @@ CBFresponsee processfile(
     const CBFtransform *transform,
     const char *ifile,
     const char *ofile,
+    const bool verbose,
+    const bool stream);
+
+CBFresponsee revertfile(
+    const CBFfrontend  *frontend,
+    const CBFtransform *transform,
+    const char *ifile,
+    const char *solfile,
+    const char *ofile,
+    const bool verbose);
+
+CBFresponsee splitfile(
+    const CBFfrontend *frontend,
+    const CBFbackend  *backend,
+    const char *ifile,
+    const char *opath,
+    const char *pfix,
+    const bool verbose);
+
+CBFresponsee mergefile(
+    const char *ifile,
+    const char *opath,
+    const char *pfix,
+    const char *ext,
     const bool verbose);
 
 #endif
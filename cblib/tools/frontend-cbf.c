@@ -28,20 +28,38 @@ typedef FILE CBFFILE;
 #define FOPEN(x,y) fopen(x,y)
 #define FCLOSE(x) fclose(x)
 #define FGETS(x,y,z) fgets(x,y,z)
+#define FTELL(x) ftell(x)
+#define FSEEK(x,y) fseek(x,y,SEEK_SET)
 #else
 #include <zlib.h>
 typedef struct gzFile_s CBFFILE;
 #define FOPEN(x,y) gzopen(x,y)
 #define FCLOSE(x) gzclose(x)
 #define FGETS(x,y,z) gzgets(z,x,y)
+#define FTELL(x) gztell(x)
+#define FSEEK(x,y) (gzseek(x,y,SEEK_SET) < 0 ? -1 : 0)
 #endif
 
+typedef struct CBFcollector_struct {
+  CBFdata *data;
+  long long int nnz;
+} CBFcollector;
+
 static CBFresponsee
   CBF_read(const char *file, CBFdata *data, CBFfrontendmemory *mem);
 
 static void
   CBF_clean(CBFdata *data, CBFfrontendmemory *mem);
 
+static CBFresponsee
+  CBF_stream(const char *file, CBFstream *stream);
+
+static CBFresponsee
+  CBF_parse(const char *file, CBFdata *data, CBFstream *stream, CBFlazy *lazy);
+
+static CBFresponsee
+  CBF_parsestructure(CBFdata *data, CBFstream *stream, int *isstructured);
+
 static CBFresponsee
   CBF_fgets(CBFFILE *pFile, long long int *linecount);
 
@@ -67,34 +85,79 @@ static CBFresponsee
   readPSDVAR(CBFFILE *pFile, long long int *linecount, CBFdata *data);
 
 static CBFresponsee
-  readOBJFCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data);
+  readPOWCONES(CBFFILE *pFile, long long int *linecount, long long int *conenum, long long int *alphanum, long long int **alphabeg, double **alpha);
+
+static CBFresponsee
+  setSTACKPARAM(long long int **stackparam, long long int stacknum, long long int i, long long int param);
+
+static CBFresponsee
+  checkSTACKPARAM(long long int stacknum, const long long int *stackdim, const CBFscalarconee *stackdomain, const long long int *stackparam, const CBFdata *data);
+
+static void
+  mergeSTACKS(long long int *stacknum, long long int *stackdim, CBFscalarconee *stackdomain, long long int *stackparam);
+
+static CBFresponsee
+  readBLOCK(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream, CBFblocke block);
+
+static CBFresponsee
+  skipBLOCK(CBFFILE *pFile, long long int *linecount, CBFblocke block, long long int *nnz);
+
+static void
+  releaseBLOCK(CBFdata *data, CBFblocke block);
+
+static CBFresponsee
+  readOBJFCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream);
+
+static CBFresponsee
+  readOBJACOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream);
 
 static CBFresponsee
-  readOBJACOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data);
+  readOBJBCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream);
 
 static CBFresponsee
-  readOBJBCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data);
+  readFCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream);
 
 static CBFresponsee
-  readFCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data);
+  readACOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream);
 
 static CBFresponsee
-  readACOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data);
+  readBCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream);
 
 static CBFresponsee
-  readBCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data);
+  readHCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream);
 
 static CBFresponsee
-  readHCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data);
+  readDCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream);
 
 static CBFresponsee
-  readDCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data);
+  collect_structure(void *userdata, CBFdata *data);
+
+static CBFresponsee
+  collect_blockbegin(void *userdata, CBFblocke block, long long int nnz);
+
+static CBFresponsee
+  collect_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk);
+
+static CBFresponsee
+  collect_blockend(void *userdata, CBFblocke block);
+
+static CBFresponsee
+  handler_structure(void *userdata, CBFdata *data);
+
+static CBFresponsee
+  handler_blockbegin(void *userdata, CBFblocke block, long long int nnz);
+
+static CBFresponsee
+  handler_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk);
+
+static CBFresponsee
+  handler_blockend(void *userdata, CBFblocke block);
 
 // -------------------------------------
 // Global variable
 // -------------------------------------
 
-CBFfrontend const frontend_cbf = { "cbf", CBF_read, CBF_clean };
+CBFfrontend const frontend_cbf = { "cbf", CBF_read, CBF_clean, CBF_stream };
 
 
 // -------------------------------------
@@ -103,7 +166,135 @@ CBFfrontend const frontend_cbf = { "cbf", CBF_read, CBF_clean };
 
 static CBFresponsee CBF_read(const char *file, CBFdata *data, CBFfrontendmemory *mem) {
   CBFresponsee res = CBF_RES_OK;
-  long long int linecount = 0;
+  CBFcollector collector = { 0, };
+  CBFstream stream = { 0, };
+
+  // Coordinates are collected into the same data structure
+  collector.data = data;
+
+  stream.userdata   = &collector;
+  stream.structure  = collect_structure;
+  stream.blockbegin = collect_blockbegin;
+  stream.blockchunk = collect_blockchunk;
+  stream.blockend   = collect_blockend;
+
+  res = CBF_parse(file, data, &stream, NULL);
+
+  if (res != CBF_RES_OK)
+    CBF_clean(data, mem);
+
+  return res;
+}
+
+static CBFresponsee CBF_stream(const char *file, CBFstream *stream) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFdata data = { 0, };
+
+  // Only the structural information is kept in memory
+  res = CBF_parse(file, &data, stream, NULL);
+
+  CBF_clean(&data, NULL);
+  return res;
+}
+
+CBFresponsee CBF_readhandler(const char *file, const CBFhandler *handler) {
+  CBFstream stream = { 0, };
+
+  stream.userdata   = (void*) handler;
+  stream.structure  = handler_structure;
+  stream.blockbegin = handler_blockbegin;
+  stream.blockchunk = handler_blockchunk;
+  stream.blockend   = handler_blockend;
+
+  return CBF_stream(file, &stream);
+}
+
+CBFresponsee CBF_openlazy(const char *file, CBFlazy *lazy) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFstream stream = { 0, };
+  int i;
+
+  memset(lazy, 0, sizeof(*lazy));
+  for (i=0; i<CBF_BLOCK_END; ++i)
+    lazy->blockpos[i] = -1;
+
+  lazy->file = (char*) malloc((strlen(file) + 1) * sizeof(lazy->file[0]));
+  if (!lazy->file)
+    return CBF_RES_ERR;
+
+  strcpy(lazy->file, file);
+
+  // Coordinate blocks are only located, and read on first access
+  stream.structure = collect_structure;
+
+  res = CBF_parse(file, &lazy->data, &stream, lazy);
+
+  if (res != CBF_RES_OK)
+    CBF_closelazy(lazy);
+
+  return res;
+}
+
+CBFresponsee CBF_lazyblock(CBFlazy *lazy, CBFblocke block, const CBFdata **data) {
+  CBFresponsee res = CBF_RES_OK;
+  CBFcollector collector = { 0, };
+  CBFstream stream = { 0, };
+  long long int linecount;
+  CBFFILE *pFile = NULL;
+
+  if (block < CBF_BLOCK_BEGIN || block >= CBF_BLOCK_END)
+    return CBF_RES_ERR;
+
+  // Blocks are read at most once, and absent blocks are empty
+  if (!lazy->isloaded[block] && lazy->blockpos[block] >= 0) {
+    pFile = FOPEN(lazy->file, "rt");
+    if (!pFile) {
+      return CBF_RES_ERR;
+    }
+
+    collector.data = &lazy->data;
+
+    stream.userdata   = &collector;
+    stream.structure  = collect_structure;
+    stream.blockbegin = collect_blockbegin;
+    stream.blockchunk = collect_blockchunk;
+    stream.blockend   = collect_blockend;
+
+    linecount = lazy->blockline[block];
+
+    if (FSEEK(pFile, lazy->blockpos[block]) != 0)
+      res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK)
+      res = readBLOCK(pFile, &linecount, &lazy->data, &stream, block);
+
+    // A block that failed is left empty, to be read again on next access
+    if (res == CBF_RES_OK) {
+      lazy->isloaded[block] = 1;
+    } else {
+      printf("Failed to parse line: %lli\n", linecount);
+      releaseBLOCK(&lazy->data, block);
+    }
+
+    FCLOSE(pFile);
+  }
+
+  *data = &lazy->data;
+  return res;
+}
+
+void CBF_closelazy(CBFlazy *lazy) {
+  CBF_clean(&lazy->data, NULL);
+  free(lazy->file);
+  memset(lazy, 0, sizeof(*lazy));
+}
+
+static CBFresponsee CBF_parse(const char *file, CBFdata *data, CBFstream *stream, CBFlazy *lazy) {
+  CBFresponsee res = CBF_RES_OK;
+  long long int linecount = 0, problem = 0;
+  int isstructured = 0, isdone = 0;
+  char blockseen[CBF_BLOCK_END] = { 0, };
+  CBFblocke block;
   CBFFILE *pFile = NULL;
 
   pFile = FOPEN(file, "rt");
@@ -114,7 +305,7 @@ static CBFresponsee CBF_read(const char *file, CBFdata *data, CBFfrontendmemory
   // Keyword OBJ should exist!
   data->objsense = CBF_OBJ_END;
 
-  while( res==CBF_RES_OK && CBF_fgets(pFile, &linecount)==CBF_RES_OK )
+  while( res==CBF_RES_OK && !isdone && CBF_fgets(pFile, &linecount)==CBF_RES_OK )
   {
     // Parse keyword on non-empty lines
     if ( sscanf(CBF_LINE_BUFFER, CBF_NAME_FORMAT, CBF_NAME_BUFFER)==1 )
@@ -130,7 +321,7 @@ static CBFresponsee CBF_read(const char *file, CBFdata *data, CBFfrontendmemory
           res = CBF_RES_ERR;
         }
 
-      } else {
+      } else if (!isstructured) {
 
         if (strcmp(CBF_NAME_BUFFER, "OBJSENSE") == 0)
           res = readOBJSENSE(pFile, &linecount, data);
@@ -150,33 +341,47 @@ static CBFresponsee CBF_read(const char *file, CBFdata *data, CBFfrontendmemory
         else if (strcmp(CBF_NAME_BUFFER, "PSDVAR") == 0)
           res = readPSDVAR(pFile, &linecount, data);
 
-        else if (strcmp(CBF_NAME_BUFFER, "OBJFCOORD") == 0)
-          res = readOBJFCOORD(pFile, &linecount, data);
+        else if (strcmp(CBF_NAME_BUFFER, "POWCONES") == 0)
+          res = readPOWCONES(pFile, &linecount, &data->powconenum, &data->powalphanum, &data->powalphabeg, &data->powalpha);
 
-        else if (strcmp(CBF_NAME_BUFFER, "OBJACOORD") == 0)
-          res = readOBJACOORD(pFile, &linecount, data);
+        else if (strcmp(CBF_NAME_BUFFER, "POW*CONES") == 0)
+          res = readPOWCONES(pFile, &linecount, &data->dpowconenum, &data->dpowalphanum, &data->dpowalphabeg, &data->dpowalpha);
 
-        else if (strcmp(CBF_NAME_BUFFER, "OBJBCOORD") == 0)
-          res = readOBJBCOORD(pFile, &linecount, data);
+        else {
+          // Structural information ends at the first coordinate block
+          res = CBF_parsestructure(data, stream, &isstructured);
+        }
+      }
 
-        else if (strcmp(CBF_NAME_BUFFER, "FCOORD") == 0)
-          res = readFCOORD(pFile, &linecount, data);
+      if (res == CBF_RES_OK && isstructured) {
 
-        else if (strcmp(CBF_NAME_BUFFER, "ACOORD") == 0)
-          res = readACOORD(pFile, &linecount, data);
+        if (strcmp(CBF_NAME_BUFFER, "CHANGE") == 0) {
+          // Without a receiver for the sequence, only the base problem is read
+          if (!stream->problemend) {
+            isdone = 1;
+          } else {
+            res = stream->problemend(stream->userdata, problem++);
+            memset(blockseen, 0, sizeof(blockseen));
+          }
 
-        else if (strcmp(CBF_NAME_BUFFER, "BCOORD") == 0)
-          res = readBCOORD(pFile, &linecount, data);
+        } else if (CBF_strtoblock(CBF_NAME_BUFFER, &block) != CBF_RES_OK) {
+          printf("Keyword %s not recognized!\n", CBF_NAME_BUFFER);
+          res = CBF_RES_ERR;
 
-        else if (strcmp(CBF_NAME_BUFFER, "HCOORD") == 0)
-          res = readHCOORD(pFile, &linecount, data);
+        } else if (blockseen[block]) {
+          printf("Keyword %s also found earlier and can only appear once.\n", CBF_NAME_BUFFER);
+          res = CBF_RES_ERR;
 
-        else if (strcmp(CBF_NAME_BUFFER, "DCOORD") == 0)
-          res = readDCOORD(pFile, &linecount, data);
+        } else {
+          blockseen[block] = 1;
 
-        else {
-          printf("Keyword %s not recognized!\n", CBF_NAME_BUFFER);
-          res = CBF_RES_ERR;
+          if (lazy) {
+            lazy->blockpos[block] = FTELL(pFile);
+            lazy->blockline[block] = linecount;
+            res = skipBLOCK(pFile, &linecount, block, &lazy->blocknnz[block]);
+          } else {
+            res = readBLOCK(pFile, &linecount, data, stream, block);
+          }
         }
       }
 
@@ -192,33 +397,66 @@ static CBFresponsee CBF_read(const char *file, CBFdata *data, CBFfrontendmemory
     }
   }
 
-  if (res == CBF_RES_OK) {
-    if (data->objsense == CBF_OBJ_END) {
-      printf("Keyword OBJSENSE is missing.\n");
-      res = CBF_RES_ERR;
-    }
-  }
+  // Files without coordinates end with the structural information
+  if (res == CBF_RES_OK && !isstructured)
+    res = CBF_parsestructure(data, stream, &isstructured);
+
+  if (res == CBF_RES_OK && !isdone && stream->problemend)
+    res = stream->problemend(stream->userdata, problem);
 
-  if (res != CBF_RES_OK) {
+  if (res != CBF_RES_OK)
     printf("Failed to parse line: %lli\n", linecount);
-    CBF_clean(data, mem);
-  }
 
   FCLOSE(pFile);
   return res;
 }
 
+static CBFresponsee CBF_parsestructure(CBFdata *data, CBFstream *stream, int *isstructured)
+{
+  CBFresponsee res = CBF_RES_OK;
+
+  if (data->objsense == CBF_OBJ_END) {
+    printf("Keyword OBJSENSE is missing.\n");
+    res = CBF_RES_ERR;
+  }
+
+  if (res == CBF_RES_OK)
+    res = checkSTACKPARAM(data->mapstacknum, data->mapstackdim, data->mapstackdomain, data->mapstackparam, data);
+
+  if (res == CBF_RES_OK)
+    res = checkSTACKPARAM(data->varstacknum, data->varstackdim, data->varstackdomain, data->varstackparam, data);
+
+  if (res == CBF_RES_OK) {
+    mergeSTACKS(&data->mapstacknum, data->mapstackdim, data->mapstackdomain, data->mapstackparam);
+    mergeSTACKS(&data->varstacknum, data->varstackdim, data->varstackdomain, data->varstackparam);
+  }
+
+  if (res == CBF_RES_OK)
+    res = stream->structure(stream->userdata, data);
+
+  *isstructured = 1;
+  return res;
+}
+
 static void CBF_clean(CBFdata *data, CBFfrontendmemory *mem) {
   if (data->mapstacknum >= 1) {
     free(data->mapstackdim);
     free(data->mapstackdomain);
+    free(data->mapstackparam);
   }
 
   if (data->varstacknum >= 1) {
     free(data->varstackdim);
     free(data->varstackdomain);
+    free(data->varstackparam);
   }
 
+  free(data->powalphabeg);
+  free(data->powalpha);
+
+  free(data->dpowalphabeg);
+  free(data->dpowalpha);
+
   if (data->intvarnum >= 1) {
     free(data->intvar);
   }
@@ -330,7 +568,7 @@ static CBFresponsee readOBJSENSE(CBFFILE *pFile, long long int *linecount, CBFda
 static CBFresponsee readCON(CBFFILE *pFile, long long int *linecount, CBFdata *data)
 {
   CBFresponsee res = CBF_RES_OK;
-  long long int i, mapnum = 0;
+  long long int i, param, mapnum = 0;
 
   res = CBF_fgets(pFile, linecount);
 
@@ -356,9 +594,12 @@ static CBFresponsee readCON(CBFFILE *pFile, long long int *linecount, CBFdata *d
 
     if (res == CBF_RES_OK) {
       mapnum += data->mapstackdim[i];
-      res = CBF_strtocone(CBF_NAME_BUFFER, &data->mapstackdomain[i]);
+      res = CBF_strtoparamcone(CBF_NAME_BUFFER, &data->mapstackdomain[i], &param);
     }
 
+    if (res == CBF_RES_OK)
+      res = setSTACKPARAM(&data->mapstackparam, data->mapstacknum, i, param);
+
     if (res == CBF_RES_OK)
       if (data->mapstackdim[i] < 0)
         res = CBF_RES_ERR;
@@ -374,7 +615,7 @@ static CBFresponsee readCON(CBFFILE *pFile, long long int *linecount, CBFdata *d
 static CBFresponsee readVAR(CBFFILE *pFile, long long int *linecount, CBFdata *data)
 {
   CBFresponsee res = CBF_RES_OK;
-  long long int i, varnum = 0;
+  long long int i, param, varnum = 0;
 
   res = CBF_fgets(pFile, linecount);
 
@@ -400,9 +641,12 @@ static CBFresponsee readVAR(CBFFILE *pFile, long long int *linecount, CBFdata *d
 
     if (res == CBF_RES_OK) {
       varnum += data->varstackdim[i];
-      res = CBF_strtocone(CBF_NAME_BUFFER, &data->varstackdomain[i]);
+      res = CBF_strtoparamcone(CBF_NAME_BUFFER, &data->varstackdomain[i], &param);
     }
 
+    if (res == CBF_RES_OK)
+      res = setSTACKPARAM(&data->varstackparam, data->varstacknum, i, param);
+
     if (res == CBF_RES_OK)
       if (data->varstackdim[i] < 0)
         res = CBF_RES_ERR;
@@ -520,316 +764,991 @@ static CBFresponsee readPSDVAR(CBFFILE *pFile, long long int *linecount, CBFdata
   return res;
 }
 
-static CBFresponsee readOBJFCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data)
+static CBFresponsee readPOWCONES(CBFFILE *pFile, long long int *linecount, long long int *conenum, long long int *alphanum, long long int **alphabeg, double **alpha)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, j, num;
+
+  if (*conenum >= 1) {
+    printf("Keyword %s also found earlier and can only appear once.\n", CBF_NAME_BUFFER);
+    return CBF_RES_ERR;
+  }
+
+  res = CBF_fgets(pFile, linecount);
+
+  if (res == CBF_RES_OK)
+    if (sscanf(CBF_LINE_BUFFER, "%lli %lli", conenum, alphanum) != 2)
+      res = CBF_RES_ERR;
+
+  if (res == CBF_RES_OK)
+    if (*conenum < 0 || *alphanum < 0)
+      res = CBF_RES_ERR;
+
+  // All parameters are kept in one pool, with an offset for each cone
+  if (res == CBF_RES_OK) {
+    *alphabeg = (long long int*) calloc(*conenum + 1, sizeof((*alphabeg)[0]));
+    *alpha = (double*) calloc(*alphanum, sizeof((*alpha)[0]));
+
+    if (!*alphabeg || (*alphanum >= 1 && !*alpha))
+      res = CBF_RES_ERR;
+  }
+
+  for (i=0; i<(*conenum) && res==CBF_RES_OK; ++i) {
+    res = CBF_fgets(pFile, linecount);
+
+    if (res == CBF_RES_OK)
+      if (sscanf(CBF_LINE_BUFFER, "%lli", &num) != 1)
+        res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK)
+      if (num < 1 || (*alphabeg)[i] + num > *alphanum)
+        res = CBF_RES_ERR;
+
+    for (j=(*alphabeg)[i]; j<(*alphabeg)[i]+num && res==CBF_RES_OK; ++j) {
+      res = CBF_fgets(pFile, linecount);
+
+      if (res == CBF_RES_OK)
+        if (sscanf(CBF_LINE_BUFFER, "%lg", &(*alpha)[j]) != 1)
+          res = CBF_RES_ERR;
+
+      if (res == CBF_RES_OK)
+        if ((*alpha)[j] <= 0.0)
+          res = CBF_RES_ERR;
+    }
+
+    if (res == CBF_RES_OK)
+      (*alphabeg)[i+1] = (*alphabeg)[i] + num;
+  }
+
+  if (res == CBF_RES_OK)
+    if ((*alphabeg)[*conenum] != *alphanum)
+      res = CBF_RES_ERR;
+
+  return res;
+}
+
+static CBFresponsee setSTACKPARAM(long long int **stackparam, long long int stacknum, long long int i, long long int param)
+{
+  long long int k;
+
+  // Stack parameters are only allocated once a parametric cone is found
+  if (param >= 0 && !*stackparam) {
+    *stackparam = (long long int*) malloc(stacknum * sizeof((*stackparam)[0]));
+    if (!*stackparam)
+      return CBF_RES_ERR;
+
+    for (k=0; k<stacknum; ++k)
+      (*stackparam)[k] = -1;
+  }
+
+  if (*stackparam)
+    (*stackparam)[i] = param;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee checkSTACKPARAM(long long int stacknum, const long long int *stackdim, const CBFscalarconee *stackdomain, const long long int *stackparam, const CBFdata *data)
+{
+  long long int i, conenum, alphanum;
+  const long long int *alphabeg;
+  const char *conenam;
+
+  for (i=0; i<stacknum; ++i) {
+    if (stackdomain[i] == CBF_CONE_PPOW) {
+      conenum = data->powconenum;
+      alphabeg = data->powalphabeg;
+    } else if (stackdomain[i] == CBF_CONE_DPOW) {
+      conenum = data->dpowconenum;
+      alphabeg = data->dpowalphabeg;
+    } else {
+      continue;
+    }
+
+    CBF_conetostr(stackdomain[i], &conenam);
+
+    if (stackparam[i] >= conenum) {
+      printf("Cone @%lli:%s refers to undefined parameters.\n", stackparam[i], conenam);
+      return CBF_RES_ERR;
+    }
+
+    // Each parameter weighs one of the leading members of the cone
+    alphanum = alphabeg[stackparam[i]+1] - alphabeg[stackparam[i]];
+    if (stackdim[i] < alphanum) {
+      printf("Cone @%lli:%s has fewer members than parameters.\n", stackparam[i], conenam);
+      return CBF_RES_ERR;
+    }
+  }
+
+  return CBF_RES_OK;
+}
+
+static void mergeSTACKS(long long int *stacknum, long long int *stackdim, CBFscalarconee *stackdomain, long long int *stackparam)
+{
+  long long int i, k = 0;
+
+  // Adjacent stacks of the same linear domain are merged, as modeling layers
+  // tend to write one per constraint. Every other stack is a cone of its own.
+  for (i=0; i<*stacknum; ++i) {
+    if (k >= 1 && stackdomain[i] == stackdomain[k-1] && stackdomain[i] <= CBF_CONE_ZERO) {
+      stackdim[k-1] += stackdim[i];
+    } else {
+      stackdomain[k] = stackdomain[i];
+      stackdim[k] = stackdim[i];
+      if (stackparam)
+        stackparam[k] = stackparam[i];
+      ++k;
+    }
+  }
+
+  *stacknum = k;
+}
+
+static CBFresponsee readBLOCK(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream, CBFblocke block)
+{
+  CBFresponsee res = CBF_RES_OK;
+
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:  res = readOBJFCOORD(pFile, linecount, data, stream);  break;
+  case CBF_BLOCK_OBJACOORD:  res = readOBJACOORD(pFile, linecount, data, stream);  break;
+  case CBF_BLOCK_OBJBCOORD:  res = readOBJBCOORD(pFile, linecount, data, stream);  break;
+  case CBF_BLOCK_FCOORD:     res = readFCOORD(pFile, linecount, data, stream);     break;
+  case CBF_BLOCK_ACOORD:     res = readACOORD(pFile, linecount, data, stream);     break;
+  case CBF_BLOCK_BCOORD:     res = readBCOORD(pFile, linecount, data, stream);     break;
+  case CBF_BLOCK_HCOORD:     res = readHCOORD(pFile, linecount, data, stream);     break;
+  case CBF_BLOCK_DCOORD:     res = readDCOORD(pFile, linecount, data, stream);     break;
+  default:                   res = CBF_RES_ERR;                                    break;
+  }
+
+  return res;
+}
+
+static CBFresponsee skipBLOCK(CBFFILE *pFile, long long int *linecount, CBFblocke block, long long int *nnz)
 {
   CBFresponsee res = CBF_RES_OK;
   long long int i;
 
   res = CBF_fgets(pFile, linecount);
 
+  // The only line of OBJBCOORD is the value itself
+  if (block == CBF_BLOCK_OBJBCOORD) {
+    *nnz = 1;
+    return res;
+  }
+
+  if (res == CBF_RES_OK)
+    if (sscanf(CBF_LINE_BUFFER, "%lli", nnz) != 1 || *nnz < 0)
+      res = CBF_RES_ERR;
+
+  // Coordinates are passed over without being parsed
+  for (i=0; i<*nnz && res==CBF_RES_OK; ++i)
+    res = CBF_fgets(pFile, linecount);
+
+  return res;
+}
+
+static void releaseBLOCK(CBFdata *data, CBFblocke block)
+{
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:
+    free(data->objfsubj);  data->objfsubj = NULL;
+    free(data->objfsubk);  data->objfsubk = NULL;
+    free(data->objfsubl);  data->objfsubl = NULL;
+    free(data->objfval);   data->objfval  = NULL;
+    data->objfnnz = 0;
+    break;
+
+  case CBF_BLOCK_OBJACOORD:
+    free(data->objasubj);  data->objasubj = NULL;
+    free(data->objaval);   data->objaval  = NULL;
+    data->objannz = 0;
+    break;
+
+  case CBF_BLOCK_OBJBCOORD:
+    data->objbval = 0;
+    break;
+
+  case CBF_BLOCK_FCOORD:
+    free(data->fsubi);  data->fsubi = NULL;
+    free(data->fsubj);  data->fsubj = NULL;
+    free(data->fsubk);  data->fsubk = NULL;
+    free(data->fsubl);  data->fsubl = NULL;
+    free(data->fval);   data->fval  = NULL;
+    data->fnnz = 0;
+    break;
+
+  case CBF_BLOCK_ACOORD:
+    free(data->asubi);  data->asubi = NULL;
+    free(data->asubj);  data->asubj = NULL;
+    free(data->aval);   data->aval  = NULL;
+    data->annz = 0;
+    break;
+
+  case CBF_BLOCK_BCOORD:
+    free(data->bsubi);  data->bsubi = NULL;
+    free(data->bval);   data->bval  = NULL;
+    data->bnnz = 0;
+    break;
+
+  case CBF_BLOCK_HCOORD:
+    free(data->hsubi);  data->hsubi = NULL;
+    free(data->hsubj);  data->hsubj = NULL;
+    free(data->hsubk);  data->hsubk = NULL;
+    free(data->hsubl);  data->hsubl = NULL;
+    free(data->hval);   data->hval  = NULL;
+    data->hnnz = 0;
+    break;
+
+  case CBF_BLOCK_DCOORD:
+    free(data->dsubi);  data->dsubi = NULL;
+    free(data->dsubk);  data->dsubk = NULL;
+    free(data->dsubl);  data->dsubl = NULL;
+    free(data->dval);   data->dval  = NULL;
+    data->dnnz = 0;
+    break;
+
+  default:
+    break;
+  }
+}
+
+static CBFresponsee readOBJFCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFdata chunk = { 0, };
+  long long int i, nnz, chunkcap;
+
+  res = CBF_fgets(pFile, linecount);
+
   if (res == CBF_RES_OK)
-    if (sscanf(CBF_LINE_BUFFER, "%lli", &data->objfnnz) != 1)
+    if (sscanf(CBF_LINE_BUFFER, "%lli", &nnz) != 1)
       res = CBF_RES_ERR;
 
   if (res == CBF_RES_OK)
-    if (data->objfnnz < 0)
+    if (nnz < 0)
       res = CBF_RES_ERR;
 
+  if (res == CBF_RES_OK)
+    res = stream->blockbegin(stream->userdata, CBF_BLOCK_OBJFCOORD, nnz);
+
   if (res == CBF_RES_OK) {
-    data->objfsubj = (int*) calloc(data->objfnnz, sizeof(data->objfsubj[0]));
-    data->objfsubk = (int*) calloc(data->objfnnz, sizeof(data->objfsubk[0]));
-    data->objfsubl = (int*) calloc(data->objfnnz, sizeof(data->objfsubl[0]));
-    data->objfval  = (double*) calloc(data->objfnnz, sizeof(data->objfval[0]));
+    chunkcap = (nnz < CBF_STREAM_CHUNK) ? nnz : CBF_STREAM_CHUNK;
+    chunk.objfsubj = (int*) calloc(chunkcap, sizeof(chunk.objfsubj[0]));
+    chunk.objfsubk = (int*) calloc(chunkcap, sizeof(chunk.objfsubk[0]));
+    chunk.objfsubl = (int*) calloc(chunkcap, sizeof(chunk.objfsubl[0]));
+    chunk.objfval  = (double*) calloc(chunkcap, sizeof(chunk.objfval[0]));
+
+    if (chunkcap >= 1 && (!chunk.objfsubj || !chunk.objfsubk || !chunk.objfsubl || !chunk.objfval))
+      res = CBF_RES_ERR;
   }
 
-  for (i=0; i<(data->objfnnz) && res==CBF_RES_OK; ++i) {
+  for (i=0; i<nnz && res==CBF_RES_OK; ++i) {
     res = CBF_fgets(pFile, linecount);
 
     if (res == CBF_RES_OK)
-      if (sscanf(CBF_LINE_BUFFER, "%i %i %i %lg", &data->objfsubj[i], &data->objfsubk[i], &data->objfsubl[i], &data->objfval[i]) != 4)
+      if (sscanf(CBF_LINE_BUFFER, "%i %i %i %lg", &chunk.objfsubj[chunk.objfnnz], &chunk.objfsubk[chunk.objfnnz], &chunk.objfsubl[chunk.objfnnz], &chunk.objfval[chunk.objfnnz]) != 4)
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->objfsubj[i]) < 0 || (data->psdvarnum-1) < (data->objfsubj[i]) )
+      if ( (chunk.objfsubj[chunk.objfnnz]) < 0 || (data->psdvarnum-1) < (chunk.objfsubj[chunk.objfnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->objfsubk[i]) < 0 || (data->psdvardim[data->objfsubj[i]]-1) < (data->objfsubk[i]) )
+      if ( (chunk.objfsubk[chunk.objfnnz]) < 0 || (data->psdvardim[chunk.objfsubj[chunk.objfnnz]]-1) < (chunk.objfsubk[chunk.objfnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->objfsubl[i]) < 0 || (data->psdvardim[data->objfsubj[i]]-1) < (data->objfsubl[i]) )
+      if ( (chunk.objfsubl[chunk.objfnnz]) < 0 || (data->psdvardim[chunk.objfsubj[chunk.objfnnz]]-1) < (chunk.objfsubl[chunk.objfnnz]) )
         res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK) {
+      if (++chunk.objfnnz == chunkcap || i == nnz-1) {
+        res = stream->blockchunk(stream->userdata, CBF_BLOCK_OBJFCOORD, &chunk);
+        chunk.objfnnz = 0;
+      }
+    }
   }
 
+  if (res == CBF_RES_OK)
+    res = stream->blockend(stream->userdata, CBF_BLOCK_OBJFCOORD);
+
+  free(chunk.objfsubj);
+  free(chunk.objfsubk);
+  free(chunk.objfsubl);
+  free(chunk.objfval);
+
   return res;
 }
 
-static CBFresponsee readOBJACOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data)
+static CBFresponsee readOBJACOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream)
 {
   CBFresponsee res = CBF_RES_OK;
-  long long int i;
+  CBFdata chunk = { 0, };
+  long long int i, nnz, chunkcap;
 
   res = CBF_fgets(pFile, linecount);
 
   if (res == CBF_RES_OK)
-    if (sscanf(CBF_LINE_BUFFER, "%lli", &data->objannz) != 1)
+    if (sscanf(CBF_LINE_BUFFER, "%lli", &nnz) != 1)
       res = CBF_RES_ERR;
 
   if (res == CBF_RES_OK)
-    if (data->objannz < 0)
+    if (nnz < 0)
       res = CBF_RES_ERR;
 
+  if (res == CBF_RES_OK)
+    res = stream->blockbegin(stream->userdata, CBF_BLOCK_OBJACOORD, nnz);
+
   if (res == CBF_RES_OK) {
-    data->objasubj = (long long int*) calloc(data->objannz, sizeof(data->objasubj[0]));
-    data->objaval  = (double*) calloc(data->objannz, sizeof(data->objaval[0]));
+    chunkcap = (nnz < CBF_STREAM_CHUNK) ? nnz : CBF_STREAM_CHUNK;
+    chunk.objasubj = (long long int*) calloc(chunkcap, sizeof(chunk.objasubj[0]));
+    chunk.objaval  = (double*) calloc(chunkcap, sizeof(chunk.objaval[0]));
+
+    if (chunkcap >= 1 && (!chunk.objasubj || !chunk.objaval))
+      res = CBF_RES_ERR;
   }
 
-  for (i=0; i<(data->objannz) && res==CBF_RES_OK; ++i) {
+  for (i=0; i<nnz && res==CBF_RES_OK; ++i) {
     res = CBF_fgets(pFile, linecount);
 
     if (res == CBF_RES_OK)
-      if (sscanf(CBF_LINE_BUFFER, "%lli %lg", &data->objasubj[i], &data->objaval[i]) != 2)
+      if (sscanf(CBF_LINE_BUFFER, "%lli %lg", &chunk.objasubj[chunk.objannz], &chunk.objaval[chunk.objannz]) != 2)
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->objasubj[i]) < 0 || (data->varnum-1) < (data->objasubj[i]) )
+      if ( (chunk.objasubj[chunk.objannz]) < 0 || (data->varnum-1) < (chunk.objasubj[chunk.objannz]) )
         res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK) {
+      if (++chunk.objannz == chunkcap || i == nnz-1) {
+        res = stream->blockchunk(stream->userdata, CBF_BLOCK_OBJACOORD, &chunk);
+        chunk.objannz = 0;
+      }
+    }
   }
 
+  if (res == CBF_RES_OK)
+    res = stream->blockend(stream->userdata, CBF_BLOCK_OBJACOORD);
+
+  free(chunk.objasubj);
+  free(chunk.objaval);
+
   return res;
 }
 
-static CBFresponsee readOBJBCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data)
+static CBFresponsee readOBJBCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream)
 {
   CBFresponsee res = CBF_RES_OK;
+  CBFdata chunk = { 0, };
 
   res = CBF_fgets(pFile, linecount);
 
   if (res == CBF_RES_OK)
-    if (sscanf(CBF_LINE_BUFFER, "%lg", &data->objbval) != 1)
+    if (sscanf(CBF_LINE_BUFFER, "%lg", &chunk.objbval) != 1)
       res = CBF_RES_ERR;
 
+  if (res == CBF_RES_OK)
+    res = stream->blockbegin(stream->userdata, CBF_BLOCK_OBJBCOORD, 1);
+
+  if (res == CBF_RES_OK)
+    res = stream->blockchunk(stream->userdata, CBF_BLOCK_OBJBCOORD, &chunk);
+
+  if (res == CBF_RES_OK)
+    res = stream->blockend(stream->userdata, CBF_BLOCK_OBJBCOORD);
+
   return res;
 }
 
-static CBFresponsee readFCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data)
+static CBFresponsee readFCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream)
 {
   CBFresponsee res = CBF_RES_OK;
-  long long int i;
+  CBFdata chunk = { 0, };
+  long long int i, nnz, chunkcap;
 
   res = CBF_fgets(pFile, linecount);
 
   if (res == CBF_RES_OK)
-    if (sscanf(CBF_LINE_BUFFER, "%lli", &data->fnnz) != 1)
+    if (sscanf(CBF_LINE_BUFFER, "%lli", &nnz) != 1)
       res = CBF_RES_ERR;
 
   if (res == CBF_RES_OK)
-    if (data->fnnz < 0)
+    if (nnz < 0)
       res = CBF_RES_ERR;
 
+  if (res == CBF_RES_OK)
+    res = stream->blockbegin(stream->userdata, CBF_BLOCK_FCOORD, nnz);
+
   if (res == CBF_RES_OK) {
-    data->fsubi = (long long int*) calloc(data->fnnz, sizeof(data->fsubi[0]));
-    data->fsubj = (int*) calloc(data->fnnz, sizeof(data->fsubj[0]));
-    data->fsubk = (int*) calloc(data->fnnz, sizeof(data->fsubk[0]));
-    data->fsubl = (int*) calloc(data->fnnz, sizeof(data->fsubl[0]));
-    data->fval  = (double*) calloc(data->fnnz, sizeof(data->fval[0]));
+    chunkcap = (nnz < CBF_STREAM_CHUNK) ? nnz : CBF_STREAM_CHUNK;
+    chunk.fsubi = (long long int*) calloc(chunkcap, sizeof(chunk.fsubi[0]));
+    chunk.fsubj = (int*) calloc(chunkcap, sizeof(chunk.fsubj[0]));
+    chunk.fsubk = (int*) calloc(chunkcap, sizeof(chunk.fsubk[0]));
+    chunk.fsubl = (int*) calloc(chunkcap, sizeof(chunk.fsubl[0]));
+    chunk.fval  = (double*) calloc(chunkcap, sizeof(chunk.fval[0]));
+
+    if (chunkcap >= 1 && (!chunk.fsubi || !chunk.fsubj || !chunk.fsubk || !chunk.fsubl || !chunk.fval))
+      res = CBF_RES_ERR;
   }
 
-  for (i=0; i<(data->fnnz) && res==CBF_RES_OK; ++i) {
+  for (i=0; i<nnz && res==CBF_RES_OK; ++i) {
     res = CBF_fgets(pFile, linecount);
 
     if (res == CBF_RES_OK)
-      if (sscanf(CBF_LINE_BUFFER, "%lli %i %i %i %lg", &data->fsubi[i], &data->fsubj[i], &data->fsubk[i], &data->fsubl[i], &data->fval[i]) != 5)
+      if (sscanf(CBF_LINE_BUFFER, "%lli %i %i %i %lg", &chunk.fsubi[chunk.fnnz], &chunk.fsubj[chunk.fnnz], &chunk.fsubk[chunk.fnnz], &chunk.fsubl[chunk.fnnz], &chunk.fval[chunk.fnnz]) != 5)
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->fsubi[i]) < 0 || (data->mapnum-1) < (data->fsubi[i]) )
+      if ( (chunk.fsubi[chunk.fnnz]) < 0 || (data->mapnum-1) < (chunk.fsubi[chunk.fnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->fsubj[i]) < 0 || (data->psdvarnum-1) < (data->fsubj[i]) )
+      if ( (chunk.fsubj[chunk.fnnz]) < 0 || (data->psdvarnum-1) < (chunk.fsubj[chunk.fnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->fsubk[i]) < 0 || (data->psdvardim[data->fsubj[i]]-1) < (data->fsubk[i]) )
+      if ( (chunk.fsubk[chunk.fnnz]) < 0 || (data->psdvardim[chunk.fsubj[chunk.fnnz]]-1) < (chunk.fsubk[chunk.fnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->fsubl[i]) < 0 || (data->psdvardim[data->fsubj[i]]-1) < (data->fsubl[i]) )
+      if ( (chunk.fsubl[chunk.fnnz]) < 0 || (data->psdvardim[chunk.fsubj[chunk.fnnz]]-1) < (chunk.fsubl[chunk.fnnz]) )
         res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK) {
+      if (++chunk.fnnz == chunkcap || i == nnz-1) {
+        res = stream->blockchunk(stream->userdata, CBF_BLOCK_FCOORD, &chunk);
+        chunk.fnnz = 0;
+      }
+    }
   }
 
+  if (res == CBF_RES_OK)
+    res = stream->blockend(stream->userdata, CBF_BLOCK_FCOORD);
+
+  free(chunk.fsubi);
+  free(chunk.fsubj);
+  free(chunk.fsubk);
+  free(chunk.fsubl);
+  free(chunk.fval);
+
   return res;
 }
 
-static CBFresponsee readACOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data)
+static CBFresponsee readACOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream)
 {
   CBFresponsee res = CBF_RES_OK;
-  long long int i;
+  CBFdata chunk = { 0, };
+  long long int i, nnz, chunkcap;
 
   res = CBF_fgets(pFile, linecount);
 
   if (res == CBF_RES_OK)
-    if (sscanf(CBF_LINE_BUFFER, "%lli", &data->annz) != 1)
+    if (sscanf(CBF_LINE_BUFFER, "%lli", &nnz) != 1)
       res = CBF_RES_ERR;
 
   if (res == CBF_RES_OK)
-    if (data->annz < 0)
+    if (nnz < 0)
       res = CBF_RES_ERR;
 
+  if (res == CBF_RES_OK)
+    res = stream->blockbegin(stream->userdata, CBF_BLOCK_ACOORD, nnz);
+
   if (res == CBF_RES_OK) {
-    data->asubi = (long long int*) calloc(data->annz, sizeof(data->asubi[0]));
-    data->asubj = (long long int*) calloc(data->annz, sizeof(data->asubj[0]));
-    data->aval  = (double*) calloc(data->annz, sizeof(data->aval[0]));
+    chunkcap = (nnz < CBF_STREAM_CHUNK) ? nnz : CBF_STREAM_CHUNK;
+    chunk.asubi = (long long int*) calloc(chunkcap, sizeof(chunk.asubi[0]));
+    chunk.asubj = (long long int*) calloc(chunkcap, sizeof(chunk.asubj[0]));
+    chunk.aval  = (double*) calloc(chunkcap, sizeof(chunk.aval[0]));
+
+    if (chunkcap >= 1 && (!chunk.asubi || !chunk.asubj || !chunk.aval))
+      res = CBF_RES_ERR;
   }
 
-  for (i=0; i<(data->annz) && res==CBF_RES_OK; ++i) {
+  for (i=0; i<nnz && res==CBF_RES_OK; ++i) {
     res = CBF_fgets(pFile, linecount);
 
     if (res == CBF_RES_OK)
-      if (sscanf(CBF_LINE_BUFFER, "%lli %lli %lg", &data->asubi[i], &data->asubj[i], &data->aval[i]) != 3)
+      if (sscanf(CBF_LINE_BUFFER, "%lli %lli %lg", &chunk.asubi[chunk.annz], &chunk.asubj[chunk.annz], &chunk.aval[chunk.annz]) != 3)
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->asubi[i]) < 0 || (data->mapnum-1) < (data->asubi[i]) )
+      if ( (chunk.asubi[chunk.annz]) < 0 || (data->mapnum-1) < (chunk.asubi[chunk.annz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->asubj[i]) < 0 || (data->varnum-1) < (data->asubj[i]) )
+      if ( (chunk.asubj[chunk.annz]) < 0 || (data->varnum-1) < (chunk.asubj[chunk.annz]) )
         res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK) {
+      if (++chunk.annz == chunkcap || i == nnz-1) {
+        res = stream->blockchunk(stream->userdata, CBF_BLOCK_ACOORD, &chunk);
+        chunk.annz = 0;
+      }
+    }
   }
 
+  if (res == CBF_RES_OK)
+    res = stream->blockend(stream->userdata, CBF_BLOCK_ACOORD);
+
+  free(chunk.asubi);
+  free(chunk.asubj);
+  free(chunk.aval);
+
   return res;
 }
 
-static CBFresponsee readBCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data)
+static CBFresponsee readBCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream)
 {
   CBFresponsee res = CBF_RES_OK;
-  long long int i;
+  CBFdata chunk = { 0, };
+  long long int i, nnz, chunkcap;
 
   res = CBF_fgets(pFile, linecount);
 
   if (res == CBF_RES_OK)
-    if (sscanf(CBF_LINE_BUFFER, "%lli", &data->bnnz) != 1)
+    if (sscanf(CBF_LINE_BUFFER, "%lli", &nnz) != 1)
       res = CBF_RES_ERR;
 
   if (res == CBF_RES_OK)
-    if (data->bnnz < 0)
+    if (nnz < 0)
       res = CBF_RES_ERR;
 
+  if (res == CBF_RES_OK)
+    res = stream->blockbegin(stream->userdata, CBF_BLOCK_BCOORD, nnz);
+
   if (res == CBF_RES_OK) {
-    data->bsubi = (long long int*) calloc(data->bnnz, sizeof(data->bsubi[0]));
-    data->bval  = (double*) calloc(data->bnnz, sizeof(data->bval[0]));
+    chunkcap = (nnz < CBF_STREAM_CHUNK) ? nnz : CBF_STREAM_CHUNK;
+    chunk.bsubi = (long long int*) calloc(chunkcap, sizeof(chunk.bsubi[0]));
+    chunk.bval  = (double*) calloc(chunkcap, sizeof(chunk.bval[0]));
+
+    if (chunkcap >= 1 && (!chunk.bsubi || !chunk.bval))
+      res = CBF_RES_ERR;
   }
 
-  for (i=0; i<(data->bnnz) && res==CBF_RES_OK; ++i) {
+  for (i=0; i<nnz && res==CBF_RES_OK; ++i) {
     res = CBF_fgets(pFile, linecount);
 
     if (res == CBF_RES_OK)
-      if (sscanf(CBF_LINE_BUFFER, "%lli %lg", &data->bsubi[i], &data->bval[i]) != 2)
+      if (sscanf(CBF_LINE_BUFFER, "%lli %lg", &chunk.bsubi[chunk.bnnz], &chunk.bval[chunk.bnnz]) != 2)
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->bsubi[i]) < 0 || (data->mapnum-1) < (data->bsubi[i]) )
+      if ( (chunk.bsubi[chunk.bnnz]) < 0 || (data->mapnum-1) < (chunk.bsubi[chunk.bnnz]) )
         res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK) {
+      if (++chunk.bnnz == chunkcap || i == nnz-1) {
+        res = stream->blockchunk(stream->userdata, CBF_BLOCK_BCOORD, &chunk);
+        chunk.bnnz = 0;
+      }
+    }
   }
 
+  if (res == CBF_RES_OK)
+    res = stream->blockend(stream->userdata, CBF_BLOCK_BCOORD);
+
+  free(chunk.bsubi);
+  free(chunk.bval);
+
   return res;
 }
 
-static CBFresponsee readHCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data)
+static CBFresponsee readHCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream)
 {
   CBFresponsee res = CBF_RES_OK;
-  long long int i;
+  CBFdata chunk = { 0, };
+  long long int i, nnz, chunkcap;
 
   res = CBF_fgets(pFile, linecount);
 
   if (res == CBF_RES_OK)
-    if (sscanf(CBF_LINE_BUFFER, "%lli", &data->hnnz) != 1)
+    if (sscanf(CBF_LINE_BUFFER, "%lli", &nnz) != 1)
       res = CBF_RES_ERR;
 
   if (res == CBF_RES_OK)
-    if (data->hnnz < 0)
+    if (nnz < 0)
       res = CBF_RES_ERR;
 
+  if (res == CBF_RES_OK)
+    res = stream->blockbegin(stream->userdata, CBF_BLOCK_HCOORD, nnz);
+
   if (res == CBF_RES_OK) {
-    data->hsubi = (int*) calloc(data->hnnz, sizeof(data->hsubi[0]));
-    data->hsubj = (long long int*) calloc(data->hnnz, sizeof(data->hsubj[0]));
-    data->hsubk = (int*) calloc(data->hnnz, sizeof(data->hsubk[0]));
-    data->hsubl = (int*) calloc(data->hnnz, sizeof(data->hsubl[0]));
-    data->hval  = (double*) calloc(data->hnnz, sizeof(data->hval[0]));
+    chunkcap = (nnz < CBF_STREAM_CHUNK) ? nnz : CBF_STREAM_CHUNK;
+    chunk.hsubi = (int*) calloc(chunkcap, sizeof(chunk.hsubi[0]));
+    chunk.hsubj = (long long int*) calloc(chunkcap, sizeof(chunk.hsubj[0]));
+    chunk.hsubk = (int*) calloc(chunkcap, sizeof(chunk.hsubk[0]));
+    chunk.hsubl = (int*) calloc(chunkcap, sizeof(chunk.hsubl[0]));
+    chunk.hval  = (double*) calloc(chunkcap, sizeof(chunk.hval[0]));
+
+    if (chunkcap >= 1 && (!chunk.hsubi || !chunk.hsubj || !chunk.hsubk || !chunk.hsubl || !chunk.hval))
+      res = CBF_RES_ERR;
   }
 
-  for (i=0; i<(data->hnnz) && res==CBF_RES_OK; ++i) {
+  for (i=0; i<nnz && res==CBF_RES_OK; ++i) {
     res = CBF_fgets(pFile, linecount);
 
     if (res == CBF_RES_OK)
-      if (sscanf(CBF_LINE_BUFFER, "%i %lli %i %i %lg", &data->hsubi[i], &data->hsubj[i], &data->hsubk[i], &data->hsubl[i], &data->hval[i]) != 5)
+      if (sscanf(CBF_LINE_BUFFER, "%i %lli %i %i %lg", &chunk.hsubi[chunk.hnnz], &chunk.hsubj[chunk.hnnz], &chunk.hsubk[chunk.hnnz], &chunk.hsubl[chunk.hnnz], &chunk.hval[chunk.hnnz]) != 5)
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->hsubi[i]) < 0 || (data->psdmapnum-1) < (data->hsubi[i]) )
+      if ( (chunk.hsubi[chunk.hnnz]) < 0 || (data->psdmapnum-1) < (chunk.hsubi[chunk.hnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->hsubj[i]) < 0 || (data->varnum-1) < (data->hsubj[i]) )
+      if ( (chunk.hsubj[chunk.hnnz]) < 0 || (data->varnum-1) < (chunk.hsubj[chunk.hnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->hsubk[i]) < 0 || (data->psdmapdim[data->hsubi[i]]-1) < (data->hsubk[i]) )
+      if ( (chunk.hsubk[chunk.hnnz]) < 0 || (data->psdmapdim[chunk.hsubi[chunk.hnnz]]-1) < (chunk.hsubk[chunk.hnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->hsubl[i]) < 0 || (data->psdmapdim[data->hsubi[i]]-1) < (data->hsubl[i]) )
+      if ( (chunk.hsubl[chunk.hnnz]) < 0 || (data->psdmapdim[chunk.hsubi[chunk.hnnz]]-1) < (chunk.hsubl[chunk.hnnz]) )
         res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK) {
+      if (++chunk.hnnz == chunkcap || i == nnz-1) {
+        res = stream->blockchunk(stream->userdata, CBF_BLOCK_HCOORD, &chunk);
+        chunk.hnnz = 0;
+      }
+    }
   }
 
+  if (res == CBF_RES_OK)
+    res = stream->blockend(stream->userdata, CBF_BLOCK_HCOORD);
+
+  free(chunk.hsubi);
+  free(chunk.hsubj);
+  free(chunk.hsubk);
+  free(chunk.hsubl);
+  free(chunk.hval);
+
   return res;
 }
 
-static CBFresponsee readDCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data)
+static CBFresponsee readDCOORD(CBFFILE *pFile, long long int *linecount, CBFdata *data, CBFstream *stream)
 {
   CBFresponsee res = CBF_RES_OK;
-  long long int i;
+  CBFdata chunk = { 0, };
+  long long int i, nnz, chunkcap;
 
   res = CBF_fgets(pFile, linecount);
 
   if (res == CBF_RES_OK)
-    if (sscanf(CBF_LINE_BUFFER, "%lli", &data->dnnz) != 1)
+    if (sscanf(CBF_LINE_BUFFER, "%lli", &nnz) != 1)
       res = CBF_RES_ERR;
 
   if (res == CBF_RES_OK)
-    if (data->dnnz < 0)
+    if (nnz < 0)
       res = CBF_RES_ERR;
 
+  if (res == CBF_RES_OK)
+    res = stream->blockbegin(stream->userdata, CBF_BLOCK_DCOORD, nnz);
+
   if (res == CBF_RES_OK) {
-    data->dsubi = (int*) calloc(data->dnnz, sizeof(data->dsubi[0]));
-    data->dsubk = (int*) calloc(data->dnnz, sizeof(data->dsubk[0]));
-    data->dsubl = (int*) calloc(data->dnnz, sizeof(data->dsubl[0]));
-    data->dval  = (double*) calloc(data->dnnz, sizeof(data->dval[0]));
+    chunkcap = (nnz < CBF_STREAM_CHUNK) ? nnz : CBF_STREAM_CHUNK;
+    chunk.dsubi = (int*) calloc(chunkcap, sizeof(chunk.dsubi[0]));
+    chunk.dsubk = (int*) calloc(chunkcap, sizeof(chunk.dsubk[0]));
+    chunk.dsubl = (int*) calloc(chunkcap, sizeof(chunk.dsubl[0]));
+    chunk.dval  = (double*) calloc(chunkcap, sizeof(chunk.dval[0]));
+
+    if (chunkcap >= 1 && (!chunk.dsubi || !chunk.dsubk || !chunk.dsubl || !chunk.dval))
+      res = CBF_RES_ERR;
   }
 
-  for (i=0; i<(data->dnnz) && res==CBF_RES_OK; ++i) {
+  for (i=0; i<nnz && res==CBF_RES_OK; ++i) {
     res = CBF_fgets(pFile, linecount);
 
     if (res == CBF_RES_OK)
-      if (sscanf(CBF_LINE_BUFFER, "%i %i %i %lg", &data->dsubi[i], &data->dsubk[i], &data->dsubl[i], &data->dval[i]) != 4)
+      if (sscanf(CBF_LINE_BUFFER, "%i %i %i %lg", &chunk.dsubi[chunk.dnnz], &chunk.dsubk[chunk.dnnz], &chunk.dsubl[chunk.dnnz], &chunk.dval[chunk.dnnz]) != 4)
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->dsubi[i]) < 0 || (data->psdmapnum-1) < (data->dsubi[i]) )
+      if ( (chunk.dsubi[chunk.dnnz]) < 0 || (data->psdmapnum-1) < (chunk.dsubi[chunk.dnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->dsubk[i]) < 0 || (data->psdmapdim[data->dsubi[i]]-1) < (data->dsubk[i]) )
+      if ( (chunk.dsubk[chunk.dnnz]) < 0 || (data->psdmapdim[chunk.dsubi[chunk.dnnz]]-1) < (chunk.dsubk[chunk.dnnz]) )
         res = CBF_RES_ERR;
 
     if (res == CBF_RES_OK)
-      if ( (data->dsubl[i]) < 0 || (data->psdmapdim[data->dsubi[i]]-1) < (data->dsubl[i]) )
+      if ( (chunk.dsubl[chunk.dnnz]) < 0 || (data->psdmapdim[chunk.dsubi[chunk.dnnz]]-1) < (chunk.dsubl[chunk.dnnz]) )
         res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK) {
+      if (++chunk.dnnz == chunkcap || i == nnz-1) {
+        res = stream->blockchunk(stream->userdata, CBF_BLOCK_DCOORD, &chunk);
+        chunk.dnnz = 0;
+      }
+    }
   }
 
+  if (res == CBF_RES_OK)
+    res = stream->blockend(stream->userdata, CBF_BLOCK_DCOORD);
+
+  free(chunk.dsubi);
+  free(chunk.dsubk);
+  free(chunk.dsubl);
+  free(chunk.dval);
+
   return res;
 }
 
+static CBFresponsee collect_structure(void *userdata, CBFdata *data)
+{
+  // Structural information is parsed directly into the collected data
+  return CBF_RES_OK;
+}
+
+static CBFresponsee collect_blockbegin(void *userdata, CBFblocke block, long long int nnz)
+{
+  CBFcollector *collector = (CBFcollector*) userdata;
+  CBFdata *data = collector->data;
+  int isalloc = 1;
+
+  collector->nnz = 0;
+
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:
+    if (nnz >= 1) {
+      data->objfnnz  = nnz;
+      data->objfsubj = (int*) calloc(nnz, sizeof(data->objfsubj[0]));
+      data->objfsubk = (int*) calloc(nnz, sizeof(data->objfsubk[0]));
+      data->objfsubl = (int*) calloc(nnz, sizeof(data->objfsubl[0]));
+      data->objfval  = (double*) calloc(nnz, sizeof(data->objfval[0]));
+      isalloc = (data->objfsubj && data->objfsubk && data->objfsubl && data->objfval);
+    }
+    break;
+
+  case CBF_BLOCK_OBJACOORD:
+    if (nnz >= 1) {
+      data->objannz  = nnz;
+      data->objasubj = (long long int*) calloc(nnz, sizeof(data->objasubj[0]));
+      data->objaval  = (double*) calloc(nnz, sizeof(data->objaval[0]));
+      isalloc = (data->objasubj && data->objaval);
+    }
+    break;
+
+  case CBF_BLOCK_OBJBCOORD:
+    break;
+
+  case CBF_BLOCK_FCOORD:
+    if (nnz >= 1) {
+      data->fnnz  = nnz;
+      data->fsubi = (long long int*) calloc(nnz, sizeof(data->fsubi[0]));
+      data->fsubj = (int*) calloc(nnz, sizeof(data->fsubj[0]));
+      data->fsubk = (int*) calloc(nnz, sizeof(data->fsubk[0]));
+      data->fsubl = (int*) calloc(nnz, sizeof(data->fsubl[0]));
+      data->fval  = (double*) calloc(nnz, sizeof(data->fval[0]));
+      isalloc = (data->fsubi && data->fsubj && data->fsubk && data->fsubl && data->fval);
+    }
+    break;
+
+  case CBF_BLOCK_ACOORD:
+    if (nnz >= 1) {
+      data->annz  = nnz;
+      data->asubi = (long long int*) calloc(nnz, sizeof(data->asubi[0]));
+      data->asubj = (long long int*) calloc(nnz, sizeof(data->asubj[0]));
+      data->aval  = (double*) calloc(nnz, sizeof(data->aval[0]));
+      isalloc = (data->asubi && data->asubj && data->aval);
+    }
+    break;
+
+  case CBF_BLOCK_BCOORD:
+    if (nnz >= 1) {
+      data->bnnz  = nnz;
+      data->bsubi = (long long int*) calloc(nnz, sizeof(data->bsubi[0]));
+      data->bval  = (double*) calloc(nnz, sizeof(data->bval[0]));
+      isalloc = (data->bsubi && data->bval);
+    }
+    break;
+
+  case CBF_BLOCK_HCOORD:
+    if (nnz >= 1) {
+      data->hnnz  = nnz;
+      data->hsubi = (int*) calloc(nnz, sizeof(data->hsubi[0]));
+      data->hsubj = (long long int*) calloc(nnz, sizeof(data->hsubj[0]));
+      data->hsubk = (int*) calloc(nnz, sizeof(data->hsubk[0]));
+      data->hsubl = (int*) calloc(nnz, sizeof(data->hsubl[0]));
+      data->hval  = (double*) calloc(nnz, sizeof(data->hval[0]));
+      isalloc = (data->hsubi && data->hsubj && data->hsubk && data->hsubl && data->hval);
+    }
+    break;
+
+  case CBF_BLOCK_DCOORD:
+    if (nnz >= 1) {
+      data->dnnz  = nnz;
+      data->dsubi = (int*) calloc(nnz, sizeof(data->dsubi[0]));
+      data->dsubk = (int*) calloc(nnz, sizeof(data->dsubk[0]));
+      data->dsubl = (int*) calloc(nnz, sizeof(data->dsubl[0]));
+      data->dval  = (double*) calloc(nnz, sizeof(data->dval[0]));
+      isalloc = (data->dsubi && data->dsubk && data->dsubl && data->dval);
+    }
+    break;
+
+  default:
+    return CBF_RES_ERR;
+  }
+
+  return isalloc ? CBF_RES_OK : CBF_RES_ERR;
+}
+
+static CBFresponsee collect_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk)
+{
+  CBFcollector *collector = (CBFcollector*) userdata;
+  CBFdata *data = collector->data;
+  long long int k = collector->nnz;
+  long long int n;
+
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:
+    n = chunk->objfnnz;
+    memcpy(data->objfsubj + k, chunk->objfsubj, n * sizeof(data->objfsubj[0]));
+    memcpy(data->objfsubk + k, chunk->objfsubk, n * sizeof(data->objfsubk[0]));
+    memcpy(data->objfsubl + k, chunk->objfsubl, n * sizeof(data->objfsubl[0]));
+    memcpy(data->objfval  + k, chunk->objfval,  n * sizeof(data->objfval[0]));
+    break;
+
+  case CBF_BLOCK_OBJACOORD:
+    n = chunk->objannz;
+    memcpy(data->objasubj + k, chunk->objasubj, n * sizeof(data->objasubj[0]));
+    memcpy(data->objaval  + k, chunk->objaval,  n * sizeof(data->objaval[0]));
+    break;
+
+  case CBF_BLOCK_OBJBCOORD:
+    n = 1;
+    data->objbval = chunk->objbval;
+    break;
+
+  case CBF_BLOCK_FCOORD:
+    n = chunk->fnnz;
+    memcpy(data->fsubi + k, chunk->fsubi, n * sizeof(data->fsubi[0]));
+    memcpy(data->fsubj + k, chunk->fsubj, n * sizeof(data->fsubj[0]));
+    memcpy(data->fsubk + k, chunk->fsubk, n * sizeof(data->fsubk[0]));
+    memcpy(data->fsubl + k, chunk->fsubl, n * sizeof(data->fsubl[0]));
+    memcpy(data->fval  + k, chunk->fval,  n * sizeof(data->fval[0]));
+    break;
+
+  case CBF_BLOCK_ACOORD:
+    n = chunk->annz;
+    memcpy(data->asubi + k, chunk->asubi, n * sizeof(data->asubi[0]));
+    memcpy(data->asubj + k, chunk->asubj, n * sizeof(data->asubj[0]));
+    memcpy(data->aval  + k, chunk->aval,  n * sizeof(data->aval[0]));
+    break;
+
+  case CBF_BLOCK_BCOORD:
+    n = chunk->bnnz;
+    memcpy(data->bsubi + k, chunk->bsubi, n * sizeof(data->bsubi[0]));
+    memcpy(data->bval  + k, chunk->bval,  n * sizeof(data->bval[0]));
+    break;
+
+  case CBF_BLOCK_HCOORD:
+    n = chunk->hnnz;
+    memcpy(data->hsubi + k, chunk->hsubi, n * sizeof(data->hsubi[0]));
+    memcpy(data->hsubj + k, chunk->hsubj, n * sizeof(data->hsubj[0]));
+    memcpy(data->hsubk + k, chunk->hsubk, n * sizeof(data->hsubk[0]));
+    memcpy(data->hsubl + k, chunk->hsubl, n * sizeof(data->hsubl[0]));
+    memcpy(data->hval  + k, chunk->hval,  n * sizeof(data->hval[0]));
+    break;
+
+  case CBF_BLOCK_DCOORD:
+    n = chunk->dnnz;
+    memcpy(data->dsubi + k, chunk->dsubi, n * sizeof(data->dsubi[0]));
+    memcpy(data->dsubk + k, chunk->dsubk, n * sizeof(data->dsubk[0]));
+    memcpy(data->dsubl + k, chunk->dsubl, n * sizeof(data->dsubl[0]));
+    memcpy(data->dval  + k, chunk->dval,  n * sizeof(data->dval[0]));
+    break;
+
+  default:
+    return CBF_RES_ERR;
+  }
+
+  collector->nnz += n;
+  return CBF_RES_OK;
+}
+
+static CBFresponsee collect_blockend(void *userdata, CBFblocke block)
+{
+  return CBF_RES_OK;
+}
+
+static CBFresponsee handler_structure(void *userdata, CBFdata *data)
+{
+  const CBFhandler *handler = (const CBFhandler*) userdata;
+
+  if (!handler->on_structure)
+    return CBF_RES_OK;
+
+  return handler->on_structure(handler->userdata, data);
+}
+
+static CBFresponsee handler_blockbegin(void *userdata, CBFblocke block, long long int nnz)
+{
+  const CBFhandler *handler = (const CBFhandler*) userdata;
+
+  if (!handler->on_blockbegin)
+    return CBF_RES_OK;
+
+  return handler->on_blockbegin(handler->userdata, block, nnz);
+}
+
+static CBFresponsee handler_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk)
+{
+  const CBFhandler *handler = (const CBFhandler*) userdata;
+  void *u = handler->userdata;
+
+  switch (block) {
+  case CBF_BLOCK_OBJFCOORD:
+    if (handler->on_objfcoord)
+      return handler->on_objfcoord(u, chunk->objfsubj, chunk->objfsubk, chunk->objfsubl, chunk->objfval, chunk->objfnnz);
+    break;
+
+  case CBF_BLOCK_OBJACOORD:
+    if (handler->on_objacoord)
+      return handler->on_objacoord(u, chunk->objasubj, chunk->objaval, chunk->objannz);
+    break;
+
+  case CBF_BLOCK_OBJBCOORD:
+    if (handler->on_objbcoord)
+      return handler->on_objbcoord(u, chunk->objbval);
+    break;
+
+  case CBF_BLOCK_FCOORD:
+    if (handler->on_fcoord)
+      return handler->on_fcoord(u, chunk->fsubi, chunk->fsubj, chunk->fsubk, chunk->fsubl, chunk->fval, chunk->fnnz);
+    break;
+
+  case CBF_BLOCK_ACOORD:
+    if (handler->on_acoord)
+      return handler->on_acoord(u, chunk->asubi, chunk->asubj, chunk->aval, chunk->annz);
+    break;
+
+  case CBF_BLOCK_BCOORD:
+    if (handler->on_bcoord)
+      return handler->on_bcoord(u, chunk->bsubi, chunk->bval, chunk->bnnz);
+    break;
+
+  case CBF_BLOCK_HCOORD:
+    if (handler->on_hcoord)
+      return handler->on_hcoord(u, chunk->hsubi, chunk->hsubj, chunk->hsubk, chunk->hsubl, chunk->hval, chunk->hnnz);
+    break;
+
+  case CBF_BLOCK_DCOORD:
+    if (handler->on_dcoord)
+      return handler->on_dcoord(u, chunk->dsubi, chunk->dsubk, chunk->dsubl, chunk->dval, chunk->dnnz);
+    break;
+
+  default:
+    return CBF_RES_ERR;
+  }
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee handler_blockend(void *userdata, CBFblocke block)
+{
+  const CBFhandler *handler = (const CBFhandler*) userdata;
+
+  if (!handler->on_blockend)
+    return CBF_RES_OK;
+
+  return handler->on_blockend(handler->userdata, block);
+}
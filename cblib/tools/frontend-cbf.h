@@ -23,5 +23,66 @@
 
 extern CBFfrontend const frontend_cbf;
 
+
+/*
+ * Handlers for reading a CBF file without building a CBFdata structure.
+ *
+ * 'on_structure' receives all structural information before any coordinates.
+ * Coordinates are then delivered block by block, in the order of the file,
+ * as batches of at most CBF_STREAM_CHUNK entries. All arrays are owned by
+ * the reader and are only valid for the duration of the call, so handlers
+ * should copy what they need directly into their own structures.
+ *
+ * Handlers left as NULL are skipped, and a handler returning CBF_RES_ERR
+ * stops the reading.
+ */
+typedef struct CBFhandler_struct {
+
+  void *userdata;
+  CBFresponsee (*on_structure)(void *userdata, const CBFdata *data);
+  CBFresponsee (*on_blockbegin)(void *userdata, CBFblocke block, long long int nnz);
+  CBFresponsee (*on_objfcoord)(void *userdata, const int *j, const int *k, const int *l, const double *v, long long int n);
+  CBFresponsee (*on_objacoord)(void *userdata, const long long int *j, const double *v, long long int n);
+  CBFresponsee (*on_objbcoord)(void *userdata, double v);
+  CBFresponsee (*on_fcoord)(void *userdata, const long long int *i, const int *j, const int *k, const int *l, const double *v, long long int n);
+  CBFresponsee (*on_acoord)(void *userdata, const long long int *i, const long long int *j, const double *v, long long int n);
+  CBFresponsee (*on_bcoord)(void *userdata, const long long int *i, const double *v, long long int n);
+  CBFresponsee (*on_hcoord)(void *userdata, const int *i, const long long int *j, const int *k, const int *l, const double *v, long long int n);
+  CBFresponsee (*on_dcoord)(void *userdata, const int *i, const int *k, const int *l, const double *v, long long int n);
+  CBFresponsee (*on_blockend)(void *userdata, CBFblocke block);
+
+} CBFhandler;
+
+CBFresponsee CBF_readhandler(const char *file, const CBFhandler *handler);
+
+
+/*
+ * Lazy reading of a CBF file, for queries that touch only a few blocks.
+ *
+ * CBF_openlazy reads the structural information into 'data', and records
+ * where each coordinate block begins along with its number of nonzeros,
+ * passing over the coordinates without parsing them. CBF_lazyblock reads a
+ * block on first access and returns 'data', holding the coordinates of all
+ * blocks accessed so far (absent blocks are empty). Only the base problem of
+ * files with CHANGE sequences is seen.
+ */
+typedef struct CBFlazy_struct {
+
+  CBFdata data;
+  char *file;
+
+  long long int blocknnz[CBF_BLOCK_END];
+  long long int blockpos[CBF_BLOCK_END];    // Offset in the file, or -1 if absent
+  long long int blockline[CBF_BLOCK_END];
+  char isloaded[CBF_BLOCK_END];
+
+} CBFlazy;
+
+CBFresponsee CBF_openlazy(const char *file, CBFlazy *lazy);
+
+CBFresponsee CBF_lazyblock(CBFlazy *lazy, CBFblocke block, const CBFdata **data);
+
+void CBF_closelazy(CBFlazy *lazy);
+
 #endif
 
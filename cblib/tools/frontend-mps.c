@@ -0,0 +1,1072 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "frontend-mps.h"
+#include "cbf-helper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef ZLIB_SUPPORT
+typedef FILE CBFFILE;
+#define FOPEN(x,y) fopen(x,y)
+#define FCLOSE(x) fclose(x)
+#define FGETS(x,y,z) fgets(x,y,z)
+#else
+#include <zlib.h>
+typedef struct gzFile_s CBFFILE;
+#define FOPEN(x,y) gzopen(x,y)
+#define FCLOSE(x) gzclose(x)
+#define FGETS(x,y,z) gzgets(z,x,y)
+#endif
+
+#define MPS_MAX_LINE   (1 << 12)
+#define MPS_MAX_FIELD  8
+
+// Bounds of at least this magnitude are infinite
+#define MPS_INFINITY   1.0e30
+
+typedef enum MPSsection_enum {
+  MPS_SECTION_NONE,
+  MPS_SECTION_OBJSENSE,
+  MPS_SECTION_ROWS,
+  MPS_SECTION_COLUMNS,
+  MPS_SECTION_RHS,
+  MPS_SECTION_RANGES,
+  MPS_SECTION_BOUNDS,
+  MPS_SECTION_CSECTION
+} MPSsectione;
+
+typedef struct MPSreader_struct {
+  CBFFILE *pFile;
+  int isfixed;
+  long long int linecount;
+  const char *error;
+
+  char line[MPS_MAX_LINE];
+  char *field[MPS_MAX_FIELD];
+  int fieldnum;
+  int isheader;
+
+  CBFobjsensee objsense;
+
+  // Rows, of which the first N row is the objective
+  CBFnametable rows;
+  long long int rowcap;
+  char *rowtype;
+  double *rhs;
+  double *range;
+  char *isranged;
+  long long int objrow;
+
+  // Columns, with their coordinates in order of appearance (i.e., column-major)
+  CBFnametable cols;
+  long long int colcap;
+  char *isint;
+  double *lower;
+  double *upper;
+  long long int *cone;
+  long long int nnz;
+  long long int nnzcap;
+  long long int *subi;
+  long long int *subj;
+  double *val;
+
+  // Cone k holds the columns member[conebeg[k]] to member[conebeg[k+1]-1]
+  long long int conenum;
+  long long int conecap;
+  CBFscalarconee *conetype;
+  long long int *conebeg;
+  long long int membernum;
+  long long int membercap;
+  long long int *member;
+} MPSreader;
+
+static CBFresponsee
+  read(const char *file, CBFdata *data, CBFfrontendmemory *mem);
+
+static void
+  clean(CBFdata *data, CBFfrontendmemory *mem);
+
+static CBFresponsee
+  readMPS(const char *file, int isfixed, MPSreader *reader);
+
+static void
+  freereader(MPSreader *reader);
+
+static void *
+  growarray(void *arr, long long int cap, size_t size, CBFresponsee *res);
+
+static int
+  nextline(MPSreader *reader);
+
+static CBFresponsee
+  readdouble(const char *str, double *val);
+
+static CBFresponsee
+  readHEADER(MPSreader *reader, MPSsectione *section, int *isend);
+
+static CBFresponsee
+  readOBJSENSE(MPSreader *reader, const char *sense);
+
+static CBFresponsee
+  readROWS(MPSreader *reader);
+
+static CBFresponsee
+  readCOLUMNS(MPSreader *reader, int *isintsection);
+
+static CBFresponsee
+  readRHS(MPSreader *reader, int isrange);
+
+static CBFresponsee
+  readBOUNDS(MPSreader *reader);
+
+static CBFresponsee
+  readCSECTION(MPSreader *reader);
+
+static CBFresponsee
+  addname(CBFnametable *table, const char *name, const char *suffix);
+
+static CBFresponsee
+  buildNAMES(const MPSreader *reader, CBFdata *data, const long long int *perm, const CBFscalarconee *domain, const char *isnonneg);
+
+static CBFscalarconee
+  rowdomain(const MPSreader *reader, long long int i, int isrange);
+
+static void
+  boundrows(const MPSreader *reader, long long int j, CBFscalarconee domain, int isnonneg, int *islower, int *isupper);
+
+static CBFresponsee
+  buildDATA(const MPSreader *reader, CBFdyndata *dyndata);
+
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFfrontend const frontend_mps = { "mps", read, clean };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+
+static CBFresponsee read(const char *file, CBFdata *data, CBFfrontendmemory *mem)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFdyndata *dyndata = NULL;
+  MPSreader *reader = NULL, *fixedreader = NULL;
+
+  //
+  // Use CBFfrontendmemory to store the CBFdyndata wrapper of CBFdata
+  //
+  *mem = calloc(1, sizeof(*dyndata));
+  if (!*mem) {
+    return CBF_RES_ERR;
+  } else {
+    dyndata = (CBFdyndata*)*mem;
+    dyndata->data = data;
+  }
+
+  reader = (MPSreader*) calloc(1, sizeof(*reader));
+  if (!reader) {
+    clean(data, mem);
+    return CBF_RES_ERR;
+  }
+
+  //
+  // Free format is tried first, and then fixed format in which names may
+  // contain spaces. Errors are reported from whichever got the furthest.
+  //
+  res = readMPS(file, 0, reader);
+
+  if (res != CBF_RES_OK && reader->error) {
+    fixedreader = (MPSreader*) calloc(1, sizeof(*fixedreader));
+    if (fixedreader) {
+      if (readMPS(file, 1, fixedreader) == CBF_RES_OK) {
+        res = CBF_RES_OK;
+        freereader(reader);
+        free(reader);
+        reader = fixedreader;
+      } else if (fixedreader->linecount > reader->linecount) {
+        freereader(reader);
+        free(reader);
+        reader = fixedreader;
+      } else {
+        freereader(fixedreader);
+        free(fixedreader);
+      }
+    }
+  }
+
+  if (res != CBF_RES_OK && reader->error) {
+    printf("%s\n", reader->error);
+    printf("Failed to parse line: %lli\n", reader->linecount);
+  }
+
+  if (res == CBF_RES_OK)
+    res = buildDATA(reader, dyndata);
+
+  if (res != CBF_RES_OK)
+    clean(data, mem);
+
+  freereader(reader);
+  free(reader);
+
+  return res;
+}
+
+static void clean(CBFdata *data, CBFfrontendmemory *mem)
+{
+  //
+  // Names are allocated here, and all other memory by the cbf-helper module
+  //
+  if (data->varname) {
+    CBFnametable_free(data->varname);
+    free(data->varname);
+    data->varname = NULL;
+  }
+
+  if (data->mapname) {
+    CBFnametable_free(data->mapname);
+    free(data->mapname);
+    data->mapname = NULL;
+  }
+
+  if (*mem) {
+    CBFdyn_freedynamicallocations( (CBFdyndata*)*mem );
+    free(*mem);
+    *mem = NULL;
+  }
+}
+
+static CBFresponsee readMPS(const char *file, int isfixed, MPSreader *reader)
+{
+  CBFresponsee res = CBF_RES_OK;
+  MPSsectione section = MPS_SECTION_NONE;
+  int isend = 0, isintsection = 0;
+
+  reader->isfixed = isfixed;
+  reader->objsense = CBF_OBJ_MINIMIZE;
+  reader->objrow = -1;
+
+  reader->pFile = FOPEN(file, "rt");
+  if (!reader->pFile)
+    return CBF_RES_ERR;
+
+  while (res == CBF_RES_OK && !isend && nextline(reader)) {
+    if (reader->isheader) {
+      res = readHEADER(reader, &section, &isend);
+      isintsection = 0;
+      continue;
+    }
+
+    switch (section) {
+    case MPS_SECTION_OBJSENSE:
+      res = (reader->fieldnum == 1 ? readOBJSENSE(reader, reader->field[0]) : CBF_RES_ERR);
+      break;
+
+    case MPS_SECTION_ROWS:      res = readROWS(reader);                      break;
+    case MPS_SECTION_COLUMNS:   res = readCOLUMNS(reader, &isintsection);    break;
+    case MPS_SECTION_RHS:       res = readRHS(reader, 0);                    break;
+    case MPS_SECTION_RANGES:    res = readRHS(reader, 1);                    break;
+    case MPS_SECTION_BOUNDS:    res = readBOUNDS(reader);                    break;
+    case MPS_SECTION_CSECTION:  res = readCSECTION(reader);                  break;
+    default:
+      reader->error = "Data line outside of any section.";
+      res = CBF_RES_ERR;
+    }
+  }
+
+  if (res == CBF_RES_OK && !isend) {
+    if (!reader->error)
+      reader->error = "Missing ENDATA section.";
+    res = CBF_RES_ERR;
+  }
+
+  if (res != CBF_RES_OK && !reader->error)
+    reader->error = (isfixed ? "Invalid line in fixed MPS format." : "Invalid line in free MPS format.");
+
+  FCLOSE(reader->pFile);
+  reader->pFile = NULL;
+
+  return res;
+}
+
+static void freereader(MPSreader *reader)
+{
+  CBFnametable_free(&reader->rows);
+  free(reader->rowtype);
+  free(reader->rhs);
+  free(reader->range);
+  free(reader->isranged);
+
+  CBFnametable_free(&reader->cols);
+  free(reader->isint);
+  free(reader->lower);
+  free(reader->upper);
+  free(reader->cone);
+  free(reader->subi);
+  free(reader->subj);
+  free(reader->val);
+
+  free(reader->conetype);
+  free(reader->conebeg);
+  free(reader->member);
+}
+
+// Returns 'arr' resized to 'cap' elements, or unchanged with 'res' set on failure
+static void * growarray(void *arr, long long int cap, size_t size, CBFresponsee *res)
+{
+  void *buf;
+
+  if (*res != CBF_RES_OK)
+    return arr;
+
+  buf = realloc(arr, cap * size);
+  if (!buf) {
+    *res = CBF_RES_ERR;
+    return arr;
+  }
+
+  return buf;
+}
+
+// Reads the next line that is neither blank nor a comment, and splits it into fields
+static int nextline(MPSreader *reader)
+{
+  static const size_t fixedbeg[] = {1, 4, 14, 24, 39, 49};
+  char *fixed[6];
+  char *p, *end;
+  size_t len;
+  int i;
+
+  while (FGETS(reader->line, sizeof(reader->line), reader->pFile) != NULL) {
+    ++reader->linecount;
+
+    len = strlen(reader->line);
+    if (len + 1 == sizeof(reader->line) && reader->line[len-1] != '\n') {
+      reader->error = "Line is too long.";
+      return 0;
+    }
+
+    while (len >= 1 && (reader->line[len-1] == '\n' || reader->line[len-1] == '\r'))
+      reader->line[--len] = '\0';
+
+    if (reader->line[0] == '*')
+      continue;
+
+    reader->isheader = (reader->line[0] != ' ' && reader->line[0] != '\t' && reader->line[0] != '\0');
+    reader->fieldnum = 0;
+
+    if (reader->isfixed && !reader->isheader) {
+      // Fields are cut at fixed columns, and empty fields (e.g., an omitted set name) are dropped
+      for (i = 5; i >= 0; --i) {
+        fixed[i] = NULL;
+        if (fixedbeg[i] < len) {
+          fixed[i] = reader->line + fixedbeg[i];
+          reader->line[fixedbeg[i] - 1] = '\0';
+          len = fixedbeg[i] - 1;
+        }
+      }
+
+      for (i = 0; i < 6; ++i) {
+        if (!fixed[i])
+          continue;
+
+        for (p = fixed[i]; *p == ' ' || *p == '\t'; ++p) {}
+        for (end = p + strlen(p); end > p && (end[-1] == ' ' || end[-1] == '\t'); --end) {}
+        *end = '\0';
+
+        if (*p != '\0')
+          reader->field[reader->fieldnum++] = p;
+      }
+
+    } else {
+      for (p = strtok(reader->line, " \t"); p; p = strtok(NULL, " \t")) {
+        if (reader->fieldnum == MPS_MAX_FIELD) {
+          reader->error = "Too many fields on line.";
+          return 0;
+        }
+        reader->field[reader->fieldnum++] = p;
+      }
+    }
+
+    if (reader->fieldnum >= 1)
+      return 1;
+  }
+
+  return 0;
+}
+
+static CBFresponsee readdouble(const char *str, double *val)
+{
+  char *end;
+
+  *val = strtod(str, &end);
+  if (end == str || *end != '\0')
+    return CBF_RES_ERR;
+
+  if (*val >= MPS_INFINITY)
+    *val = HUGE_VAL;
+  else if (*val <= -MPS_INFINITY)
+    *val = -HUGE_VAL;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee readHEADER(MPSreader *reader, MPSsectione *section, int *isend)
+{
+  CBFresponsee res = CBF_RES_OK;
+  const char *name = reader->field[0];
+  long long int cap;
+
+  *section = MPS_SECTION_NONE;
+
+  if (strcmp(name, "NAME") == 0) {
+    // The name of the problem is not kept
+
+  } else if (strcmp(name, "OBJSENSE") == 0) {
+    // The sense may follow on the same line
+    if (reader->fieldnum >= 2)
+      res = readOBJSENSE(reader, reader->field[1]);
+    else
+      *section = MPS_SECTION_OBJSENSE;
+
+  } else if (strcmp(name, "ROWS") == 0) {
+    *section = MPS_SECTION_ROWS;
+
+  } else if (strcmp(name, "COLUMNS") == 0) {
+    *section = MPS_SECTION_COLUMNS;
+
+  } else if (strcmp(name, "RHS") == 0) {
+    *section = MPS_SECTION_RHS;
+
+  } else if (strcmp(name, "RANGES") == 0) {
+    *section = MPS_SECTION_RANGES;
+
+  } else if (strcmp(name, "BOUNDS") == 0) {
+    *section = MPS_SECTION_BOUNDS;
+
+  } else if (strcmp(name, "CSECTION") == 0) {
+    *section = MPS_SECTION_CSECTION;
+
+    // CSECTION <name> <parameter> <type>, followed by the members of the cone
+    if (reader->fieldnum != 4)
+      return CBF_RES_ERR;
+
+    if (reader->conenum + 1 >= reader->conecap) {
+      cap = (reader->conecap == 0 ? 1024 : 2 * reader->conecap);
+      reader->conetype = (CBFscalarconee*) growarray(reader->conetype, cap, sizeof(reader->conetype[0]), &res);
+      reader->conebeg = (long long int*) growarray(reader->conebeg, cap, sizeof(reader->conebeg[0]), &res);
+      if (res != CBF_RES_OK)
+        return res;
+      reader->conecap = cap;
+    }
+
+    if (strcmp(reader->field[3], "QUAD") == 0)
+      reader->conetype[reader->conenum] = CBF_CONE_QUAD;
+    else if (strcmp(reader->field[3], "RQUAD") == 0)
+      reader->conetype[reader->conenum] = CBF_CONE_RQUAD;
+    else if (strcmp(reader->field[3], "PEXP") == 0)
+      reader->conetype[reader->conenum] = CBF_CONE_PEXP;
+    else if (strcmp(reader->field[3], "DEXP") == 0)
+      reader->conetype[reader->conenum] = CBF_CONE_DEXP;
+    else {
+      reader->error = "Unsupported cone type in CSECTION.";
+      return CBF_RES_ERR;
+    }
+
+    reader->conebeg[reader->conenum] = reader->membernum;
+    ++reader->conenum;
+    reader->conebeg[reader->conenum] = reader->membernum;
+
+  } else if (strcmp(name, "ENDATA") == 0) {
+    *isend = 1;
+
+  } else {
+    reader->error = "Unsupported section in MPS file.";
+    res = CBF_RES_ERR;
+  }
+
+  return res;
+}
+
+static CBFresponsee readOBJSENSE(MPSreader *reader, const char *sense)
+{
+  if (strcmp(sense, "MIN") == 0 || strcmp(sense, "MINIMIZE") == 0)
+    reader->objsense = CBF_OBJ_MINIMIZE;
+  else if (strcmp(sense, "MAX") == 0 || strcmp(sense, "MAXIMIZE") == 0)
+    reader->objsense = CBF_OBJ_MAXIMIZE;
+  else
+    return CBF_RES_ERR;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee readROWS(MPSreader *reader)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, cap;
+  int isnew;
+  char type;
+
+  if (reader->fieldnum != 2 || strlen(reader->field[0]) != 1)
+    return CBF_RES_ERR;
+
+  type = reader->field[0][0];
+  if (type != 'N' && type != 'E' && type != 'G' && type != 'L')
+    return CBF_RES_ERR;
+
+  if (reader->rows.num + 1 > reader->rowcap) {
+    cap = (reader->rowcap == 0 ? 1024 : 2 * reader->rowcap);
+    reader->rowtype = (char*) growarray(reader->rowtype, cap, sizeof(reader->rowtype[0]), &res);
+    reader->rhs = (double*) growarray(reader->rhs, cap, sizeof(reader->rhs[0]), &res);
+    reader->range = (double*) growarray(reader->range, cap, sizeof(reader->range[0]), &res);
+    reader->isranged = (char*) growarray(reader->isranged, cap, sizeof(reader->isranged[0]), &res);
+    if (res != CBF_RES_OK)
+      return res;
+    reader->rowcap = cap;
+  }
+
+  res = CBFnametable_add(&reader->rows, reader->field[1], &i, &isnew);
+  if (res != CBF_RES_OK)
+    return res;
+
+  if (!isnew) {
+    reader->error = "Duplicate row name.";
+    return CBF_RES_ERR;
+  }
+
+  // The first free row is the objective
+  if (type == 'N' && reader->objrow == -1)
+    reader->objrow = i;
+
+  reader->rowtype[i] = type;
+  reader->rhs[i] = 0.0;
+  reader->range[i] = 0.0;
+  reader->isranged[i] = 0;
+
+  return res;
+}
+
+static CBFresponsee readCOLUMNS(MPSreader *reader, int *isintsection)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, j, k, cap;
+  int isnew;
+  double val;
+
+  // Integer columns are enclosed by MARKER lines
+  if (reader->fieldnum == 3 && strcmp(reader->field[1], "'MARKER'") == 0) {
+    if (strcmp(reader->field[2], "'INTORG'") == 0)
+      *isintsection = 1;
+    else if (strcmp(reader->field[2], "'INTEND'") == 0)
+      *isintsection = 0;
+    else
+      res = CBF_RES_ERR;
+
+    return res;
+  }
+
+  if (reader->fieldnum != 3 && reader->fieldnum != 5)
+    return CBF_RES_ERR;
+
+  if (reader->cols.num + 1 > reader->colcap) {
+    cap = (reader->colcap == 0 ? 1024 : 2 * reader->colcap);
+    reader->isint = (char*) growarray(reader->isint, cap, sizeof(reader->isint[0]), &res);
+    reader->lower = (double*) growarray(reader->lower, cap, sizeof(reader->lower[0]), &res);
+    reader->upper = (double*) growarray(reader->upper, cap, sizeof(reader->upper[0]), &res);
+    reader->cone = (long long int*) growarray(reader->cone, cap, sizeof(reader->cone[0]), &res);
+    if (res != CBF_RES_OK)
+      return res;
+    reader->colcap = cap;
+  }
+
+  res = CBFnametable_add(&reader->cols, reader->field[0], &j, &isnew);
+  if (res != CBF_RES_OK)
+    return res;
+
+  if (isnew) {
+    reader->isint[j] = (char) *isintsection;
+    reader->lower[j] = 0.0;
+    reader->upper[j] = HUGE_VAL;
+    reader->cone[j] = -1;
+  }
+
+  for (k = 1; k + 1 < reader->fieldnum && res == CBF_RES_OK; k += 2) {
+    i = CBFnametable_find(&reader->rows, reader->field[k]);
+    if (i < 0) {
+      reader->error = "Unknown row name.";
+      return CBF_RES_ERR;
+    }
+
+    res = readdouble(reader->field[k+1], &val);
+    if (res != CBF_RES_OK || val == 0.0)
+      continue;
+
+    if (reader->nnz + 1 > reader->nnzcap) {
+      cap = (reader->nnzcap == 0 ? 65536 : 2 * reader->nnzcap);
+      reader->subi = (long long int*) growarray(reader->subi, cap, sizeof(reader->subi[0]), &res);
+      reader->subj = (long long int*) growarray(reader->subj, cap, sizeof(reader->subj[0]), &res);
+      reader->val = (double*) growarray(reader->val, cap, sizeof(reader->val[0]), &res);
+      if (res != CBF_RES_OK)
+        return res;
+      reader->nnzcap = cap;
+    }
+
+    reader->subi[reader->nnz] = i;
+    reader->subj[reader->nnz] = j;
+    reader->val[reader->nnz] = val;
+    ++reader->nnz;
+  }
+
+  return res;
+}
+
+static CBFresponsee readRHS(MPSreader *reader, int isrange)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, k;
+  double val;
+
+  if (reader->fieldnum < 2 || reader->fieldnum > 5)
+    return CBF_RES_ERR;
+
+  // Pairs of row and value, preceded by the name of the vector if the count is odd
+  for (k = reader->fieldnum % 2; k + 1 < reader->fieldnum && res == CBF_RES_OK; k += 2) {
+    i = CBFnametable_find(&reader->rows, reader->field[k]);
+    if (i < 0) {
+      reader->error = "Unknown row name.";
+      return CBF_RES_ERR;
+    }
+
+    res = readdouble(reader->field[k+1], &val);
+
+    if (res == CBF_RES_OK) {
+      if (isrange) {
+        reader->range[i] = val;
+        reader->isranged[i] = 1;
+      } else {
+        reader->rhs[i] = val;
+      }
+    }
+  }
+
+  return res;
+}
+
+static CBFresponsee readBOUNDS(MPSreader *reader)
+{
+  CBFresponsee res = CBF_RES_OK;
+  const char *type = reader->field[0];
+  long long int j;
+  int hasvalue;
+  double val = 0.0;
+
+  hasvalue = (strcmp(type, "UP") == 0 || strcmp(type, "LO") == 0 || strcmp(type, "FX") == 0 ||
+              strcmp(type, "LI") == 0 || strcmp(type, "UI") == 0);
+
+  // The name of the bound vector is optional
+  if (reader->fieldnum != 2 + hasvalue && reader->fieldnum != 3 + hasvalue)
+    return CBF_RES_ERR;
+
+  j = CBFnametable_find(&reader->cols, reader->field[reader->fieldnum - 1 - hasvalue]);
+  if (j < 0) {
+    reader->error = "Unknown column name.";
+    return CBF_RES_ERR;
+  }
+
+  if (hasvalue)
+    res = readdouble(reader->field[reader->fieldnum - 1], &val);
+
+  if (res != CBF_RES_OK)
+    return res;
+
+  if (strcmp(type, "UP") == 0 || strcmp(type, "UI") == 0) {
+    // A negative upper bound frees the default lower bound of zero
+    if (val < 0.0 && reader->lower[j] == 0.0)
+      reader->lower[j] = -HUGE_VAL;
+    reader->upper[j] = val;
+    if (type[1] == 'I')
+      reader->isint[j] = 1;
+  } else if (strcmp(type, "LO") == 0 || strcmp(type, "LI") == 0) {
+    reader->lower[j] = val;
+    if (type[1] == 'I')
+      reader->isint[j] = 1;
+  } else if (strcmp(type, "FX") == 0) {
+    reader->lower[j] = val;
+    reader->upper[j] = val;
+  } else if (strcmp(type, "FR") == 0) {
+    reader->lower[j] = -HUGE_VAL;
+    reader->upper[j] = HUGE_VAL;
+  } else if (strcmp(type, "MI") == 0) {
+    reader->lower[j] = -HUGE_VAL;
+  } else if (strcmp(type, "PL") == 0) {
+    reader->upper[j] = HUGE_VAL;
+  } else if (strcmp(type, "BV") == 0) {
+    reader->lower[j] = 0.0;
+    reader->upper[j] = 1.0;
+    reader->isint[j] = 1;
+  } else {
+    reader->error = "Unsupported bound type.";
+    res = CBF_RES_ERR;
+  }
+
+  return res;
+}
+
+static CBFresponsee readCSECTION(MPSreader *reader)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int j, cap;
+
+  if (reader->fieldnum != 1)
+    return CBF_RES_ERR;
+
+  j = CBFnametable_find(&reader->cols, reader->field[0]);
+  if (j < 0) {
+    reader->error = "Unknown column name.";
+    return CBF_RES_ERR;
+  }
+
+  if (reader->cone[j] != -1) {
+    reader->error = "Column is a member of more than one cone.";
+    return CBF_RES_ERR;
+  }
+
+  if (reader->membernum + 1 > reader->membercap) {
+    cap = (reader->membercap == 0 ? 1024 : 2 * reader->membercap);
+    reader->member = (long long int*) growarray(reader->member, cap, sizeof(reader->member[0]), &res);
+    if (res != CBF_RES_OK)
+      return res;
+    reader->membercap = cap;
+  }
+
+  reader->cone[j] = reader->conenum - 1;
+  reader->member[reader->membernum++] = j;
+  reader->conebeg[reader->conenum] = reader->membernum;
+
+  return res;
+}
+
+// Adds 'name' followed by 'suffix', and a number if needed to make it unique
+static CBFresponsee addname(CBFnametable *table, const char *name, const char *suffix)
+{
+  CBFresponsee res = CBF_RES_OK;
+  char buf[MPS_MAX_LINE + 32];
+  long long int idx, k = 0;
+  int isnew = 0;
+
+  sprintf(buf, "%s%s", name, suffix);
+  res = CBFnametable_add(table, buf, &idx, &isnew);
+
+  while (res == CBF_RES_OK && !isnew) {
+    sprintf(buf, "%s%s%lli", name, suffix, ++k);
+    res = CBFnametable_add(table, buf, &idx, &isnew);
+  }
+
+  return res;
+}
+
+// Variables and maps keep the names of columns and rows, and additional maps are named after them
+static CBFresponsee buildNAMES(const MPSreader *reader, CBFdata *data, const long long int *perm, const CBFscalarconee *domain, const char *isnonneg)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int *col = NULL;
+  long long int i, j;
+  int islower, isupper;
+
+  data->varname = (CBFnametable*) calloc(1, sizeof(*data->varname));
+  data->mapname = (CBFnametable*) calloc(1, sizeof(*data->mapname));
+  col = (long long int*) malloc((reader->cols.num + 1) * sizeof(col[0]));
+
+  if (!data->varname || !data->mapname || !col)
+    res = CBF_RES_ERR;
+
+  if (res == CBF_RES_OK)
+    for (j = 0; j < reader->cols.num; ++j)
+      col[perm[j]] = j;
+
+  for (j = 0; j < reader->cols.num && res == CBF_RES_OK; ++j)
+    res = CBFnametable_push(data->varname, CBFnametable_name(&reader->cols, col[j]));
+
+  for (i = 0; i < reader->rows.num && res == CBF_RES_OK; ++i)
+    if (i != reader->objrow)
+      res = CBFnametable_push(data->mapname, CBFnametable_name(&reader->rows, i));
+
+  for (i = 0; i < reader->rows.num && res == CBF_RES_OK; ++i)
+    if (reader->isranged[i] && reader->rowtype[i] != 'N')
+      res = addname(data->mapname, CBFnametable_name(&reader->rows, i), "_rng");
+
+  for (j = 0; j < reader->cols.num && res == CBF_RES_OK; ++j) {
+    boundrows(reader, j, domain[j], isnonneg[j], &islower, &isupper);
+
+    if (islower)
+      res = addname(data->mapname, CBFnametable_name(&reader->cols, j), (reader->lower[j] == reader->upper[j] ? "_fx" : "_lo"));
+
+    if (isupper && res == CBF_RES_OK)
+      res = addname(data->mapname, CBFnametable_name(&reader->cols, j), "_up");
+  }
+
+  free(col);
+  return res;
+}
+
+// Domain of row 'i', or of the additional row bounding the other side of its range
+static CBFscalarconee rowdomain(const MPSreader *reader, long long int i, int isrange)
+{
+  switch (reader->rowtype[i]) {
+  case 'G':   return (isrange ? CBF_CONE_NEG : CBF_CONE_POS);
+  case 'L':   return (isrange ? CBF_CONE_POS : CBF_CONE_NEG);
+  case 'E':
+    if (!reader->isranged[i])
+      return CBF_CONE_ZERO;
+    else if (reader->range[i] >= 0.0)
+      return (isrange ? CBF_CONE_NEG : CBF_CONE_POS);
+    else
+      return (isrange ? CBF_CONE_POS : CBF_CONE_NEG);
+  default:    return CBF_CONE_FREE;
+  }
+}
+
+// Finite bounds on column 'j' not already implied by its domain need a row of their own
+static void boundrows(const MPSreader *reader, long long int j, CBFscalarconee domain, int isnonneg, int *islower, int *isupper)
+{
+  double lower = reader->lower[j], upper = reader->upper[j];
+
+  *islower = (lower > -HUGE_VAL) && !(lower == 0.0 && (domain == CBF_CONE_POS || domain == CBF_CONE_ZERO || isnonneg));
+  *isupper = (upper < HUGE_VAL) && !(upper == 0.0 && (domain == CBF_CONE_NEG || domain == CBF_CONE_ZERO));
+
+  // A fixed column needs only one
+  if (*islower && *isupper && lower == upper)
+    *isupper = 0;
+}
+
+static CBFresponsee buildDATA(const MPSreader *reader, CBFdyndata *dyndata)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFdata *data = dyndata->data;
+  long long int rownum = reader->rows.num, colnum = reader->cols.num;
+  long long int *perm = NULL, *maprow = NULL, *rangerow = NULL;
+  CBFscalarconee *domain = NULL;
+  char *isnonneg = NULL;
+  long long int i, j, k, c, dim, boundbeg, boundnum = 0, annz = 0, bnnz = 0, objannz = 0, intnum = 0;
+  int islower, isupper;
+  double bound;
+
+  data->ver = CBF_VERSION;
+  data->objsense = reader->objsense;
+
+  for (c = 0; c < reader->conenum; ++c) {
+    dim = reader->conebeg[c+1] - reader->conebeg[c];
+    if (dim < 1 || (reader->conetype[c] == CBF_CONE_RQUAD && dim < 2) ||
+        ((reader->conetype[c] == CBF_CONE_PEXP || reader->conetype[c] == CBF_CONE_DEXP) && dim != 3)) {
+      printf("Invalid dimension of cone number %lli in CSECTION.\n", c);
+      return CBF_RES_ERR;
+    }
+  }
+
+  perm = (long long int*) malloc((colnum + 1) * sizeof(perm[0]));
+  domain = (CBFscalarconee*) malloc((colnum + 1) * sizeof(domain[0]));
+  isnonneg = (char*) calloc(colnum + 1, sizeof(isnonneg[0]));
+  maprow = (long long int*) malloc((rownum + 1) * sizeof(maprow[0]));
+  rangerow = (long long int*) malloc((rownum + 1) * sizeof(rangerow[0]));
+
+  if (!perm || !domain || !isnonneg || !maprow || !rangerow)
+    res = CBF_RES_ERR;
+
+  //
+  // Variables follow the columns, except that each cone is placed as a whole
+  // where its first member appears. Bounds at zero become the domain if possible.
+  //
+  if (res == CBF_RES_OK)
+    res = CBFdyn_var_capacitysurplus(dyndata, colnum);
+
+  for (j = 0; j < colnum; ++j)
+    perm[j] = -1;
+
+  for (j = 0; j < colnum && res == CBF_RES_OK; ++j) {
+    c = reader->cone[j];
+
+    if (c == -1) {
+      if (reader->lower[j] == 0.0 && reader->upper[j] == 0.0)
+        domain[j] = CBF_CONE_ZERO;
+      else if (reader->lower[j] == 0.0)
+        domain[j] = CBF_CONE_POS;
+      else if (reader->upper[j] == 0.0)
+        domain[j] = CBF_CONE_NEG;
+      else
+        domain[j] = CBF_CONE_FREE;
+
+      perm[j] = data->varnum;
+      res = CBFdyn_var_adddomain(dyndata, domain[j], 1);
+
+    } else if (perm[j] == -1) {
+      for (k = reader->conebeg[c]; k < reader->conebeg[c+1]; ++k) {
+        perm[reader->member[k]] = data->varnum + (k - reader->conebeg[c]);
+        domain[reader->member[k]] = reader->conetype[c];
+
+        // The leading members of quadratic cones are nonnegative
+        if (reader->conetype[c] == CBF_CONE_QUAD)
+          isnonneg[reader->member[k]] = (k - reader->conebeg[c] < 1);
+        else if (reader->conetype[c] == CBF_CONE_RQUAD)
+          isnonneg[reader->member[k]] = (k - reader->conebeg[c] < 2);
+      }
+      res = CBFdyn_var_adddomain(dyndata, reader->conetype[c], reader->conebeg[c+1] - reader->conebeg[c]);
+    }
+  }
+
+  //
+  // Maps follow the rows, except the objective, and are succeeded by a map
+  // for the other side of each ranged row and for each bound that remains.
+  //
+  if (res == CBF_RES_OK)
+    res = CBFdyn_map_capacitysurplus(dyndata, 2 * rownum + 2 * colnum);
+
+  for (i = 0; i < rownum && res == CBF_RES_OK; ++i) {
+    maprow[i] = -1;
+    if (i != reader->objrow) {
+      maprow[i] = data->mapnum;
+      res = CBFdyn_map_adddomain(dyndata, rowdomain(reader, i, 0), 1);
+      bnnz += (reader->rhs[i] != 0.0);
+    }
+  }
+
+  for (i = 0; i < rownum && res == CBF_RES_OK; ++i) {
+    rangerow[i] = -1;
+    if (reader->isranged[i] && reader->rowtype[i] != 'N') {
+      rangerow[i] = data->mapnum;
+      res = CBFdyn_map_adddomain(dyndata, rowdomain(reader, i, 1), 1);
+      ++bnnz;
+    }
+  }
+
+  boundbeg = data->mapnum;
+  for (j = 0; j < colnum && res == CBF_RES_OK; ++j) {
+    boundrows(reader, j, domain[j], isnonneg[j], &islower, &isupper);
+
+    if (islower) {
+      res = CBFdyn_map_adddomain(dyndata, (reader->lower[j] == reader->upper[j] ? CBF_CONE_ZERO : CBF_CONE_POS), 1);
+      bnnz += (reader->lower[j] != 0.0);
+      ++boundnum;
+    }
+
+    if (isupper && res == CBF_RES_OK) {
+      res = CBFdyn_map_adddomain(dyndata, CBF_CONE_NEG, 1);
+      bnnz += (reader->upper[j] != 0.0);
+      ++boundnum;
+    }
+  }
+
+  //
+  // Coordinates are passed on in column-major order as read
+  //
+  for (k = 0; k < reader->nnz && res == CBF_RES_OK; ++k) {
+    if (reader->subi[k] == reader->objrow)
+      ++objannz;
+    else
+      annz += 1 + (rangerow[reader->subi[k]] != -1);
+  }
+
+  if (res == CBF_RES_OK)
+    res = CBFdyn_obja_capacitysurplus(dyndata, objannz);
+
+  if (res == CBF_RES_OK)
+    res = CBFdyn_a_capacitysurplus(dyndata, annz + boundnum);
+
+  if (res == CBF_RES_OK)
+    res = CBFdyn_b_capacitysurplus(dyndata, bnnz);
+
+  for (k = 0; k < reader->nnz && res == CBF_RES_OK; ++k) {
+    i = reader->subi[k];
+    j = perm[reader->subj[k]];
+
+    if (i == reader->objrow) {
+      res = CBFdyn_obja_add(dyndata, j, reader->val[k]);
+    } else {
+      res = CBFdyn_a_add(dyndata, maprow[i], j, reader->val[k]);
+      if (res == CBF_RES_OK && rangerow[i] != -1)
+        res = CBFdyn_a_add(dyndata, rangerow[i], j, reader->val[k]);
+    }
+  }
+
+  // Constant terms are the negated right-hand sides, and likewise for the objective
+  for (i = 0; i < rownum && res == CBF_RES_OK; ++i)
+    if (maprow[i] != -1 && reader->rhs[i] != 0.0)
+      res = CBFdyn_b_add(dyndata, maprow[i], -reader->rhs[i]);
+
+  for (i = 0; i < rownum && res == CBF_RES_OK; ++i) {
+    if (rangerow[i] != -1) {
+      if (reader->rowtype[i] == 'L' || (reader->rowtype[i] == 'E' && reader->range[i] < 0.0))
+        bound = reader->rhs[i] - fabs(reader->range[i]);
+      else
+        bound = reader->rhs[i] + fabs(reader->range[i]);
+
+      res = CBFdyn_b_add(dyndata, rangerow[i], -bound);
+    }
+  }
+
+  if (res == CBF_RES_OK && reader->objrow != -1)
+    data->objbval = -reader->rhs[reader->objrow];
+
+  for (j = 0, k = boundbeg; j < colnum && res == CBF_RES_OK; ++j) {
+    boundrows(reader, j, domain[j], isnonneg[j], &islower, &isupper);
+
+    if (islower) {
+      res = CBFdyn_a_add(dyndata, k, perm[j], 1.0);
+      if (res == CBF_RES_OK && reader->lower[j] != 0.0)
+        res = CBFdyn_b_add(dyndata, k, -reader->lower[j]);
+      ++k;
+    }
+
+    if (isupper && res == CBF_RES_OK) {
+      res = CBFdyn_a_add(dyndata, k, perm[j], 1.0);
+      if (res == CBF_RES_OK && reader->upper[j] != 0.0)
+        res = CBFdyn_b_add(dyndata, k, -reader->upper[j]);
+      ++k;
+    }
+  }
+
+  if (res == CBF_RES_OK)
+    res = buildNAMES(reader, data, perm, domain, isnonneg);
+
+  //
+  // Integer variables
+  //
+  for (j = 0; j < colnum; ++j)
+    intnum += reader->isint[j];
+
+  if (res == CBF_RES_OK && intnum >= 1)
+    res = CBFdyn_intvar_capacitysurplus(dyndata, intnum);
+
+  for (j = 0; j < colnum && res == CBF_RES_OK; ++j)
+    if (reader->isint[j])
+      res = CBFdyn_intvar_add(dyndata, perm[j]);
+
+  free(perm);
+  free(domain);
+  free(isnonneg);
+  free(maprow);
+  free(rangerow);
+
+  return res;
+}
@@ -0,0 +1,469 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "frontend-sdpa.h"
+#include "cbf-helper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ZLIB_SUPPORT
+typedef FILE CBFFILE;
+#define FOPEN(x,y) fopen(x,y)
+#define FCLOSE(x) fclose(x)
+#define FREAD(x,y,z) fread(x,1,y,z)
+#else
+#include <zlib.h>
+typedef struct gzFile_s CBFFILE;
+#define FOPEN(x,y) gzopen(x,y)
+#define FCLOSE(x) gzclose(x)
+#define FREAD(x,y,z) gzread(z,x,y)
+#endif
+
+// Size of the input buffer, as the objective vector may span a single very long line
+#define SDPA_BUFFER  (1 << 16)
+
+// Tokenizer over the raw input, in which ',', '{', '}', '(' and ')' count as white space
+typedef struct SDPAreader_struct {
+  CBFFILE *pFile;
+  char buf[SDPA_BUFFER];
+  long long int pos;
+  long long int len;
+  long long int linecount;
+} SDPAreader;
+
+static CBFresponsee
+  read(const char *file, CBFdata *data, CBFfrontendmemory *mem);
+
+static void
+  clean(CBFdata *data, CBFfrontendmemory *mem);
+
+static int
+  peekchar(SDPAreader *reader);
+
+static int
+  isseparator(int c);
+
+static void
+  skipline(SDPAreader *reader);
+
+static void
+  skipcomments(SDPAreader *reader);
+
+static CBFresponsee
+  readtoken(SDPAreader *reader, char *token);
+
+static CBFresponsee
+  readinteger(SDPAreader *reader, long long int *val);
+
+static CBFresponsee
+  readdouble(SDPAreader *reader, double *val);
+
+static CBFresponsee
+  readHEADER(SDPAreader *reader, CBFdyndata *dyndata, long long int *blocknum, long long int **blockdim, long long int **blockmap);
+
+static CBFresponsee
+  readOBJECTIVE(SDPAreader *reader, CBFdyndata *dyndata);
+
+static CBFresponsee
+  readENTRIES(SDPAreader *reader, CBFdyndata *dyndata, long long int blocknum, const long long int *blockdim, const long long int *blockmap);
+
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFfrontend const frontend_sdpa = { "sdpa", read, clean };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee read(const char *file, CBFdata *data, CBFfrontendmemory *mem)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFdyndata *dyndata = NULL;
+  SDPAreader *reader = NULL;
+  long long int blocknum = 0, *blockdim = NULL, *blockmap = NULL;
+
+  //
+  // Use CBFfrontendmemory to store the CBFdyndata wrapper of CBFdata
+  //
+  *mem = calloc(1, sizeof(*dyndata));
+  if (!*mem) {
+    return CBF_RES_ERR;
+  } else {
+    dyndata = (CBFdyndata*)*mem;
+    dyndata->data = data;
+  }
+
+  reader = (SDPAreader*) calloc(1, sizeof(*reader));
+  if (!reader) {
+    clean(data, mem);
+    return CBF_RES_ERR;
+  }
+
+  reader->pFile = FOPEN(file, "rt");
+  if (!reader->pFile) {
+    free(reader);
+    clean(data, mem);
+    return CBF_RES_ERR;
+  }
+
+  if (res == CBF_RES_OK)
+    res = readHEADER(reader, dyndata, &blocknum, &blockdim, &blockmap);
+
+  if (res == CBF_RES_OK)
+    res = readOBJECTIVE(reader, dyndata);
+
+  if (res == CBF_RES_OK)
+    res = readENTRIES(reader, dyndata, blocknum, blockdim, blockmap);
+
+  if (res != CBF_RES_OK) {
+    printf("Failed to parse line: %lli\n", reader->linecount + 1);
+    clean(data, mem);
+  }
+
+  FCLOSE(reader->pFile);
+  free(reader);
+  free(blockdim);
+  free(blockmap);
+
+  return res;
+}
+
+static void clean(CBFdata *data, CBFfrontendmemory *mem)
+{
+  //
+  // All memory is allocated by the cbf-helper module
+  //
+  if (*mem) {
+    CBFdyn_freedynamicallocations( (CBFdyndata*)*mem );
+    free(*mem);
+    *mem = NULL;
+  }
+}
+
+static int peekchar(SDPAreader *reader)
+{
+  if (reader->pos == reader->len) {
+    reader->pos = 0;
+    reader->len = FREAD(reader->buf, SDPA_BUFFER, reader->pFile);
+    if (reader->len <= 0) {
+      reader->len = 0;
+      return EOF;
+    }
+  }
+
+  return (unsigned char) reader->buf[reader->pos];
+}
+
+static int isseparator(int c)
+{
+  switch (c) {
+  case ' ': case '\t': case '\r': case '\n':
+  case ',': case '{': case '}': case '(': case ')':
+    return 1;
+  default:
+    return 0;
+  }
+}
+
+static void skipline(SDPAreader *reader)
+{
+  int c;
+
+  while ((c = peekchar(reader)) != EOF) {
+    ++reader->pos;
+    if (c == '\n') {
+      ++reader->linecount;
+      break;
+    }
+  }
+}
+
+// Lines starting with '"' or '*' are comments in the header
+static void skipcomments(SDPAreader *reader)
+{
+  int c;
+
+  while ((c = peekchar(reader)) != EOF) {
+    if (c == '"' || c == '*') {
+      skipline(reader);
+    } else if (c == '\n') {
+      ++reader->pos;
+      ++reader->linecount;
+    } else if (isseparator(c)) {
+      ++reader->pos;
+    } else {
+      break;
+    }
+  }
+}
+
+// Reads the next token into 'token' (of size CBF_MAX_LINE), which is empty at end of file
+static CBFresponsee readtoken(SDPAreader *reader, char *token)
+{
+  long long int len = 0;
+  int c;
+
+  while ((c = peekchar(reader)) != EOF && isseparator(c)) {
+    ++reader->pos;
+    if (c == '\n')
+      ++reader->linecount;
+  }
+
+  while ((c = peekchar(reader)) != EOF && !isseparator(c)) {
+    if (len == CBF_MAX_LINE - 1)
+      return CBF_RES_ERR;
+
+    token[len++] = (char) c;
+    ++reader->pos;
+  }
+
+  token[len] = '\0';
+  return CBF_RES_OK;
+}
+
+static CBFresponsee readinteger(SDPAreader *reader, long long int *val)
+{
+  char token[CBF_MAX_LINE], *end;
+
+  if (readtoken(reader, token) != CBF_RES_OK || token[0] == '\0')
+    return CBF_RES_ERR;
+
+  *val = strtoll(token, &end, 10);
+
+  // Integers are sometimes written as reals, e.g., "2.0"
+  if (*end == '.' && strspn(end + 1, "0") == strlen(end + 1))
+    return CBF_RES_OK;
+
+  return (*end == '\0' ? CBF_RES_OK : CBF_RES_ERR);
+}
+
+static CBFresponsee readdouble(SDPAreader *reader, double *val)
+{
+  char token[CBF_MAX_LINE], *end;
+
+  if (readtoken(reader, token) != CBF_RES_OK || token[0] == '\0')
+    return CBF_RES_ERR;
+
+  *val = strtod(token, &end);
+  return (*end == '\0' ? CBF_RES_OK : CBF_RES_ERR);
+}
+
+static CBFresponsee readHEADER(SDPAreader *reader, CBFdyndata *dyndata, long long int *blocknum, long long int **blockdim, long long int **blockmap)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, varnum = 0;
+
+  dyndata->data->ver = CBF_VERSION;
+  dyndata->data->objsense = CBF_OBJ_MINIMIZE;
+
+  // Number of constraint matrices, and of blocks, followed by optional comments
+  skipcomments(reader);
+
+  if (res == CBF_RES_OK)
+    res = readinteger(reader, &varnum);
+
+  if (res == CBF_RES_OK) {
+    skipline(reader);
+    res = readinteger(reader, blocknum);
+  }
+
+  if (res == CBF_RES_OK) {
+    skipline(reader);
+    if (varnum < 0 || *blocknum < 0)
+      res = CBF_RES_ERR;
+  }
+
+  if (res == CBF_RES_OK) {
+    *blockdim = (long long int*) malloc(*blocknum * sizeof((*blockdim)[0]));
+    *blockmap = (long long int*) malloc(*blocknum * sizeof((*blockmap)[0]));
+    if (!*blockdim || !*blockmap)
+      res = CBF_RES_ERR;
+  }
+
+  // Block structure, where negative dimensions are diagonal (linear) blocks
+  for (i=0; i<*blocknum && res==CBF_RES_OK; ++i) {
+    res = readinteger(reader, &(*blockdim)[i]);
+    if (res == CBF_RES_OK && (*blockdim)[i] == 0)
+      res = CBF_RES_ERR;
+  }
+
+  if (res == CBF_RES_OK)
+    skipline(reader);
+
+  if (res == CBF_RES_OK)
+    res = CBFdyn_var_capacitysurplus(dyndata, 1);
+
+  if (res == CBF_RES_OK && varnum >= 1)
+    res = CBFdyn_var_adddomain(dyndata, CBF_CONE_FREE, varnum);
+
+  if (res == CBF_RES_OK)
+    res = CBFdyn_psdmap_capacitysurplus(dyndata, (int) *blocknum);
+
+  if (res == CBF_RES_OK)
+    res = CBFdyn_map_capacitysurplus(dyndata, *blocknum);
+
+  // Blocks map to a psdmap, or to the first row of a nonnegative map stack
+  for (i=0; i<*blocknum && res==CBF_RES_OK; ++i) {
+    if ((*blockdim)[i] >= 1) {
+      (*blockmap)[i] = dyndata->data->psdmapnum;
+      res = CBFdyn_psdmap_add(dyndata, (int) (*blockdim)[i]);
+    } else {
+      (*blockmap)[i] = dyndata->data->mapnum;
+      res = CBFdyn_map_adddomain(dyndata, CBF_CONE_POS, -(*blockdim)[i]);
+    }
+  }
+
+  return res;
+}
+
+static CBFresponsee readOBJECTIVE(SDPAreader *reader, CBFdyndata *dyndata)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int j;
+  double val;
+
+  for (j=0; j<dyndata->data->varnum && res==CBF_RES_OK; ++j) {
+    res = readdouble(reader, &val);
+
+    if (res == CBF_RES_OK && val != 0.0) {
+      if (dyndata->data->objannz == dyndata->objadyncap)
+        res = CBFdyn_obja_capacitysurplus(dyndata, (dyndata->objadyncap >= 1024 ? dyndata->objadyncap : 1024));
+
+      if (res == CBF_RES_OK)
+        res = CBFdyn_obja_add(dyndata, j, val);
+    }
+  }
+
+  if (res == CBF_RES_OK)
+    skipline(reader);
+
+  return res;
+}
+
+static CBFresponsee readENTRIES(SDPAreader *reader, CBFdyndata *dyndata, long long int blocknum, const long long int *blockdim, const long long int *blockmap)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFdata *data = dyndata->data;
+  char token[CBF_MAX_LINE], *end;
+  long long int mat, blk, i, j, k, l, row, dim;
+  int isinteger = 0;
+  double val;
+
+  while (res == CBF_RES_OK) {
+    res = readtoken(reader, token);
+    if (res != CBF_RES_OK || token[0] == '\0')
+      break;
+
+    // Integer variables are listed after "*INTEGER" by an extension of the format
+    if (token[0] == '*') {
+      if (strncmp(token, "*INTEGER", 8) == 0) {
+        isinteger = 1;
+      } else if (isinteger) {
+        j = strtoll(token + 1, &end, 10);
+        if (*end != '\0' || j < 0 || j >= data->varnum)
+          res = CBF_RES_ERR;
+
+        if (res == CBF_RES_OK)
+          res = CBFdyn_intvar_capacitysurplus(dyndata, 1);
+
+        if (res == CBF_RES_OK)
+          res = CBFdyn_intvar_add(dyndata, j);
+      }
+      skipline(reader);
+      continue;
+    }
+
+    mat = strtoll(token, &end, 10);
+    if (*end != '\0')
+      res = CBF_RES_ERR;
+
+    if (res == CBF_RES_OK)
+      res = readinteger(reader, &blk);
+
+    if (res == CBF_RES_OK)
+      res = readinteger(reader, &i);
+
+    if (res == CBF_RES_OK)
+      res = readinteger(reader, &j);
+
+    if (res == CBF_RES_OK)
+      res = readdouble(reader, &val);
+
+    if (res == CBF_RES_OK)
+      if (mat < 0 || mat > data->varnum || blk < 1 || blk > blocknum)
+        res = CBF_RES_ERR;
+
+    if (res != CBF_RES_OK || val == 0.0)
+      continue;
+
+    // Lower triangular coordinates of the block (k >= l), zero-based
+    k = (i >= j ? i : j) - 1;
+    l = (i >= j ? j : i) - 1;
+
+    if (blockdim[blk-1] >= 1) {
+      dim = blockdim[blk-1];
+      if (l < 0 || k >= dim) {
+        res = CBF_RES_ERR;
+
+      } else if (mat == 0) {
+        if (data->dnnz == dyndata->ddyncap)
+          res = CBFdyn_d_capacitysurplus(dyndata, (dyndata->ddyncap >= 1024 ? dyndata->ddyncap : 1024));
+
+        if (res == CBF_RES_OK)
+          res = CBFdyn_d_add(dyndata, (int) blockmap[blk-1], (int) k, (int) l, -val);
+
+      } else {
+        if (data->hnnz == dyndata->hdyncap)
+          res = CBFdyn_h_capacitysurplus(dyndata, (dyndata->hdyncap >= 1024 ? dyndata->hdyncap : 1024));
+
+        if (res == CBF_RES_OK)
+          res = CBFdyn_h_add(dyndata, (int) blockmap[blk-1], mat - 1, (int) k, (int) l, val);
+      }
+
+    } else {
+      // Diagonal blocks only have diagonal entries, each being a row of a linear map
+      row = blockmap[blk-1];
+      dim = -blockdim[blk-1];
+      if (k != l || l < 0 || k >= dim) {
+        res = CBF_RES_ERR;
+
+      } else if (mat == 0) {
+        if (data->bnnz == dyndata->bdyncap)
+          res = CBFdyn_b_capacitysurplus(dyndata, (dyndata->bdyncap >= 1024 ? dyndata->bdyncap : 1024));
+
+        if (res == CBF_RES_OK)
+          res = CBFdyn_b_add(dyndata, row + k, -val);
+
+      } else {
+        if (data->annz == dyndata->adyncap)
+          res = CBFdyn_a_capacitysurplus(dyndata, (dyndata->adyncap >= 1024 ? dyndata->adyncap : 1024));
+
+        if (res == CBF_RES_OK)
+          res = CBFdyn_a_add(dyndata, row + k, mat - 1, val);
+      }
+    }
+  }
+
+  return res;
+}
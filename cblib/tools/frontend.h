@@ -20,6 +20,7 @@
 #define CBF_FRONTEND_H
 
 #include "cbf-data.h"
+#include "stream.h"
 #include "programmingstyle.h"
 
 typedef void* CBFfrontendmemory;
@@ -29,6 +30,7 @@ typedef struct CBFfrontend_struct {
   const char *name;
   CBFresponsee (*read)(const char *file, CBFdata *data, CBFfrontendmemory *mem);
   void (*clean)(CBFdata *data, CBFfrontendmemory *mem);
+  CBFresponsee (*stream)(const char *file, CBFstream *stream);
 
 } CBFfrontend;
 
@@ -20,41 +20,204 @@
 #include "programmingstyle.h"
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+// Example of a solver-native structure filled directly by the handlers
+typedef struct MINIMALsolver_struct {
+    long long int varnum;
+    long long int mapnum;
+    double *c;
+    long long int *rownnz;
+} MINIMALsolver;
+
+static int
+  readdata(const char *ifile);
+
+static int
+  readhandler(const char *ifile);
+
+static int
+  readlazy(const char *ifile);
+
+static CBFresponsee
+  on_structure(void *userdata, const CBFdata *data);
+
+static CBFresponsee
+  on_objacoord(void *userdata, const long long int *j, const double *v, long long int n);
+
+static CBFresponsee
+  on_acoord(void *userdata, const long long int *i, const long long int *j, const double *v, long long int n);
+
 // -------------------------------------
 // Function definitions
 // -------------------------------------
 
 int main(int argc, char **argv)
+{
+    if (argc <= 1)
+    {
+        printf("\nBad command, syntax is:\n");
+        printf(">> minimalreader [-handler | -lazy] ifile.cbf\n\n");
+    }
+    else if (argc >= 3 && strcmp(argv[1], "-handler") == 0)
+    {
+        readhandler(argv[2]);
+    }
+    else if (argc >= 3 && strcmp(argv[1], "-lazy") == 0)
+    {
+        readlazy(argv[2]);
+    }
+    else
+    {
+        readdata(argv[1]);
+    }
+
+    return 0;
+}
+
+static int readdata(const char *ifile)
 {
     CBFresponsee res = CBF_RES_OK;
     CBFfrontendmemory mem = { 0, };
     CBFdata data = { 0, };
 
-    if (argc <= 1)
+    res = frontend_cbf.read(ifile, &data, &mem);
+
+    if (res != CBF_RES_OK) {
+        printf("Failed to read file: %s\n", ifile);
+    }
+    else
     {
-        printf("\nBad command, syntax is:\n");
-        printf(">> minimalreader ifile.cbf\n\n");
+        printf("CON: %lli, VAR: %lli, PSDCON: %i, PSDVAR: %i\n", data.mapnum, data.varnum, data.psdmapnum, data.psdvarnum);
+    }
+
+    // Clean data structure
+    frontend_cbf.clean(&data, &mem);
+
+    return (res == CBF_RES_OK);
+}
+
+static int readhandler(const char *ifile)
+{
+    CBFresponsee res = CBF_RES_OK;
+    CBFhandler handler = { 0, };
+    MINIMALsolver solver = { 0, };
+    long long int i, maxrownnz = 0;
+
+    // Only handlers of interest are registered
+    handler.userdata     = &solver;
+    handler.on_structure = on_structure;
+    handler.on_objacoord = on_objacoord;
+    handler.on_acoord    = on_acoord;
+
+    res = CBF_readhandler(ifile, &handler);
+
+    if (res != CBF_RES_OK) {
+        printf("Failed to read file: %s\n", ifile);
     }
     else
     {
-        const char * ifile = argv[1];
+        for (i = 0; i < solver.mapnum; ++i)
+            if (solver.rownnz[i] > maxrownnz)
+                maxrownnz = solver.rownnz[i];
+
+        printf("CON: %lli, VAR: %lli, Max nonzeros in a row of A: %lli\n", solver.mapnum, solver.varnum, maxrownnz);
+    }
+
+    // Clean solver structure
+    free(solver.c);
+    free(solver.rownnz);
+
+    return (res == CBF_RES_OK);
+}
 
-        res = frontend_cbf.read(ifile, &data, &mem);
+static int readlazy(const char *ifile)
+{
+    CBFresponsee res = CBF_RES_OK;
+    CBFlazy lazy;
+    const CBFdata *data = NULL;
+    long long int i, expnum = 0, maxrownnz = 0, *rownnz = NULL;
 
-        if (res != CBF_RES_OK) {
-            printf("Failed to read file: %s\n", ifile);
-        }
-        else
-        {
-            printf("CON: %lli, VAR: %lli, PSDCON: %i, PSDVAR: %i\n", data.mapnum, data.varnum, data.psdmapnum, data.psdvarnum);
-        }
+    res = CBF_openlazy(ifile, &lazy);
 
-        // Clean data structure
-        frontend_cbf.clean(&data, &mem);
+    if (res != CBF_RES_OK) {
+        printf("Failed to read file: %s\n", ifile);
+        return 0;
     }
 
-    return 0;
+    // Queries of the structure and block sizes read no coordinates
+    for (i = 0; i < lazy.data.varstacknum; ++i)
+        if (lazy.data.varstackdomain[i] == CBF_CONE_PEXP || lazy.data.varstackdomain[i] == CBF_CONE_DEXP)
+            ++expnum;
+
+    for (i = 0; i < lazy.data.mapstacknum; ++i)
+        if (lazy.data.mapstackdomain[i] == CBF_CONE_PEXP || lazy.data.mapstackdomain[i] == CBF_CONE_DEXP)
+            ++expnum;
+
+    printf("CON: %lli, VAR: %lli, EXP cones: %lli, Nonzeros of A: %lli\n", lazy.data.mapnum, lazy.data.varnum, expnum, lazy.blocknnz[CBF_BLOCK_ACOORD]);
+
+    // Only the coordinates of ACOORD are read
+    res = CBF_lazyblock(&lazy, CBF_BLOCK_ACOORD, &data);
+
+    if (res == CBF_RES_OK) {
+        rownnz = (long long int*) calloc(data->mapnum, sizeof(rownnz[0]));
+        if (data->mapnum >= 1 && !rownnz)
+            res = CBF_RES_ERR;
+    }
+
+    if (res != CBF_RES_OK) {
+        printf("Failed to read file: %s\n", ifile);
+    }
+    else
+    {
+        for (i = 0; i < data->annz; ++i)
+            if (++rownnz[data->asubi[i]] > maxrownnz)
+                maxrownnz = rownnz[data->asubi[i]];
+
+        printf("Max nonzeros in a row of A: %lli\n", maxrownnz);
+    }
+
+    // Clean data structure
+    free(rownnz);
+    CBF_closelazy(&lazy);
+
+    return (res == CBF_RES_OK);
+}
+
+static CBFresponsee on_structure(void *userdata, const CBFdata *data)
+{
+    MINIMALsolver *solver = (MINIMALsolver*) userdata;
+
+    solver->varnum = data->varnum;
+    solver->mapnum = data->mapnum;
+    solver->c      = (double*) calloc(data->varnum, sizeof(solver->c[0]));
+    solver->rownnz = (long long int*) calloc(data->mapnum, sizeof(solver->rownnz[0]));
+
+    if ( (data->varnum >= 1 && !solver->c) || (data->mapnum >= 1 && !solver->rownnz) )
+        return CBF_RES_ERR;
+
+    return CBF_RES_OK;
 }
 
+static CBFresponsee on_objacoord(void *userdata, const long long int *j, const double *v, long long int n)
+{
+    MINIMALsolver *solver = (MINIMALsolver*) userdata;
+    long long int t;
+
+    for (t = 0; t < n; ++t)
+        solver->c[j[t]] = v[t];
+
+    return CBF_RES_OK;
+}
+
+static CBFresponsee on_acoord(void *userdata, const long long int *i, const long long int *j, const double *v, long long int n)
+{
+    MINIMALsolver *solver = (MINIMALsolver*) userdata;
+    long long int t;
+
+    for (t = 0; t < n; ++t)
+        ++solver->rownnz[i[t]];
+
+    return CBF_RES_OK;
+}
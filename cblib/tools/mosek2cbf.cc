@@ -21,6 +21,7 @@
 #include "transform-none.h"
 
 #include "console.h"
+#include "cbf-helper.h"
 
 #include <string>
 #include <stdio.h>
@@ -41,6 +42,8 @@ int main (int argc, char *argv[])
   const char *opath;
   const char *pfix;
   bool verbose;
+  bool stream;
+  long long int memlimit;
   int i;
 
   // For debugging crashes
@@ -62,6 +65,8 @@ int main (int argc, char *argv[])
   opath = NULL;
   pfix  = NULL;
   verbose = false;
+  stream = false;
+  memlimit = 0;
 
   // User defined options
   res = getoptions(argc, argv, plugs_frontend, plugs_backend, plugs_transform,
@@ -70,7 +75,11 @@ int main (int argc, char *argv[])
                    &transform,
                    &opath,
                    &pfix,
-                   &verbose);
+                   &verbose,
+                   &stream,
+                   &memlimit);
+
+  CBF_SORT_MEMLIMIT = memlimit;
 
   if (argc <= 1 || res != CBF_RES_OK)
   {
@@ -87,7 +96,7 @@ int main (int argc, char *argv[])
         ifile = argv[i];
         ofile = swapfiledirandext(ifile, opath, pfix, backend->format);
 
-        res = processfile(frontend, backend, transform, ifile, ofile.c_str(), verbose);
+        res = processfile(frontend, backend, transform, ifile, ofile.c_str(), verbose, stream);
       }
     }
   }
@@ -0,0 +1,281 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "solution-cbf.h"
+#include "cbf-format.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifndef ZLIB_SUPPORT
+typedef FILE CBFFILE;
+#define FOPEN(x,y) fopen(x,y)
+#define FCLOSE(x) fclose(x)
+#define FGETS(x,y,z) fgets(x,y,z)
+#else
+#include <zlib.h>
+typedef struct gzFile_s CBFFILE;
+#define FOPEN(x,y) gzopen(x,y)
+#define FCLOSE(x) gzclose(x)
+#define FGETS(x,y,z) gzgets(z,x,y)
+#endif
+
+// Size of the output buffer used when writing solutions
+#define CBF_SOL_BUFFER  (1 << 20)
+
+static CBFresponsee
+  CBF_fgets(CBFFILE *pFile, long long int *linecount);
+
+static CBFresponsee
+  readCLAIM(CBFFILE *pFile, long long int *linecount, CBFsolution *sol);
+
+static CBFresponsee
+  readVALUES(CBFFILE *pFile, long long int *linecount, long long int *num, double **val, int *pending);
+
+static void
+  writeVALUES(FILE *pFile, const char *keyword, long long int num, const double *val);
+
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+static const char *CBF_SOL_CLAIMS[] = { "INTEGER_OPTIMALITY", "INTEGER_INFEASIBILITY", "UNSTABLE" };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+CBFresponsee CBF_readsol(const char *file, long long int index, CBFsolution *sol)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int linecount = 0, change = 0, *num;
+  double **val;
+  int pending = 0;
+  CBFFILE *pFile = NULL;
+
+  memset(sol, 0, sizeof(*sol));
+
+  pFile = FOPEN(file, "rt");
+  if (!pFile) {
+    return CBF_RES_ERR;
+  }
+
+  while( res==CBF_RES_OK && (pending || CBF_fgets(pFile, &linecount)==CBF_RES_OK) )
+  {
+    pending = 0;
+
+    // Ignore empty lines between blocks
+    if ( sscanf(CBF_LINE_BUFFER, CBF_NAME_FORMAT, CBF_NAME_BUFFER)!=1 )
+      continue;
+
+    if (strcmp(CBF_NAME_BUFFER, "CHANGE") == 0) {
+      if (change++ == index)
+        break;
+      continue;
+    }
+
+    // Skip solutions before the requested one without parsing them
+    if (change < index)
+      continue;
+
+    if (strcmp(CBF_NAME_BUFFER, "CLAIM") == 0) {
+      res = readCLAIM(pFile, &linecount, sol);
+      continue;
+    }
+
+    if (strcmp(CBF_NAME_BUFFER, "PRIMVAR") == 0) {
+      num = &sol->primvarnum;     val = &sol->primvar;
+    } else if (strcmp(CBF_NAME_BUFFER, "PRIMPSDVAR") == 0) {
+      num = &sol->primpsdvarnnz;  val = &sol->primpsdvar;
+    } else if (strcmp(CBF_NAME_BUFFER, "DUALVAR") == 0) {
+      num = &sol->dualvarnum;     val = &sol->dualvar;
+    } else if (strcmp(CBF_NAME_BUFFER, "DUALPSDVAR") == 0) {
+      num = &sol->dualpsdvarnnz;  val = &sol->dualpsdvar;
+    } else {
+      printf("Keyword %s not recognized!\n", CBF_NAME_BUFFER);
+      res = CBF_RES_ERR;
+      continue;
+    }
+
+    if (*val) {
+      printf("Keyword %s also found earlier and can only appear once.\n", CBF_NAME_BUFFER);
+      res = CBF_RES_ERR;
+      continue;
+    }
+
+    res = readVALUES(pFile, &linecount, num, val, &pending);
+  }
+
+  if (res == CBF_RES_OK && change < index) {
+    printf("Solution %lli not found, only %lli solutions in file.\n", index, change + 1);
+    res = CBF_RES_ERR;
+  }
+
+  if (res != CBF_RES_OK) {
+    printf("Failed to parse line: %lli\n", linecount);
+    CBF_cleansol(sol);
+  }
+
+  FCLOSE(pFile);
+  return res;
+}
+
+CBFresponsee CBF_writesol(const char *file, const CBFsolution *sols, long long int solnum)
+{
+  CBFresponsee res = CBF_RES_OK;
+  const CBFsolution *sol;
+  char *buffer = NULL;
+  FILE *pFile = NULL;
+  long long int i;
+
+  pFile = fopen(file, "wt");
+  if (!pFile) {
+    return CBF_RES_ERR;
+  }
+
+  // Values are written one per line, so the default buffer is quickly exhausted
+  buffer = (char*) malloc(CBF_SOL_BUFFER * sizeof(buffer[0]));
+  if (buffer)
+    setvbuf(pFile, buffer, _IOFBF, CBF_SOL_BUFFER);
+
+  for (i=0; i<solnum; ++i) {
+    sol = &sols[i];
+
+    if (i >= 1)
+      fprintf(pFile, "CHANGE\n\n");
+
+    if (sol->claim[0] != '\0')
+      fprintf(pFile, "CLAIM\n%s\n\n", sol->claim);
+
+    writeVALUES(pFile, "PRIMVAR", sol->primvarnum, sol->primvar);
+    writeVALUES(pFile, "PRIMPSDVAR", sol->primpsdvarnnz, sol->primpsdvar);
+    writeVALUES(pFile, "DUALVAR", sol->dualvarnum, sol->dualvar);
+    writeVALUES(pFile, "DUALPSDVAR", sol->dualpsdvarnnz, sol->dualpsdvar);
+  }
+
+  if (ferror(pFile))
+    res = CBF_RES_ERR;
+
+  if (fclose(pFile) != 0)
+    res = CBF_RES_ERR;
+
+  free(buffer);
+  return res;
+}
+
+void CBF_cleansol(CBFsolution *sol)
+{
+  free(sol->primvar);
+  free(sol->primpsdvar);
+  free(sol->dualvar);
+  free(sol->dualpsdvar);
+  memset(sol, 0, sizeof(*sol));
+}
+
+static CBFresponsee CBF_fgets(CBFFILE *pFile, long long int *linecount)
+{
+  // Find first non-commentary line
+  while( FGETS(CBF_LINE_BUFFER, sizeof(CBF_LINE_BUFFER), pFile) != NULL ) {
+    ++(*linecount);
+
+    if (CBF_LINE_BUFFER[0] != '#')
+      return CBF_RES_OK;
+  }
+
+  return CBF_RES_ERR;
+}
+
+static CBFresponsee readCLAIM(CBFFILE *pFile, long long int *linecount, CBFsolution *sol)
+{
+  CBFresponsee res = CBF_RES_OK;
+  size_t i;
+
+  if (sol->claim[0] != '\0') {
+    printf("Keyword CLAIM also found earlier and can only appear once.\n");
+    return CBF_RES_ERR;
+  }
+
+  res = CBF_fgets(pFile, linecount);
+
+  if (res == CBF_RES_OK)
+    if (sscanf(CBF_LINE_BUFFER, CBF_NAME_FORMAT, CBF_NAME_BUFFER) != 1)
+      res = CBF_RES_ERR;
+
+  if (res == CBF_RES_OK) {
+    res = CBF_RES_ERR;
+    for (i=0; i<sizeof(CBF_SOL_CLAIMS)/sizeof(CBF_SOL_CLAIMS[0]); ++i) {
+      if (strcmp(CBF_NAME_BUFFER, CBF_SOL_CLAIMS[i]) == 0) {
+        strcpy(sol->claim, CBF_SOL_CLAIMS[i]);
+        res = CBF_RES_OK;
+      }
+    }
+
+    if (res != CBF_RES_OK)
+      printf("Claim %s is not valid.\n", CBF_NAME_BUFFER);
+  }
+
+  return res;
+}
+
+static CBFresponsee readVALUES(CBFFILE *pFile, long long int *linecount, long long int *num, double **val, int *pending)
+{
+  long long int cap = 0;
+  double value, *tmp;
+  char *end;
+
+  *num = 0;
+
+  // The block ends at the first line that is not a value (empty line, keyword or end of file)
+  while (CBF_fgets(pFile, linecount) == CBF_RES_OK)
+  {
+    value = strtod(CBF_LINE_BUFFER, &end);
+    if (end == CBF_LINE_BUFFER) {
+      *pending = 1;
+      break;
+    }
+
+    if (*num == cap) {
+      cap = (cap >= 1 ? 2*cap : 1024);
+      tmp = (double*) realloc(*val, cap * sizeof(tmp[0]));
+      if (!tmp) {
+        printf("Out of memory.\n");
+        return CBF_RES_ERR;
+      }
+      *val = tmp;
+    }
+
+    (*val)[(*num)++] = value;
+  }
+
+  return CBF_RES_OK;
+}
+
+static void writeVALUES(FILE *pFile, const char *keyword, long long int num, const double *val)
+{
+  long long int i;
+
+  if (num >= 1) {
+    fprintf(pFile, "%s\n", keyword);
+    for (i=0; i<num; ++i)
+      fprintf(pFile, "%.16g\n", val[i]);
+    fprintf(pFile, "\n");
+  }
+}
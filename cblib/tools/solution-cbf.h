@@ -0,0 +1,58 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#ifndef CBF_SOLUTION_CBF_H
+#define CBF_SOLUTION_CBF_H
+
+#include "cbf-data.h"
+#include "programmingstyle.h"
+
+/*
+ * Solution as found in a .sol file, between CHANGE separators.
+ *
+ * The values of all PSD variables are concatenated, each given by the lower
+ * triangular part of the matrix, row by row, i.e., entry (k,l) with k >= l
+ * is found at offset k*(k+1)/2 + l. The claim is an empty string if absent.
+ */
+typedef struct CBFsolution_struct {
+
+  char claim[CBF_MAX_NAME];
+
+  long long int primvarnum;
+  double *primvar;
+
+  long long int primpsdvarnnz;
+  double *primpsdvar;
+
+  long long int dualvarnum;
+  double *dualvar;
+
+  long long int dualpsdvarnnz;
+  double *dualpsdvar;
+
+} CBFsolution;
+
+// Read solution number 'index' (counting CHANGE separators from 0)
+CBFresponsee CBF_readsol(const char *file, long long int index, CBFsolution *sol);
+
+// Write 'solnum' solutions separated by CHANGE
+CBFresponsee CBF_writesol(const char *file, const CBFsolution *sols, long long int solnum);
+
+void CBF_cleansol(CBFsolution *sol);
+
+#endif
@@ -0,0 +1,724 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "split-cbf.h"
+#include "cbf-helper.h"
+#include "cbf-format.h"
+
+#include <algorithm>
+#include <vector>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+static long long int
+  findroot(std::vector<long long int> &parent, long long int i);
+
+static void
+  unite(std::vector<long long int> &parent, std::vector<long long int> &size, long long int i, long long int j);
+
+static long long int
+  growth(long long int num, long long int cap);
+
+static CBFresponsee
+  allocsplit(CBFsplit *split);
+
+static void
+  localindex(long long int partnum, long long int num, const long long int *part, std::vector<long long int> &loc);
+
+static CBFresponsee
+  mergevalues(long long int partnum, long long int num, const long long int *part, const std::vector<long long int> &len,
+              const std::vector<long long int> &partnnz, const std::vector<const double*> &partval, long long int *nnz, double **val);
+
+static CBFresponsee
+  readline(FILE *pFile, long long int *linecount);
+
+static CBFresponsee
+  readheader(FILE *pFile, long long int *linecount, const char *keyword, long long int *num);
+
+static CBFresponsee
+  readparts(FILE *pFile, long long int *linecount, long long int partnum, long long int num, long long int *part, int *dim);
+
+static void
+  writeparts(FILE *pFile, const char *keyword, long long int num, const long long int *part, const int *dim);
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+CBFresponsee CBF_split(const CBFdata *data, CBFsplit *split)
+{
+  CBFresponsee res = CBF_RES_OK;
+  const long long int psdvarbeg = data->varnum;
+  const long long int mapbeg    = psdvarbeg + data->psdvarnum;
+  const long long int psdmapbeg = mapbeg + data->mapnum;
+  const long long int nodenum   = psdmapbeg + data->psdmapnum;
+  long long int i, j, k, r, rest = -1;
+
+  memset(split, 0, sizeof(*split));
+
+  //
+  // Variables, psdvars, maps and psdmaps are the nodes of the graph, in this
+  // order, and are united whenever a coordinate or a cone connects them.
+  //
+  std::vector<long long int> parent(nodenum), size(nodenum, 1), rootpart(nodenum, -1);
+
+  for (i=0; i<nodenum; ++i)
+    parent[i] = i;
+
+  for (r=0, k=0; r<data->varstacknum; k += data->varstackdim[r++])
+    if (data->varstackdomain[r] > CBF_CONE_ZERO)
+      for (j=k+1; j<k+data->varstackdim[r]; ++j)
+        unite(parent, size, k, j);
+
+  for (r=0, k=0; r<data->mapstacknum; k += data->mapstackdim[r++])
+    if (data->mapstackdomain[r] > CBF_CONE_ZERO)
+      for (i=k+1; i<k+data->mapstackdim[r]; ++i)
+        unite(parent, size, mapbeg + k, mapbeg + i);
+
+  for (k=0; k<data->annz; ++k)
+    unite(parent, size, mapbeg + data->asubi[k], data->asubj[k]);
+
+  for (k=0; k<data->fnnz; ++k)
+    unite(parent, size, mapbeg + data->fsubi[k], psdvarbeg + data->fsubj[k]);
+
+  for (k=0; k<data->hnnz; ++k)
+    unite(parent, size, psdmapbeg + data->hsubi[k], data->hsubj[k]);
+
+  split->varnum    = data->varnum;
+  split->psdvarnum = data->psdvarnum;
+  split->mapnum    = data->mapnum;
+  split->psdmapnum = data->psdmapnum;
+
+  res = allocsplit(split);
+
+  // Parts are numbered in order of appearance, and isolated nodes share one
+  if ( res == CBF_RES_OK ) {
+    for (i=0; i<nodenum; ++i) {
+      r = findroot(parent, i);
+
+      if (size[r] == 1) {
+        if (rest < 0)
+          rest = split->partnum++;
+        k = rest;
+      } else {
+        if (rootpart[r] < 0)
+          rootpart[r] = split->partnum++;
+        k = rootpart[r];
+      }
+
+      if (i < psdvarbeg)
+        split->varpart[i] = k;
+      else if (i < mapbeg)
+        split->psdvarpart[i - psdvarbeg] = k;
+      else if (i < psdmapbeg)
+        split->mappart[i - mapbeg] = k;
+      else
+        split->psdmappart[i - psdmapbeg] = k;
+    }
+
+    for (j=0; j<data->psdvarnum; ++j)
+      split->psdvardim[j] = data->psdvardim[j];
+
+    for (i=0; i<data->psdmapnum; ++i)
+      split->psdmapdim[i] = data->psdmapdim[i];
+  }
+
+  if ( res != CBF_RES_OK )
+    CBF_cleansplit(split);
+
+  return res;
+}
+
+CBFresponsee CBF_splitdata(const CBFdata *data, const CBFsplit *split, CBFdata *parts)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFdyndata *dyn;
+  CBFdata *part;
+  long long int i, j, k, r, p, step, stacknum;
+  std::vector<CBFdyndata> dyndata(split->partnum);
+  std::vector<long long int> varloc, psdvarloc, maploc, psdmaploc;
+  std::vector< std::vector<long long int> > varparam(split->partnum), mapparam(split->partnum);
+
+  localindex(split->partnum, data->varnum, split->varpart, varloc);
+  localindex(split->partnum, data->psdvarnum, split->psdvarpart, psdvarloc);
+  localindex(split->partnum, data->mapnum, split->mappart, maploc);
+  localindex(split->partnum, data->psdmapnum, split->psdmappart, psdmaploc);
+
+  //
+  // Members keep their order within a part, so coordinates sorted row-major
+  // stay sorted. Parameters of power cones are borrowed by all parts.
+  //
+  for (p=0; p<split->partnum && res==CBF_RES_OK; ++p) {
+    part = &parts[p];
+    part->ver          = data->ver;
+    part->objsense     = data->objsense;
+    part->powconenum   = data->powconenum;
+    part->powalphanum  = data->powalphanum;
+    part->powalphabeg  = data->powalphabeg;
+    part->powalpha     = data->powalpha;
+    part->dpowconenum  = data->dpowconenum;
+    part->dpowalphanum = data->dpowalphanum;
+    part->dpowalphabeg = data->dpowalphabeg;
+    part->dpowalpha    = data->dpowalpha;
+
+    res = CBFdyn_assign(&dyndata[p], part);
+
+    if ( res == CBF_RES_OK && data->varname ) {
+      part->varname = (CBFnametable*) calloc(1, sizeof(*part->varname));
+      if (!part->varname)
+        res = CBF_RES_ERR;
+    }
+
+    if ( res == CBF_RES_OK && data->mapname ) {
+      part->mapname = (CBFnametable*) calloc(1, sizeof(*part->mapname));
+      if (!part->mapname)
+        res = CBF_RES_ERR;
+    }
+  }
+
+  // Cones go to their part as a whole, and linear domains one member at a time
+  for (r=0, k=0; r<data->varstacknum && res==CBF_RES_OK; k += data->varstackdim[r++]) {
+    step = (data->varstackdomain[r] > CBF_CONE_ZERO ? data->varstackdim[r] : 1);
+
+    for (j=k; j<k+data->varstackdim[r] && res==CBF_RES_OK; j += step) {
+      p = split->varpart[j];
+      dyn = &dyndata[p];
+      stacknum = dyn->data->varstacknum;
+
+      res = CBFdyn_var_capacitysurplus(dyn, growth(stacknum, dyn->varstackdyncap));
+
+      if ( res == CBF_RES_OK )
+        res = CBFdyn_var_adddomain(dyn, data->varstackdomain[r], step);
+
+      if ( res == CBF_RES_OK && dyn->data->varstacknum > stacknum )
+        varparam[p].push_back(data->varstackparam ? data->varstackparam[r] : -1);
+    }
+  }
+
+  for (r=0, k=0; r<data->mapstacknum && res==CBF_RES_OK; k += data->mapstackdim[r++]) {
+    step = (data->mapstackdomain[r] > CBF_CONE_ZERO ? data->mapstackdim[r] : 1);
+
+    for (i=k; i<k+data->mapstackdim[r] && res==CBF_RES_OK; i += step) {
+      p = split->mappart[i];
+      dyn = &dyndata[p];
+      stacknum = dyn->data->mapstacknum;
+
+      res = CBFdyn_map_capacitysurplus(dyn, growth(stacknum, dyn->mapstackdyncap));
+
+      if ( res == CBF_RES_OK )
+        res = CBFdyn_map_adddomain(dyn, data->mapstackdomain[r], step);
+
+      if ( res == CBF_RES_OK && dyn->data->mapstacknum > stacknum )
+        mapparam[p].push_back(data->mapstackparam ? data->mapstackparam[r] : -1);
+    }
+  }
+
+  // Cone parameters are only kept if any stack has some
+  for (p=0; p<split->partnum && res==CBF_RES_OK; ++p) {
+    part = &parts[p];
+
+    if (data->varstackparam && part->varstacknum >= 1) {
+      part->varstackparam = (long long int*) malloc(part->varstacknum * sizeof(part->varstackparam[0]));
+      if (part->varstackparam)
+        std::copy(varparam[p].begin(), varparam[p].end(), part->varstackparam);
+      else
+        res = CBF_RES_ERR;
+    }
+
+    if (res == CBF_RES_OK && data->mapstackparam && part->mapstacknum >= 1) {
+      part->mapstackparam = (long long int*) malloc(part->mapstacknum * sizeof(part->mapstackparam[0]));
+      if (part->mapstackparam)
+        std::copy(mapparam[p].begin(), mapparam[p].end(), part->mapstackparam);
+      else
+        res = CBF_RES_ERR;
+    }
+  }
+
+  for (k=0; k<data->intvarnum && res==CBF_RES_OK; ++k) {
+    dyn = &dyndata[split->varpart[data->intvar[k]]];
+    res = CBFdyn_intvar_capacitysurplus(dyn, growth(dyn->data->intvarnum, dyn->intvardyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_intvar_add(dyn, varloc[data->intvar[k]]);
+  }
+
+  for (j=0; j<data->psdvarnum && res==CBF_RES_OK; ++j) {
+    dyn = &dyndata[split->psdvarpart[j]];
+    res = CBFdyn_psdvar_capacitysurplus(dyn, (int) growth(dyn->data->psdvarnum, dyn->psdvardyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_psdvar_add(dyn, data->psdvardim[j]);
+  }
+
+  for (i=0; i<data->psdmapnum && res==CBF_RES_OK; ++i) {
+    dyn = &dyndata[split->psdmappart[i]];
+    res = CBFdyn_psdmap_capacitysurplus(dyn, (int) growth(dyn->data->psdmapnum, dyn->psdmapdyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_psdmap_add(dyn, data->psdmapdim[i]);
+  }
+
+  if ( res == CBF_RES_OK && data->varname )
+    for (j=0; j<data->varnum && res==CBF_RES_OK; ++j)
+      res = CBFnametable_push(parts[split->varpart[j]].varname, CBFnametable_name(data->varname, j));
+
+  if ( res == CBF_RES_OK && data->mapname )
+    for (i=0; i<data->mapnum && res==CBF_RES_OK; ++i)
+      res = CBFnametable_push(parts[split->mappart[i]].mapname, CBFnametable_name(data->mapname, i));
+
+  // The constant of the objective goes to the first part
+  if ( res == CBF_RES_OK && split->partnum >= 1 )
+    res = CBFdyn_objb_set(&dyndata[0], data->objbval);
+
+  for (k=0; k<data->objfnnz && res==CBF_RES_OK; ++k) {
+    dyn = &dyndata[split->psdvarpart[data->objfsubj[k]]];
+    res = CBFdyn_objf_capacitysurplus(dyn, growth(dyn->data->objfnnz, dyn->objfdyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_objf_add(dyn, psdvarloc[data->objfsubj[k]], data->objfsubk[k], data->objfsubl[k], data->objfval[k]);
+  }
+
+  for (k=0; k<data->objannz && res==CBF_RES_OK; ++k) {
+    dyn = &dyndata[split->varpart[data->objasubj[k]]];
+    res = CBFdyn_obja_capacitysurplus(dyn, growth(dyn->data->objannz, dyn->objadyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_obja_add(dyn, varloc[data->objasubj[k]], data->objaval[k]);
+  }
+
+  for (k=0; k<data->fnnz && res==CBF_RES_OK; ++k) {
+    dyn = &dyndata[split->mappart[data->fsubi[k]]];
+    res = CBFdyn_f_capacitysurplus(dyn, growth(dyn->data->fnnz, dyn->fdyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_f_add(dyn, maploc[data->fsubi[k]], psdvarloc[data->fsubj[k]], data->fsubk[k], data->fsubl[k], data->fval[k]);
+  }
+
+  for (k=0; k<data->annz && res==CBF_RES_OK; ++k) {
+    dyn = &dyndata[split->mappart[data->asubi[k]]];
+    res = CBFdyn_a_capacitysurplus(dyn, growth(dyn->data->annz, dyn->adyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_a_add(dyn, maploc[data->asubi[k]], varloc[data->asubj[k]], data->aval[k]);
+  }
+
+  for (k=0; k<data->bnnz && res==CBF_RES_OK; ++k) {
+    dyn = &dyndata[split->mappart[data->bsubi[k]]];
+    res = CBFdyn_b_capacitysurplus(dyn, growth(dyn->data->bnnz, dyn->bdyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_b_add(dyn, maploc[data->bsubi[k]], data->bval[k]);
+  }
+
+  for (k=0; k<data->hnnz && res==CBF_RES_OK; ++k) {
+    dyn = &dyndata[split->psdmappart[data->hsubi[k]]];
+    res = CBFdyn_h_capacitysurplus(dyn, growth(dyn->data->hnnz, dyn->hdyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_h_add(dyn, psdmaploc[data->hsubi[k]], varloc[data->hsubj[k]], data->hsubk[k], data->hsubl[k], data->hval[k]);
+  }
+
+  for (k=0; k<data->dnnz && res==CBF_RES_OK; ++k) {
+    dyn = &dyndata[split->psdmappart[data->dsubi[k]]];
+    res = CBFdyn_d_capacitysurplus(dyn, growth(dyn->data->dnnz, dyn->ddyncap));
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_d_add(dyn, psdmaploc[data->dsubi[k]], data->dsubk[k], data->dsubl[k], data->dval[k]);
+  }
+
+  return res;
+}
+
+void CBF_cleansplitdata(const CBFsplit *split, CBFdata *parts)
+{
+  CBFdyndata dyndata;
+  long long int p;
+
+  for (p=0; p<split->partnum; ++p) {
+    CBFdyn_assign(&dyndata, &parts[p]);
+    CBFdyn_freedynamicallocations(&dyndata);
+
+    free(parts[p].varstackparam);
+    free(parts[p].mapstackparam);
+
+    if (parts[p].varname) {
+      CBFnametable_free(parts[p].varname);
+      free(parts[p].varname);
+    }
+
+    if (parts[p].mapname) {
+      CBFnametable_free(parts[p].mapname);
+      free(parts[p].mapname);
+    }
+
+    // Parameters of power cones are borrowed
+    memset(&parts[p], 0, sizeof(parts[p]));
+  }
+}
+
+CBFresponsee CBF_mergesol(const CBFsplit *split, const CBFsolution *parts, CBFsolution *sol)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, j, p;
+  int infeasible = 0, unstable = 0, optimal = (split->partnum >= 1);
+  std::vector<long long int> len, partnnz(split->partnum);
+  std::vector<const double*> partval(split->partnum);
+
+  memset(sol, 0, sizeof(*sol));
+
+  //
+  // The problem is infeasible if any part is, and otherwise no more
+  // certain of its solution than the least certain part.
+  //
+  for (p=0; p<split->partnum; ++p) {
+    if (strcmp(parts[p].claim, "INTEGER_INFEASIBILITY") == 0)
+      infeasible = 1;
+    else if (strcmp(parts[p].claim, "UNSTABLE") == 0)
+      unstable = 1;
+    else if (strcmp(parts[p].claim, "INTEGER_OPTIMALITY") != 0)
+      optimal = 0;
+  }
+
+  if (infeasible)
+    strcpy(sol->claim, "INTEGER_INFEASIBILITY");
+  else if (unstable)
+    strcpy(sol->claim, "UNSTABLE");
+  else if (optimal)
+    strcpy(sol->claim, "INTEGER_OPTIMALITY");
+
+  // Scalar values
+  len.assign(std::max(split->varnum, split->mapnum), 1);
+
+  for (p=0; p<split->partnum; ++p) {
+    partnnz[p] = parts[p].primvarnum;
+    partval[p] = parts[p].primvar;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = mergevalues(split->partnum, split->varnum, split->varpart, len, partnnz, partval, &sol->primvarnum, &sol->primvar);
+
+  for (p=0; p<split->partnum; ++p) {
+    partnnz[p] = parts[p].dualvarnum;
+    partval[p] = parts[p].dualvar;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = mergevalues(split->partnum, split->mapnum, split->mappart, len, partnnz, partval, &sol->dualvarnum, &sol->dualvar);
+
+  // Lower triangular parts of semidefinite values
+  len.resize(split->psdvarnum);
+  for (j=0; j<split->psdvarnum; ++j)
+    len[j] = (long long int) split->psdvardim[j] * (split->psdvardim[j] + 1) / 2;
+
+  for (p=0; p<split->partnum; ++p) {
+    partnnz[p] = parts[p].primpsdvarnnz;
+    partval[p] = parts[p].primpsdvar;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = mergevalues(split->partnum, split->psdvarnum, split->psdvarpart, len, partnnz, partval, &sol->primpsdvarnnz, &sol->primpsdvar);
+
+  len.resize(split->psdmapnum);
+  for (i=0; i<split->psdmapnum; ++i)
+    len[i] = (long long int) split->psdmapdim[i] * (split->psdmapdim[i] + 1) / 2;
+
+  for (p=0; p<split->partnum; ++p) {
+    partnnz[p] = parts[p].dualpsdvarnnz;
+    partval[p] = parts[p].dualpsdvar;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = mergevalues(split->partnum, split->psdmapnum, split->psdmappart, len, partnnz, partval, &sol->dualpsdvarnnz, &sol->dualpsdvar);
+
+  if ( res != CBF_RES_OK )
+    CBF_cleansol(sol);
+
+  return res;
+}
+
+CBFresponsee CBF_readsplit(const char *file, CBFsplit *split)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int linecount = 0, num;
+  FILE *pFile = NULL;
+
+  memset(split, 0, sizeof(*split));
+
+  pFile = fopen(file, "rt");
+  if (!pFile) {
+    return CBF_RES_ERR;
+  }
+
+  // Blocks are all present and in the order written
+  res = readheader(pFile, &linecount, "PARTS", &split->partnum);
+
+  if ( res == CBF_RES_OK )
+    res = readheader(pFile, &linecount, "VAR", &split->varnum);
+
+  if ( res == CBF_RES_OK ) {
+    split->varpart = (long long int*) malloc(split->varnum * sizeof(split->varpart[0]));
+    if (split->varnum >= 1 && !split->varpart)
+      res = CBF_RES_ERR;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = readparts(pFile, &linecount, split->partnum, split->varnum, split->varpart, NULL);
+
+  if ( res == CBF_RES_OK )
+    res = readheader(pFile, &linecount, "PSDVAR", &num);
+
+  if ( res == CBF_RES_OK ) {
+    split->psdvarnum = (int) num;
+    split->psdvarpart = (long long int*) malloc(num * sizeof(split->psdvarpart[0]));
+    split->psdvardim = (int*) malloc(num * sizeof(split->psdvardim[0]));
+    if (num >= 1 && (!split->psdvarpart || !split->psdvardim))
+      res = CBF_RES_ERR;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = readparts(pFile, &linecount, split->partnum, split->psdvarnum, split->psdvarpart, split->psdvardim);
+
+  if ( res == CBF_RES_OK )
+    res = readheader(pFile, &linecount, "CON", &split->mapnum);
+
+  if ( res == CBF_RES_OK ) {
+    split->mappart = (long long int*) malloc(split->mapnum * sizeof(split->mappart[0]));
+    if (split->mapnum >= 1 && !split->mappart)
+      res = CBF_RES_ERR;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = readparts(pFile, &linecount, split->partnum, split->mapnum, split->mappart, NULL);
+
+  if ( res == CBF_RES_OK )
+    res = readheader(pFile, &linecount, "PSDCON", &num);
+
+  if ( res == CBF_RES_OK ) {
+    split->psdmapnum = (int) num;
+    split->psdmappart = (long long int*) malloc(num * sizeof(split->psdmappart[0]));
+    split->psdmapdim = (int*) malloc(num * sizeof(split->psdmapdim[0]));
+    if (num >= 1 && (!split->psdmappart || !split->psdmapdim))
+      res = CBF_RES_ERR;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = readparts(pFile, &linecount, split->partnum, split->psdmapnum, split->psdmappart, split->psdmapdim);
+
+  if (res != CBF_RES_OK) {
+    printf("Failed to parse line: %lli\n", linecount);
+    CBF_cleansplit(split);
+  }
+
+  fclose(pFile);
+  return res;
+}
+
+CBFresponsee CBF_writesplit(const char *file, const CBFsplit *split)
+{
+  CBFresponsee res = CBF_RES_OK;
+  FILE *pFile = NULL;
+
+  pFile = fopen(file, "wt");
+  if (!pFile) {
+    return CBF_RES_ERR;
+  }
+
+  fprintf(pFile, "PARTS\n%lli\n\n", split->partnum);
+
+  writeparts(pFile, "VAR", split->varnum, split->varpart, NULL);
+  writeparts(pFile, "PSDVAR", split->psdvarnum, split->psdvarpart, split->psdvardim);
+  writeparts(pFile, "CON", split->mapnum, split->mappart, NULL);
+  writeparts(pFile, "PSDCON", split->psdmapnum, split->psdmappart, split->psdmapdim);
+
+  if (ferror(pFile))
+    res = CBF_RES_ERR;
+
+  if (fclose(pFile) != 0)
+    res = CBF_RES_ERR;
+
+  return res;
+}
+
+void CBF_cleansplit(CBFsplit *split)
+{
+  free(split->varpart);
+  free(split->psdvardim);
+  free(split->psdvarpart);
+  free(split->mappart);
+  free(split->psdmapdim);
+  free(split->psdmappart);
+  memset(split, 0, sizeof(*split));
+}
+
+static long long int findroot(std::vector<long long int> &parent, long long int i)
+{
+  // Path halving
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
+}
+
+static void unite(std::vector<long long int> &parent, std::vector<long long int> &size, long long int i, long long int j)
+{
+  // Union by size
+  i = findroot(parent, i);
+  j = findroot(parent, j);
+
+  if (i != j) {
+    if (size[i] < size[j])
+      std::swap(i, j);
+
+    parent[j] = i;
+    size[i] += size[j];
+  }
+}
+
+static long long int growth(long long int num, long long int cap)
+{
+  // Room for one more element, doubling the capacity when exhausted
+  if (num < cap)
+    return 0;
+
+  return std::max(num, 16LL);
+}
+
+static CBFresponsee allocsplit(CBFsplit *split)
+{
+  split->varpart    = (long long int*) malloc(split->varnum * sizeof(split->varpart[0]));
+  split->psdvarpart = (long long int*) malloc(split->psdvarnum * sizeof(split->psdvarpart[0]));
+  split->psdvardim  = (int*) malloc(split->psdvarnum * sizeof(split->psdvardim[0]));
+  split->mappart    = (long long int*) malloc(split->mapnum * sizeof(split->mappart[0]));
+  split->psdmappart = (long long int*) malloc(split->psdmapnum * sizeof(split->psdmappart[0]));
+  split->psdmapdim  = (int*) malloc(split->psdmapnum * sizeof(split->psdmapdim[0]));
+
+  if ( (split->varnum >= 1 && !split->varpart) ||
+       (split->psdvarnum >= 1 && (!split->psdvarpart || !split->psdvardim)) ||
+       (split->mapnum >= 1 && !split->mappart) ||
+       (split->psdmapnum >= 1 && (!split->psdmappart || !split->psdmapdim)) )
+    return CBF_RES_ERR;
+
+  return CBF_RES_OK;
+}
+
+static void localindex(long long int partnum, long long int num, const long long int *part, std::vector<long long int> &loc)
+{
+  std::vector<long long int> count(partnum, 0);
+  long long int i;
+
+  loc.resize(num);
+  for (i=0; i<num; ++i)
+    loc[i] = count[part[i]]++;
+}
+
+static CBFresponsee mergevalues(long long int partnum, long long int num, const long long int *part, const std::vector<long long int> &len,
+                                const std::vector<long long int> &partnnz, const std::vector<const double*> &partval, long long int *nnz, double **val)
+{
+  std::vector<long long int> pos(partnum, 0);
+  long long int i, k, p, total = 0;
+  int complete = 1;
+
+  for (i=0; i<num; ++i) {
+    pos[part[i]] += len[i];
+    total += len[i];
+  }
+
+  // Values are only merged if given by all parts, as a part may have no solution
+  for (p=0; p<partnum; ++p) {
+    if (partnnz[p] != pos[p]) {
+      if (partnnz[p] >= 1) {
+        printf("Solution of part %lli has %lli values, but %lli were expected.\n", p, partnnz[p], pos[p]);
+        return CBF_RES_ERR;
+      }
+      complete = 0;
+    }
+    pos[p] = 0;
+  }
+
+  if (!complete || total == 0)
+    return CBF_RES_OK;
+
+  *val = (double*) malloc(total * sizeof((*val)[0]));
+  if (!*val)
+    return CBF_RES_ERR;
+
+  for (i=0, k=0; i<num; k += len[i++]) {
+    p = part[i];
+    std::copy(partval[p] + pos[p], partval[p] + pos[p] + len[i], *val + k);
+    pos[p] += len[i];
+  }
+
+  *nnz = total;
+  return CBF_RES_OK;
+}
+
+static CBFresponsee readline(FILE *pFile, long long int *linecount)
+{
+  // Find first line that is neither commentary nor empty
+  while( fgets(CBF_LINE_BUFFER, sizeof(CBF_LINE_BUFFER), pFile) != NULL ) {
+    ++(*linecount);
+
+    if (CBF_LINE_BUFFER[0] != '#' && sscanf(CBF_LINE_BUFFER, CBF_NAME_FORMAT, CBF_NAME_BUFFER) == 1)
+      return CBF_RES_OK;
+  }
+
+  return CBF_RES_ERR;
+}
+
+static CBFresponsee readheader(FILE *pFile, long long int *linecount, const char *keyword, long long int *num)
+{
+  if (readline(pFile, linecount) != CBF_RES_OK || strcmp(CBF_NAME_BUFFER, keyword) != 0) {
+    printf("Keyword %s expected.\n", keyword);
+    return CBF_RES_ERR;
+  }
+
+  if (readline(pFile, linecount) != CBF_RES_OK || sscanf(CBF_LINE_BUFFER, "%lli", num) != 1 || *num < 0)
+    return CBF_RES_ERR;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee readparts(FILE *pFile, long long int *linecount, long long int partnum, long long int num, long long int *part, int *dim)
+{
+  long long int i;
+
+  for (i=0; i<num; ++i) {
+    if (readline(pFile, linecount) != CBF_RES_OK)
+      return CBF_RES_ERR;
+
+    if (dim) {
+      if (sscanf(CBF_LINE_BUFFER, "%lli %i", &part[i], &dim[i]) != 2 || dim[i] < 1)
+        return CBF_RES_ERR;
+    } else {
+      if (sscanf(CBF_LINE_BUFFER, "%lli", &part[i]) != 1)
+        return CBF_RES_ERR;
+    }
+
+    if (part[i] < 0 || part[i] >= partnum)
+      return CBF_RES_ERR;
+  }
+
+  return CBF_RES_OK;
+}
+
+static void writeparts(FILE *pFile, const char *keyword, long long int num, const long long int *part, const int *dim)
+{
+  long long int i;
+
+  fprintf(pFile, "%s\n%lli\n", keyword, num);
+  for (i=0; i<num; ++i) {
+    if (dim)
+      fprintf(pFile, "%lli %i\n", part[i], dim[i]);
+    else
+      fprintf(pFile, "%lli\n", part[i]);
+  }
+  fprintf(pFile, "\n");
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#ifndef CBF_SPLIT_CBF_H
+#define CBF_SPLIT_CBF_H
+
+#include "cbf-data.h"
+#include "solution-cbf.h"
+#include "programmingstyle.h"
+
+/*
+ * Partition of a problem into independent parts, i.e., the connected
+ * components of the graph between variables and maps that have coordinates
+ * in common (ACOORD, FCOORD and HCOORD), where the members of a cone (other
+ * than F, L+, L- and L=) are also kept together. Components of a single
+ * variable or map are gathered in one part, rather than one part each.
+ *
+ * Variable j belongs to part varpart[j], and is the k'th variable of that
+ * part if k variables of lower index belong to it as well. Likewise for
+ * psdvars, maps and psdmaps, where the dimensions are kept to tell the sizes
+ * of their values in a solution.
+ */
+typedef struct CBFsplit_struct {
+
+  long long int partnum;
+
+  long long int varnum;
+  long long int *varpart;
+
+  int psdvarnum;
+  int *psdvardim;
+  long long int *psdvarpart;
+
+  long long int mapnum;
+  long long int *mappart;
+
+  int psdmapnum;
+  int *psdmapdim;
+  long long int *psdmappart;
+
+} CBFsplit;
+
+// Find the parts by union-find in near-linear time
+CBFresponsee CBF_split(const CBFdata *data, CBFsplit *split);
+
+// Build the problem of each part (an array of split->partnum zero-initialized problems)
+CBFresponsee CBF_splitdata(const CBFdata *data, const CBFsplit *split, CBFdata *parts);
+
+void CBF_cleansplitdata(const CBFsplit *split, CBFdata *parts);
+
+// Merge the solutions of all parts into a solution of the problem
+CBFresponsee CBF_mergesol(const CBFsplit *split, const CBFsolution *parts, CBFsolution *sol);
+
+// Read and write the partition, needed to merge solutions, as a .split file
+CBFresponsee CBF_readsplit(const char *file, CBFsplit *split);
+
+CBFresponsee CBF_writesplit(const char *file, const CBFsplit *split);
+
+void CBF_cleansplit(CBFsplit *split);
+
+#endif
@@ -0,0 +1,69 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#ifndef CBF_STREAM_H
+#define CBF_STREAM_H
+
+#include "cbf-data.h"
+#include "programmingstyle.h"
+
+// Maximal number of coordinates delivered in one chunk
+#define CBF_STREAM_CHUNK  65536
+
+
+/*
+ * The CBFstream structure is a chain of callbacks through which
+ * a problem can be passed without ever being held in memory as a whole.
+ *
+ * 'structure' is called once with all structural information (VER,
+ * OBJSENSE, PSDVAR, VAR, INT, PSDCON and CON), before any coordinates.
+ * It is owned by the caller and must not be modified, as the caller keeps
+ * validating coordinates against it. Transformations should instead pass
+ * a modified copy further down the chain.
+ *
+ * Each coordinate block is then announced by 'blockbegin' with its total
+ * number of nonzeros, and delivered in one or more calls to 'blockchunk'
+ * followed by 'blockend'. A chunk is a CBFdata structure in which only the
+ * coordinates of the current block are set (e.g., annz, asubi, asubj and
+ * aval for CBF_BLOCK_ACOORD). The chunk is owned by the caller and is only
+ * valid for the duration of the call. Its values may be modified in place,
+ * but its arrays must not be reassigned.
+ *
+ * 'problemend' is optional and concerns files with CHANGE sequences. If it
+ * is NULL, reading stops at the first CHANGE so that only the base problem
+ * is seen. Otherwise it is called with the index of each problem as soon as
+ * it is complete, i.e., at each CHANGE and at the end of the file. The
+ * coordinate blocks following a CHANGE hold the modifications to apply to
+ * the previous problem in order to obtain the next.
+ *
+ * 'finish' is called exactly once at the end, also on failure, and should
+ * release any resources held in 'userdata'.
+ */
+typedef struct CBFstream_struct {
+
+  void *userdata;
+  CBFresponsee (*structure)(void *userdata, CBFdata *data);
+  CBFresponsee (*blockbegin)(void *userdata, CBFblocke block, long long int nnz);
+  CBFresponsee (*blockchunk)(void *userdata, CBFblocke block, CBFdata *chunk);
+  CBFresponsee (*blockend)(void *userdata, CBFblocke block);
+  CBFresponsee (*problemend)(void *userdata, long long int index);
+  CBFresponsee (*finish)(void *userdata, CBFresponsee res);
+
+} CBFstream;
+
+#endif
@@ -0,0 +1,401 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "transform-chordal.h"
+#include "cbf-helper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <new>
+#include <utility>
+#include <vector>
+#include <algorithm>
+
+//
+// Coordinates of a psdmap, in its lower triangle, covered by a clique of the
+// chordal extension. The local position in the clique is (cliquek, cliquel).
+//
+struct CBFchordal_entry {
+  int k;
+  int l;
+  int clique;
+  int cliquek;
+  int cliquel;
+};
+
+//
+// Psdmaps, variables and maps replacing the decomposed psdmaps. They are all
+// collected before the problem is touched, as their coordinates are copied
+// from the psdmaps being decomposed.
+//
+struct CBFtransform_chordal {
+  std::vector<int> psdmapdim;
+  long long int varnum;
+  long long int mapnum;
+
+  std::vector<int> hsubi, hsubk, hsubl;
+  std::vector<long long int> hsubj;
+  std::vector<double> hval;
+
+  std::vector<int> dsubi, dsubk, dsubl;
+  std::vector<double> dval;
+
+  std::vector<long long int> asubi, asubj;
+  std::vector<double> aval;
+
+  std::vector<long long int> bsubi;
+  std::vector<double> bval;
+};
+
+static CBFresponsee
+  transform(CBFdata *data, CBFtransform_param param);
+
+static void
+  cliques(int dim, const std::vector<std::pair<int,int> > &edge, std::vector<std::vector<int> > &clique);
+
+static void
+  decompose(const CBFdata *data, long long int hbeg, long long int hend, long long int dbeg, long long int dend,
+            const std::vector<std::vector<int> > &clique, CBFtransform_chordal *ext);
+
+static void
+  add_h(CBFtransform_chordal *ext, long long int hsubi, long long int hsubj, int hsubk, int hsubl, double hval);
+
+static CBFresponsee
+  rebuild(CBFdata *data, const CBFtransform_chordal *ext);
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFtransform const transform_chordal = { "chordal", transform, NULL, NULL };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_chordal ext;
+  std::vector<std::vector<int> > clique;
+  std::vector<std::pair<int,int> > edge;
+  std::vector<char> delpsdmap;
+  long long int i, k, hbeg, hend, dbeg, dend;
+  long long int mapnum = data->mapnum, varnum = data->varnum;
+
+  ext.varnum = 0;
+  ext.mapnum = 0;
+
+  if ( res == CBF_RES_OK )
+    res = CBF_coordinatesort_rowmajor_psdmap(data);
+
+  try {
+    delpsdmap.assign(data->psdmapnum, 0);
+
+    // Psdmaps are decomposed by the aggregate sparsity pattern of their coordinates
+    hbeg = dbeg = 0;
+    for (i=0; i<data->psdmapnum && res==CBF_RES_OK; ++i) {
+      hend = hbeg;
+      dend = dbeg;
+      res = CBF_findforward_psdmap(data, i+1, &hend, &dend);
+
+      edge.clear();
+      for (k=hbeg; k<hend; ++k)
+        if (data->hsubk[k] != data->hsubl[k])
+          edge.push_back(std::make_pair(data->hsubk[k], data->hsubl[k]));
+
+      for (k=dbeg; k<dend; ++k)
+        if (data->dsubk[k] != data->dsubl[k])
+          edge.push_back(std::make_pair(data->dsubk[k], data->dsubl[k]));
+
+      cliques(data->psdmapdim[i], edge, clique);
+
+      if (clique.size() >= 2) {
+        delpsdmap[i] = 1;
+        decompose(data, hbeg, hend, dbeg, dend, clique, &ext);
+      }
+
+      hbeg = hend;
+      dbeg = dend;
+    }
+
+    // The new psdmaps are appended and kept
+    delpsdmap.resize(data->psdmapnum + ext.psdmapdim.size(), 0);
+
+  } catch (std::bad_alloc&) {
+    res = CBF_RES_ERR;
+  }
+
+  if (ext.psdmapdim.empty())
+    return res;
+
+  if ( res == CBF_RES_OK )
+    res = rebuild(data, &ext);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_compress_psdmaps(data, &delpsdmap[0]);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_coordinatesort_rowmajor_map(data);
+
+  if ( res == CBF_RES_OK && data->mapname )
+    res = CBFnametable_pushnew(data->mapname, "g", mapnum, ext.mapnum);
+
+  if ( res == CBF_RES_OK && data->varname )
+    res = CBFnametable_pushnew(data->varname, "x", varnum, ext.varnum);
+
+  return res;
+}
+
+static void cliques(int dim, const std::vector<std::pair<int,int> > &edge, std::vector<std::vector<int> > &clique)
+{
+  std::vector<std::vector<int> > adj(dim), low(dim), kids(dim);
+  std::vector<int> order(dim), pos(dim);
+  std::vector<char> ismax(dim, 1);
+  size_t e;
+  int p, q, v;
+
+  for (e=0; e<edge.size(); ++e) {
+    adj[edge[e].first].push_back(edge[e].second);
+    adj[edge[e].second].push_back(edge[e].first);
+  }
+
+  for (v=0; v<dim; ++v) {
+    std::sort(adj[v].begin(), adj[v].end());
+    adj[v].erase(std::unique(adj[v].begin(), adj[v].end()), adj[v].end());
+    order[v] = v;
+  }
+
+  // Elimination by increasing degree of the pattern, as a cheap minimum degree ordering
+  std::sort(order.begin(), order.end(), [&adj](int a, int b) {
+    return adj[a].size() < adj[b].size() || (adj[a].size() == adj[b].size() && a < b);
+  });
+
+  for (p=0; p<dim; ++p)
+    pos[order[p]] = p;
+
+  //
+  // Symbolic elimination: the later neighbors of p in the chordal extension are
+  // its later neighbors in the pattern, and those of its children in the
+  // elimination tree. The parent of p is the first of them.
+  //
+  for (p=0; p<dim; ++p) {
+    std::vector<int> &s = low[p];
+
+    for (e=0; e<adj[order[p]].size(); ++e)
+      if (pos[adj[order[p]][e]] > p)
+        s.push_back(pos[adj[order[p]][e]]);
+
+    for (e=0; e<kids[p].size(); ++e)
+      for (q=1; q<(int)low[kids[p][e]].size(); ++q)
+        s.push_back(low[kids[p][e]][q]);
+
+    std::sort(s.begin(), s.end());
+    s.erase(std::unique(s.begin(), s.end()), s.end());
+
+    if (!s.empty())
+      kids[s[0]].push_back(p);
+  }
+
+  // The clique of p is contained in that of a child extending it by p alone
+  for (p=0; p<dim; ++p)
+    for (e=0; e<kids[p].size(); ++e)
+      if (low[kids[p][e]].size() == low[p].size() + 1)
+        ismax[p] = 0;
+
+  clique.clear();
+  for (p=0; p<dim; ++p) {
+    if (ismax[p]) {
+      clique.push_back(std::vector<int>(1, order[p]));
+      for (e=0; e<low[p].size(); ++e)
+        clique.back().push_back(order[low[p][e]]);
+
+      std::sort(clique.back().begin(), clique.back().end());
+    }
+  }
+}
+
+static void decompose(const CBFdata *data, long long int hbeg, long long int hend, long long int dbeg, long long int dend,
+                      const std::vector<std::vector<int> > &clique, CBFtransform_chordal *ext)
+{
+  std::vector<CBFchordal_entry> entry;
+  std::vector<long long int> hidx, didx;
+  long long int first, row, var, k;
+  size_t c, p, q, e, f, g, h, d, hfirst, dfirst;
+  int ek, el;
+
+  first = data->psdmapnum + ext->psdmapdim.size();
+
+  // Lower triangle of each clique, with members sorted by index
+  for (c=0; c<clique.size(); ++c) {
+    ext->psdmapdim.push_back(clique[c].size());
+
+    for (p=0; p<clique[c].size(); ++p) {
+      for (q=0; q<=p; ++q) {
+        CBFchordal_entry en = { clique[c][p], clique[c][q], (int)c, (int)p, (int)q };
+        entry.push_back(en);
+      }
+    }
+  }
+
+  std::sort(entry.begin(), entry.end(), [](const CBFchordal_entry &a, const CBFchordal_entry &b) {
+    return a.k < b.k || (a.k == b.k && (a.l < b.l || (a.l == b.l && a.clique < b.clique)));
+  });
+
+  // Coordinates of the psdmap in the same order, as lower triangular
+  for (k=hbeg; k<hend; ++k)
+    hidx.push_back(k);
+
+  for (k=dbeg; k<dend; ++k)
+    didx.push_back(k);
+
+  std::sort(hidx.begin(), hidx.end(), [data](long long int a, long long int b) {
+    int ak = std::max(data->hsubk[a], data->hsubl[a]), al = std::min(data->hsubk[a], data->hsubl[a]);
+    int bk = std::max(data->hsubk[b], data->hsubl[b]), bl = std::min(data->hsubk[b], data->hsubl[b]);
+    return ak < bk || (ak == bk && (al < bl || (al == bl && a < b)));
+  });
+
+  std::sort(didx.begin(), didx.end(), [data](long long int a, long long int b) {
+    int ak = std::max(data->dsubk[a], data->dsubl[a]), al = std::min(data->dsubk[a], data->dsubl[a]);
+    int bk = std::max(data->dsubk[b], data->dsubl[b]), bl = std::min(data->dsubk[b], data->dsubl[b]);
+    return ak < bk || (ak == bk && (al < bl || (al == bl && a < b)));
+  });
+
+  //
+  // An entry covered by a single clique keeps its coordinates in there. An entry
+  // shared by several cliques is split into one new free variable per clique,
+  // linked to the coordinates by an equality map: sum of variables = entry.
+  //
+  for (e=0, h=0, d=0; e<entry.size(); e=f) {
+    ek = entry[e].k;
+    el = entry[e].l;
+
+    for (f=e+1; f<entry.size() && entry[f].k==ek && entry[f].l==el; ++f)
+      continue;
+
+    for (hfirst=h; h<hidx.size(); ++h)
+      if (std::max(data->hsubk[hidx[h]], data->hsubl[hidx[h]]) != ek ||
+          std::min(data->hsubk[hidx[h]], data->hsubl[hidx[h]]) != el)
+        break;
+
+    for (dfirst=d; d<didx.size(); ++d)
+      if (std::max(data->dsubk[didx[d]], data->dsubl[didx[d]]) != ek ||
+          std::min(data->dsubk[didx[d]], data->dsubl[didx[d]]) != el)
+        break;
+
+    if (f - e == 1) {
+      for (g=hfirst; g<h; ++g)
+        add_h(ext, first + entry[e].clique, data->hsubj[hidx[g]], entry[e].cliquek, entry[e].cliquel, data->hval[hidx[g]]);
+
+      for (g=dfirst; g<d; ++g) {
+        ext->dsubi.push_back(first + entry[e].clique);
+        ext->dsubk.push_back(entry[e].cliquek);
+        ext->dsubl.push_back(entry[e].cliquel);
+        ext->dval.push_back(data->dval[didx[g]]);
+      }
+
+    } else {
+      row = data->mapnum + ext->mapnum++;
+
+      for (g=e; g<f; ++g) {
+        var = data->varnum + ext->varnum++;
+        add_h(ext, first + entry[g].clique, var, entry[g].cliquek, entry[g].cliquel, 1.0);
+
+        ext->asubi.push_back(row);
+        ext->asubj.push_back(var);
+        ext->aval.push_back(1.0);
+      }
+
+      for (g=hfirst; g<h; ++g) {
+        ext->asubi.push_back(row);
+        ext->asubj.push_back(data->hsubj[hidx[g]]);
+        ext->aval.push_back(-data->hval[hidx[g]]);
+      }
+
+      for (g=dfirst; g<d; ++g) {
+        ext->bsubi.push_back(row);
+        ext->bval.push_back(-data->dval[didx[g]]);
+      }
+    }
+  }
+}
+
+static void add_h(CBFtransform_chordal *ext, long long int hsubi, long long int hsubj, int hsubk, int hsubl, double hval)
+{
+  ext->hsubi.push_back(hsubi);
+  ext->hsubj.push_back(hsubj);
+  ext->hsubk.push_back(hsubk);
+  ext->hsubl.push_back(hsubl);
+  ext->hval.push_back(hval);
+}
+
+static CBFresponsee rebuild(CBFdata *data, const CBFtransform_chordal *ext)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFdyndata dyndata;
+  long long int k;
+
+  // Arrays are reallocated in place, owned by the frontend as before
+  CBFdyn_assign(&dyndata, data);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_psdmap_capacitysurplus(&dyndata, ext->psdmapdim.size());
+
+  for (k=0; k<(long long int)ext->psdmapdim.size() && res==CBF_RES_OK; ++k)
+    res = CBFdyn_psdmap_add(&dyndata, ext->psdmapdim[k]);
+
+  if ( res == CBF_RES_OK && ext->varnum >= 1 ) {
+    res = CBFdyn_var_capacitysurplus(&dyndata, 1);
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_var_adddomain(&dyndata, CBF_CONE_FREE, ext->varnum);
+  }
+
+  if ( res == CBF_RES_OK && ext->mapnum >= 1 ) {
+    res = CBFdyn_map_capacitysurplus(&dyndata, 1);
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_map_adddomain(&dyndata, CBF_CONE_ZERO, ext->mapnum);
+  }
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_h_capacitysurplus(&dyndata, ext->hval.size());
+
+  for (k=0; k<(long long int)ext->hval.size() && res==CBF_RES_OK; ++k)
+    res = CBFdyn_h_add(&dyndata, ext->hsubi[k], ext->hsubj[k], ext->hsubk[k], ext->hsubl[k], ext->hval[k]);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_d_capacitysurplus(&dyndata, ext->dval.size());
+
+  for (k=0; k<(long long int)ext->dval.size() && res==CBF_RES_OK; ++k)
+    res = CBFdyn_d_add(&dyndata, ext->dsubi[k], ext->dsubk[k], ext->dsubl[k], ext->dval[k]);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_a_capacitysurplus(&dyndata, ext->aval.size());
+
+  for (k=0; k<(long long int)ext->aval.size() && res==CBF_RES_OK; ++k)
+    res = CBFdyn_a_add(&dyndata, ext->asubi[k], ext->asubj[k], ext->aval[k]);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_b_capacitysurplus(&dyndata, ext->bval.size());
+
+  for (k=0; k<(long long int)ext->bval.size() && res==CBF_RES_OK; ++k)
+    res = CBFdyn_b_add(&dyndata, ext->bsubi[k], ext->bval[k]);
+
+  return res;
+}
@@ -20,6 +20,7 @@
 #include "cbf-format.h"
 
 #include <algorithm>
+#include <stdio.h>
 
 struct CBFtransform_flipsign {
   bool obja;
@@ -31,9 +32,43 @@ struct CBFtransform_flipsign {
   bool d;
 };
 
+struct CBFtransform_dualstream {
+  CBFstream downstream;
+  CBFobjsensee objsense;
+  CBFscalarconee *mapstackdomain;
+  CBFscalarconee *varstackdomain;
+};
+
 static CBFresponsee
   transform(CBFdata *data, CBFtransform_param param);
 
+static CBFresponsee
+  revert(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  stream(CBFstream *upstream, CBFstream downstream, CBFtransform_param param);
+
+static CBFresponsee
+  stream_structure(void *userdata, CBFdata *data);
+
+static CBFresponsee
+  stream_blockbegin(void *userdata, CBFblocke block, long long int nnz);
+
+static CBFresponsee
+  stream_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk);
+
+static CBFresponsee
+  stream_blockend(void *userdata, CBFblocke block);
+
+static CBFresponsee
+  stream_finish(void *userdata, CBFresponsee res);
+
+static CBFblocke
+  dual_block(CBFblocke block);
+
+static CBFscalarconee
+  dual_cone(CBFscalarconee cone);
+
 static CBFresponsee
   swap_obja_b(CBFdata *data, CBFtransform_flipsign *flipsign);
 
@@ -65,7 +100,7 @@ static CBFresponsee
 // Global variable
 // -------------------------------------
 
-CBFtransform const transform_dual = { "dual", transform, };
+CBFtransform const transform_dual = { "dual", transform, revert, stream };
 
 
 // -------------------------------------
@@ -108,6 +143,178 @@ static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
 }
 
 
+static CBFresponsee revert(CBFdata *data, CBFtransform_param param)
+{
+  CBFsolution *sol = param.sol;
+  double primsign, dualsign;
+  long long int i;
+
+  if (!sol)
+    return CBF_RES_ERR;
+
+  // Variables of the dual problem are the multipliers of the maps, and vice versa
+  if ( (sol->primvarnum + sol->primpsdvarnnz >= 1 && sol->primvarnum != data->mapnum) ||
+       (sol->dualvarnum + sol->dualpsdvarnnz >= 1 && sol->dualvarnum != data->varnum) ) {
+    printf("Mismatch between problem and solution\n");
+    return CBF_RES_ERR;
+  }
+
+  std::swap(sol->primvarnum,    sol->dualvarnum);
+  std::swap(sol->primvar,       sol->dualvar);
+  std::swap(sol->primpsdvarnnz, sol->dualpsdvarnnz);
+  std::swap(sol->primpsdvar,    sol->dualpsdvar);
+
+  // Signs follow from the objective sense of the original problem
+  primsign = (data->objsense == CBF_OBJ_MINIMIZE ? -1.0 : 1.0);
+  dualsign = -primsign;
+
+  for (i = 0; i < sol->primvarnum; ++i)
+    sol->primvar[i] *= primsign;
+
+  for (i = 0; i < sol->primpsdvarnnz; ++i)
+    sol->primpsdvar[i] *= primsign;
+
+  for (i = 0; i < sol->dualvarnum; ++i)
+    sol->dualvar[i] *= dualsign;
+
+  for (i = 0; i < sol->dualpsdvarnnz; ++i)
+    sol->dualpsdvar[i] *= dualsign;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee stream(CBFstream *upstream, CBFstream downstream, CBFtransform_param param)
+{
+  CBFtransform_dualstream *state = NULL;
+
+  state = (CBFtransform_dualstream*) calloc(1, sizeof(*state));
+  if (!state)
+    return CBF_RES_ERR;
+
+  state->downstream = downstream;
+
+  upstream->userdata   = state;
+  upstream->structure  = stream_structure;
+  upstream->blockbegin = stream_blockbegin;
+  upstream->blockchunk = stream_blockchunk;
+  upstream->blockend   = stream_blockend;
+  upstream->finish     = stream_finish;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee stream_structure(void *userdata, CBFdata *data)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_dualstream *state = (CBFtransform_dualstream*) userdata;
+  CBFtransform_param param;
+  CBFdata dual = *data;
+
+  // Sign flips of coordinates depend on the original objective sense
+  state->objsense = data->objsense;
+
+  // The structure belongs to the caller, so domains are dualized in a copy
+  // and integer variables are dropped without being released
+  dual.intvarnum = 0;
+  dual.intvar = NULL;
+
+  state->mapstackdomain = (CBFscalarconee*) calloc(data->mapstacknum, sizeof(data->mapstackdomain[0]));
+  state->varstackdomain = (CBFscalarconee*) calloc(data->varstacknum, sizeof(data->varstackdomain[0]));
+
+  if ( (data->mapstacknum >= 1 && !state->mapstackdomain) || (data->varstacknum >= 1 && !state->varstackdomain) )
+    res = CBF_RES_ERR;
+
+  if ( res == CBF_RES_OK ) {
+    std::copy(data->mapstackdomain, data->mapstackdomain + data->mapstacknum, state->mapstackdomain);
+    std::copy(data->varstackdomain, data->varstackdomain + data->varstacknum, state->varstackdomain);
+    dual.mapstackdomain = state->mapstackdomain;
+    dual.varstackdomain = state->varstackdomain;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = param.init(&dual);
+
+  if ( res == CBF_RES_OK )
+    res = transform(&dual, param);
+
+  if ( res == CBF_RES_OK )
+    res = state->downstream.structure(state->downstream.userdata, &dual);
+
+  return res;
+}
+
+static CBFresponsee stream_blockbegin(void *userdata, CBFblocke block, long long int nnz)
+{
+  CBFtransform_dualstream *state = (CBFtransform_dualstream*) userdata;
+  return state->downstream.blockbegin(state->downstream.userdata, dual_block(block), nnz);
+}
+
+static CBFresponsee stream_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_dualstream *state = (CBFtransform_dualstream*) userdata;
+  CBFtransform_param param;
+  CBFdata dualchunk = *chunk;
+
+  // The chunk holds no structure, so only coordinates are swapped and sign flipped.
+  // Swaps happen on the local copy, leaving the arrays of the caller in place.
+  dualchunk.objsense = state->objsense;
+
+  if ( res == CBF_RES_OK )
+    res = param.init(&dualchunk);
+
+  if ( res == CBF_RES_OK )
+    res = transform(&dualchunk, param);
+
+  if ( res == CBF_RES_OK )
+    res = state->downstream.blockchunk(state->downstream.userdata, dual_block(block), &dualchunk);
+
+  return res;
+}
+
+static CBFresponsee stream_blockend(void *userdata, CBFblocke block)
+{
+  CBFtransform_dualstream *state = (CBFtransform_dualstream*) userdata;
+  return state->downstream.blockend(state->downstream.userdata, dual_block(block));
+}
+
+static CBFresponsee stream_finish(void *userdata, CBFresponsee res)
+{
+  CBFtransform_dualstream *state = (CBFtransform_dualstream*) userdata;
+  CBFstream downstream = state->downstream;
+
+  free(state->mapstackdomain);
+  free(state->varstackdomain);
+  free(state);
+  return downstream.finish(downstream.userdata, res);
+}
+
+static CBFblocke dual_block(CBFblocke block)
+{
+  switch (block) {
+  case CBF_BLOCK_OBJACOORD:     return CBF_BLOCK_BCOORD;
+  case CBF_BLOCK_BCOORD:        return CBF_BLOCK_OBJACOORD;
+  case CBF_BLOCK_OBJFCOORD:     return CBF_BLOCK_DCOORD;
+  case CBF_BLOCK_DCOORD:        return CBF_BLOCK_OBJFCOORD;
+  case CBF_BLOCK_FCOORD:        return CBF_BLOCK_HCOORD;
+  case CBF_BLOCK_HCOORD:        return CBF_BLOCK_FCOORD;
+  default:                      return block;
+  }
+}
+
+static CBFscalarconee dual_cone(CBFscalarconee cone)
+{
+  switch (cone) {
+  case CBF_CONE_FREE:           return CBF_CONE_ZERO;
+  case CBF_CONE_ZERO:           return CBF_CONE_FREE;
+  case CBF_CONE_PEXP:           return CBF_CONE_DEXP;
+  case CBF_CONE_DEXP:           return CBF_CONE_PEXP;
+  case CBF_CONE_PPOW:           return CBF_CONE_DPOW;
+  case CBF_CONE_DPOW:           return CBF_CONE_PPOW;
+  default:                      return cone;          // Self-dual cones
+  }
+}
+
 static CBFresponsee swap_obja_b(CBFdata *data, CBFtransform_flipsign *flipsign)
 {
   std::swap(data->objannz,  data->bnnz);
@@ -163,6 +370,7 @@ static CBFresponsee remove_intvar(CBFdata *data, CBFtransform_flipsign *flipsign
   // Dual of continuous relaxation
   if (data->intvarnum >= 1) {
     free(data->intvar);
+    data->intvar = NULL;
     data->intvarnum = 0;
   }
 
@@ -177,24 +385,24 @@ static CBFresponsee swap_map_var(CBFdata *data, CBFtransform_flipsign *flipsign)
   std::swap(data->mapstacknum,    data->varstacknum);
   std::swap(data->mapstackdim,    data->varstackdim);
   std::swap(data->mapstackdomain, data->varstackdomain);
+  std::swap(data->mapstackparam,  data->varstackparam);
 
-  // Dualize map domains
-  for (i = 0; i < data->mapstacknum; ++i) {
-    if (data->mapstackdomain[i] == CBF_CONE_FREE)
-      data->mapstackdomain[i] = CBF_CONE_ZERO;
+  // Multipliers are named after their maps, and vice versa
+  std::swap(data->mapname,        data->varname);
 
-    else if (data->mapstackdomain[i] == CBF_CONE_ZERO)
-      data->mapstackdomain[i] = CBF_CONE_FREE;
-  }
+  // Parameters of dualized power cones follow them into the dual pool
+  std::swap(data->powconenum,     data->dpowconenum);
+  std::swap(data->powalphanum,    data->dpowalphanum);
+  std::swap(data->powalphabeg,    data->dpowalphabeg);
+  std::swap(data->powalpha,       data->dpowalpha);
 
-  // Dualize var domains
-  for (i = 0; i < data->varstacknum; ++i) {
-    if (data->varstackdomain[i] == CBF_CONE_FREE)
-      data->varstackdomain[i] = CBF_CONE_ZERO;
+  // Dualize map domains
+  for (i = 0; i < data->mapstacknum; ++i)
+    data->mapstackdomain[i] = dual_cone(data->mapstackdomain[i]);
 
-    else if (data->varstackdomain[i] == CBF_CONE_ZERO)
-      data->varstackdomain[i] = CBF_CONE_FREE;
-  }
+  // Dualize var domains
+  for (i = 0; i < data->varstacknum; ++i)
+    data->varstackdomain[i] = dual_cone(data->varstackdomain[i]);
 
   // map's can not belong to negative domains
   flipsign->a = !flipsign->a;
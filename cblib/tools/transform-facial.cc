@@ -0,0 +1,403 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "transform-facial.h"
+#include "cbf-helper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+//
+// Reduction found by analyze, depending only on the original problem so that
+// revert can find it again. Rows, and thereby columns, of a psdmap without any
+// coordinate are dropped, and psdmaps left with a single row become maps of
+// domain L+. Psdvars of a single row similarly become variables of domain L+.
+//
+struct CBFtransform_facial {
+  long long int *rowbeg;   // Rows of psdmap i are found from rowbeg[i] to rowbeg[i+1]-1
+  int *newrow;             // New index of each row in its psdmap, or -1 if dropped
+  int *newdim;             // New dimension of each psdmap
+  long long int *newmap;   // Map replacing each psdmap, or -1
+  long long int *newvar;   // Variable replacing each psdvar, or -1
+};
+
+static CBFresponsee
+  transform(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  revert(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  analyze(const CBFdata *data, CBFtransform_facial *fac);
+
+static CBFresponsee
+  substitute(CBFdata *data, const CBFtransform_facial *fac);
+
+static CBFresponsee
+  revert_primal(const CBFdata *data, const CBFtransform_facial *fac, CBFsolution *sol);
+
+static CBFresponsee
+  revert_dual(const CBFdata *data, const CBFtransform_facial *fac, CBFsolution *sol);
+
+static void
+  free_facial(CBFtransform_facial *fac);
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFtransform const transform_facial = { "facial", transform, revert, NULL };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_facial fac = { 0, };
+  char *delpsdmap = NULL, *delpsdvar = NULL;
+  long long int i, mapnum = data->mapnum, varnum = data->varnum;
+
+  if ( res == CBF_RES_OK )
+    res = analyze(data, &fac);
+
+  if ( res == CBF_RES_OK ) {
+    delpsdmap = (char*) calloc(data->psdmapnum, sizeof(delpsdmap[0]));
+    delpsdvar = (char*) calloc(data->psdvarnum, sizeof(delpsdvar[0]));
+
+    if ( (data->psdmapnum >= 1 && !delpsdmap) || (data->psdvarnum >= 1 && !delpsdvar) )
+      res = CBF_RES_ERR;
+  }
+
+  if ( res == CBF_RES_OK ) {
+    for (i=0; i<data->psdmapnum; ++i)
+      delpsdmap[i] = (fac.newdim[i] <= 1);
+
+    for (i=0; i<data->psdvarnum; ++i)
+      delpsdvar[i] = (fac.newvar[i] >= 0);
+
+    res = substitute(data, &fac);
+  }
+
+  if ( res == CBF_RES_OK )
+    res = CBF_compress_psdmaps(data, delpsdmap);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_compress_psdvars(data, delpsdvar);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_coordinatesort(data->objasubj, data->objaval, data->objannz, data->varnum);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_coordinatesort_rowmajor_map(data);
+
+  if ( res == CBF_RES_OK && data->mapname )
+    res = CBFnametable_pushnew(data->mapname, "g", mapnum, data->mapnum - mapnum);
+
+  if ( res == CBF_RES_OK && data->varname )
+    res = CBFnametable_pushnew(data->varname, "x", varnum, data->varnum - varnum);
+
+  CBF_release_empty(data);
+  free(delpsdmap);
+  free(delpsdvar);
+  free_facial(&fac);
+  return res;
+}
+
+static CBFresponsee revert(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_facial fac = { 0, };
+
+  if (!param.sol)
+    return CBF_RES_ERR;
+
+  if ( res == CBF_RES_OK )
+    res = analyze(data, &fac);
+
+  if ( res == CBF_RES_OK )
+    res = revert_primal(data, &fac, param.sol);
+
+  if ( res == CBF_RES_OK )
+    res = revert_dual(data, &fac, param.sol);
+
+  free_facial(&fac);
+  return res;
+}
+
+static CBFresponsee analyze(const CBFdata *data, CBFtransform_facial *fac)
+{
+  long long int i, k, mapnum, varnum;
+
+  fac->rowbeg = (long long int*) malloc((data->psdmapnum+1) * sizeof(fac->rowbeg[0]));
+  fac->newdim = (int*) malloc(data->psdmapnum * sizeof(fac->newdim[0]));
+  fac->newmap = (long long int*) malloc(data->psdmapnum * sizeof(fac->newmap[0]));
+  fac->newvar = (long long int*) malloc(data->psdvarnum * sizeof(fac->newvar[0]));
+
+  if ( !fac->rowbeg || (data->psdmapnum >= 1 && (!fac->newdim || !fac->newmap)) ||
+       (data->psdvarnum >= 1 && !fac->newvar) )
+    return CBF_RES_ERR;
+
+  fac->rowbeg[0] = 0;
+  for (i=0; i<data->psdmapnum; ++i)
+    fac->rowbeg[i+1] = fac->rowbeg[i] + data->psdmapdim[i];
+
+  fac->newrow = (int*) malloc(fac->rowbeg[data->psdmapnum] * sizeof(fac->newrow[0]));
+  if ( !fac->newrow && fac->rowbeg[data->psdmapnum] >= 1 )
+    return CBF_RES_ERR;
+
+  // Rows in use are marked by a single pass over the coordinates
+  for (k=0; k<fac->rowbeg[data->psdmapnum]; ++k)
+    fac->newrow[k] = -1;
+
+  for (k=0; k<data->hnnz; ++k) {
+    fac->newrow[fac->rowbeg[data->hsubi[k]] + data->hsubk[k]] = 0;
+    fac->newrow[fac->rowbeg[data->hsubi[k]] + data->hsubl[k]] = 0;
+  }
+
+  for (k=0; k<data->dnnz; ++k) {
+    fac->newrow[fac->rowbeg[data->dsubi[k]] + data->dsubk[k]] = 0;
+    fac->newrow[fac->rowbeg[data->dsubi[k]] + data->dsubl[k]] = 0;
+  }
+
+  // ...and numbered in order
+  mapnum = data->mapnum;
+  for (i=0; i<data->psdmapnum; ++i) {
+    fac->newdim[i] = 0;
+    for (k=fac->rowbeg[i]; k<fac->rowbeg[i+1]; ++k)
+      if (fac->newrow[k] == 0)
+        fac->newrow[k] = fac->newdim[i]++;
+
+    fac->newmap[i] = (fac->newdim[i] == 1) ? mapnum++ : -1;
+  }
+
+  varnum = data->varnum;
+  for (i=0; i<data->psdvarnum; ++i)
+    fac->newvar[i] = (data->psdvardim[i] == 1) ? varnum++ : -1;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee substitute(CBFdata *data, const CBFtransform_facial *fac)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFdyndata dyndata;
+  long long int i, k, mapnum = 0, varnum = 0, annz = 0, bnnz = 0, objannz = 0;
+
+  for (i=0; i<data->psdmapnum; ++i)
+    mapnum += (fac->newmap[i] >= 0);
+
+  for (i=0; i<data->psdvarnum; ++i)
+    varnum += (fac->newvar[i] >= 0);
+
+  for (k=0; k<data->hnnz; ++k)
+    annz += (fac->newmap[data->hsubi[k]] >= 0);
+
+  for (k=0; k<data->dnnz; ++k)
+    bnnz += (fac->newmap[data->dsubi[k]] >= 0);
+
+  for (k=0; k<data->fnnz; ++k)
+    annz += (fac->newvar[data->fsubj[k]] >= 0);
+
+  for (k=0; k<data->objfnnz; ++k)
+    objannz += (fac->newvar[data->objfsubj[k]] >= 0);
+
+  // Arrays are reallocated in place, owned by the frontend as before
+  CBFdyn_assign(&dyndata, data);
+
+  if ( res == CBF_RES_OK && mapnum >= 1 ) {
+    res = CBFdyn_map_capacitysurplus(&dyndata, 1);
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_map_adddomain(&dyndata, CBF_CONE_POS, mapnum);
+  }
+
+  if ( res == CBF_RES_OK && varnum >= 1 ) {
+    res = CBFdyn_var_capacitysurplus(&dyndata, 1);
+    if ( res == CBF_RES_OK )
+      res = CBFdyn_var_adddomain(&dyndata, CBF_CONE_POS, varnum);
+  }
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_a_capacitysurplus(&dyndata, annz);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_b_capacitysurplus(&dyndata, bnnz);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_obja_capacitysurplus(&dyndata, objannz);
+
+  // Single-row psdmaps become maps, while others drop the rows not in use
+  for (k=0; k<data->hnnz && res==CBF_RES_OK; ++k) {
+    if (fac->newmap[data->hsubi[k]] >= 0) {
+      res = CBFdyn_a_add(&dyndata, fac->newmap[data->hsubi[k]], data->hsubj[k], data->hval[k]);
+    } else {
+      data->hsubk[k] = fac->newrow[fac->rowbeg[data->hsubi[k]] + data->hsubk[k]];
+      data->hsubl[k] = fac->newrow[fac->rowbeg[data->hsubi[k]] + data->hsubl[k]];
+    }
+  }
+
+  for (k=0; k<data->dnnz && res==CBF_RES_OK; ++k) {
+    if (fac->newmap[data->dsubi[k]] >= 0) {
+      res = CBFdyn_b_add(&dyndata, fac->newmap[data->dsubi[k]], data->dval[k]);
+    } else {
+      data->dsubk[k] = fac->newrow[fac->rowbeg[data->dsubi[k]] + data->dsubk[k]];
+      data->dsubl[k] = fac->newrow[fac->rowbeg[data->dsubi[k]] + data->dsubl[k]];
+    }
+  }
+
+  // Single-row psdvars become variables
+  for (k=0; k<data->fnnz && res==CBF_RES_OK; ++k)
+    if (fac->newvar[data->fsubj[k]] >= 0)
+      res = CBFdyn_a_add(&dyndata, data->fsubi[k], fac->newvar[data->fsubj[k]], data->fval[k]);
+
+  for (k=0; k<data->objfnnz && res==CBF_RES_OK; ++k)
+    if (fac->newvar[data->objfsubj[k]] >= 0)
+      res = CBFdyn_obja_add(&dyndata, fac->newvar[data->objfsubj[k]], data->objfval[k]);
+
+  if ( res == CBF_RES_OK )
+    for (i=0; i<data->psdmapnum; ++i)
+      data->psdmapdim[i] = fac->newdim[i];
+
+  return res;
+}
+
+static CBFresponsee revert_primal(const CBFdata *data, const CBFtransform_facial *fac, CBFsolution *sol)
+{
+  long long int i, k, n, varnum = data->varnum, psdvarnnz = 0, nnz = 0;
+  double *val = NULL;
+
+  if (sol->primvarnum + sol->primpsdvarnnz == 0)
+    return CBF_RES_OK;
+
+  for (i=0; i<data->psdvarnum; ++i) {
+    n = data->psdvardim[i];
+    psdvarnnz += n*(n+1)/2;
+    if (fac->newvar[i] >= 0)
+      ++varnum;
+    else
+      nnz += n*(n+1)/2;
+  }
+
+  if (sol->primvarnum != varnum || sol->primpsdvarnnz != nnz) {
+    printf("Mismatch between problem and solution\n");
+    return CBF_RES_ERR;
+  }
+
+  val = (double*) malloc(psdvarnnz * sizeof(val[0]));
+  if (!val && psdvarnnz >= 1)
+    return CBF_RES_ERR;
+
+  // Psdvars of a single row take the value of their variable
+  for (i=0, k=0, nnz=0; i<data->psdvarnum; ++i) {
+    n = data->psdvardim[i];
+    if (fac->newvar[i] >= 0) {
+      val[k++] = sol->primvar[fac->newvar[i]];
+    } else {
+      memcpy(val + k, sol->primpsdvar + nnz, n*(n+1)/2 * sizeof(val[0]));
+      k += n*(n+1)/2;
+      nnz += n*(n+1)/2;
+    }
+  }
+
+  std::swap(val, sol->primpsdvar);
+  sol->primpsdvarnnz = psdvarnnz;
+  sol->primvarnum = data->varnum;
+  free(val);
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee revert_dual(const CBFdata *data, const CBFtransform_facial *fac, CBFsolution *sol)
+{
+  long long int i, k, l, n, m, rk, rl, mapnum = data->mapnum, psdmapnnz = 0, nnz = 0, beg;
+  const int *newrow;
+  double *val = NULL;
+
+  if (sol->dualvarnum + sol->dualpsdvarnnz == 0)
+    return CBF_RES_OK;
+
+  for (i=0; i<data->psdmapnum; ++i) {
+    n = data->psdmapdim[i];
+    m = fac->newdim[i];
+    psdmapnnz += n*(n+1)/2;
+    if (fac->newmap[i] >= 0)
+      ++mapnum;
+    else if (m >= 2)
+      nnz += m*(m+1)/2;
+  }
+
+  if (sol->dualvarnum != mapnum || sol->dualpsdvarnnz != nnz) {
+    printf("Mismatch between problem and solution\n");
+    return CBF_RES_ERR;
+  }
+
+  val = (double*) calloc(psdmapnnz, sizeof(val[0]));
+  if (!val && psdmapnnz >= 1)
+    return CBF_RES_ERR;
+
+  //
+  // Dropped rows and columns of a psdmap are zero in its dual, while the rest
+  // is found in the reduced psdmap, or in the map replacing it if of a single row.
+  //
+  for (i=0, beg=0, nnz=0; i<data->psdmapnum; ++i) {
+    n = data->psdmapdim[i];
+    newrow = fac->newrow + fac->rowbeg[i];
+
+    if (fac->newmap[i] >= 0 || fac->newdim[i] >= 2) {
+      for (k=0; k<n; ++k) {
+        for (l=0; l<=k; ++l) {
+          rk = newrow[k];
+          rl = newrow[l];
+          if (rk >= 0 && rl >= 0) {
+            if (fac->newmap[i] >= 0)
+              val[beg + k*(k+1)/2 + l] = sol->dualvar[fac->newmap[i]];
+            else
+              val[beg + k*(k+1)/2 + l] = sol->dualpsdvar[nnz + rk*(rk+1)/2 + rl];
+          }
+        }
+      }
+    }
+
+    m = fac->newdim[i];
+    if (m >= 2)
+      nnz += m*(m+1)/2;
+
+    beg += n*(n+1)/2;
+  }
+
+  std::swap(val, sol->dualpsdvar);
+  sol->dualpsdvarnnz = psdmapnnz;
+  sol->dualvarnum = data->mapnum;
+  free(val);
+
+  return CBF_RES_OK;
+}
+
+static void free_facial(CBFtransform_facial *fac)
+{
+  free(fac->rowbeg);
+  free(fac->newrow);
+  free(fac->newdim);
+  free(fac->newmap);
+  free(fac->newvar);
+  memset(fac, 0, sizeof(*fac));
+}
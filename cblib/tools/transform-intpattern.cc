@@ -0,0 +1,105 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "transform-intpattern.h"
+#include "cbf-helper.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static CBFresponsee
+  transform(CBFdata *data, CBFtransform_param param);
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFtransform const transform_intpattern = { "intpattern", transform, NULL, NULL };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  char *delvar = NULL, *delpsdvar = NULL, *partial = NULL;
+  long long int j, k, r, s, kept, varnum = data->varnum;
+
+  //
+  // The integer subproblem keeps all maps, but only the integer variables and
+  // their coordinates. Arrays are compacted in place by flags of deletion, set
+  // for the variables from a separate array marking those that are integer.
+  //
+  if ( res == CBF_RES_OK && data->varnum >= 1 ) {
+    res = CBFintegerarray_init(data, &delvar);
+    if ( res == CBF_RES_OK )
+      for (j=0; j<data->varnum; ++j)
+        delvar[j] = !delvar[j];
+  }
+
+  if ( res == CBF_RES_OK ) {
+    delpsdvar = (char*) malloc(data->psdvarnum * sizeof(delpsdvar[0]));
+    partial = (char*) malloc(data->varstacknum * sizeof(partial[0]));
+
+    if ( (data->psdvarnum >= 1 && !delpsdvar) || (data->varstacknum >= 1 && !partial) )
+      res = CBF_RES_ERR;
+  }
+
+  // Stacks kept in part, in the order of the stacks kept at all
+  if ( res == CBF_RES_OK ) {
+    for (r=0, s=0, k=0; r<data->varstacknum; ++r) {
+      for (kept=0, j=k; j<k+data->varstackdim[r]; ++j)
+        kept += (delvar[j] != 1);
+
+      if (kept >= 1)
+        partial[s++] = (kept < data->varstackdim[r]);
+
+      k = j;
+    }
+  }
+
+  if ( res == CBF_RES_OK )
+    res = CBF_compress_vars(data, delvar);
+
+  // ...are made free, unless of linear domain, as members of cones are not interchangeable
+  if ( res == CBF_RES_OK ) {
+    for (r=0; r<data->varstacknum; ++r) {
+      if (partial[r] && data->varstackdomain[r] > CBF_CONE_ZERO) {
+        data->varstackdomain[r] = CBF_CONE_FREE;
+        if (data->varstackparam)
+          data->varstackparam[r] = -1;
+      }
+    }
+  }
+
+  if ( res == CBF_RES_OK && data->psdvarnum >= 1 ) {
+    memset(delpsdvar, 1, data->psdvarnum * sizeof(delpsdvar[0]));
+    res = CBF_compress_psdvars(data, delpsdvar);
+  }
+
+  if ( res == CBF_RES_OK && data->varname )
+    res = CBFnametable_compress(data->varname, varnum, delvar);
+
+  CBF_release_empty(data);
+  CBFintegerarray_free(&delvar);
+  free(delpsdvar);
+  free(partial);
+  return res;
+}
@@ -24,12 +24,18 @@
 static CBFresponsee
   transform(CBFdata *data, CBFtransform_param param);
 
+static CBFresponsee
+  revert(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  stream(CBFstream *upstream, CBFstream downstream, CBFtransform_param param);
+
 
 // -------------------------------------
 // Global variable
 // -------------------------------------
 
-CBFtransform const transform_none = { "none", transform };
+CBFtransform const transform_none = { "none", transform, revert, stream };
 
 // -------------------------------------
 // Function definitions
@@ -40,3 +46,14 @@ static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
   return CBF_RES_OK;
 }
 
+static CBFresponsee revert(CBFdata *data, CBFtransform_param param)
+{
+  return CBF_RES_OK;
+}
+
+static CBFresponsee stream(CBFstream *upstream, CBFstream downstream, CBFtransform_param param)
+{
+  *upstream = downstream;
+  return CBF_RES_OK;
+}
+
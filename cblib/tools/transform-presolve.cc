@@ -0,0 +1,520 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "transform-presolve.h"
+#include "cbf-helper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+//
+// Reductions found by analyze, depending only on the original problem so
+// that revert can find them again. Removed variables take the value fixval,
+// and were either fixed by their domain (fixrow = -1) or by a singleton row
+// of equality (fixrow >= 0). Removed rows hold no further information.
+//
+struct CBFtransform_presolve {
+  char *delmap;
+  char *delvar;
+  double *fixval;
+  long long int *fixrow;
+  double *shift;        // Contribution of removed variables to each row
+};
+
+static CBFresponsee
+  transform(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  revert(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  analyze(const CBFdata *data, CBFtransform_presolve *pre);
+
+static unsigned long long int
+  hash_mix(unsigned long long int h, unsigned long long int v);
+
+static unsigned long long int
+  hash_mix(unsigned long long int h, double v);
+
+static CBFresponsee
+  find_duplicates(const CBFdata *data, CBFtransform_presolve *pre, const CBFscalarconee *mapdomain, const double *rhs,
+                  const char *hasf, const long long int *rowbeg, const long long int *idx);
+
+static int
+  equal_rows(const CBFdata *data, const CBFtransform_presolve *pre, const CBFscalarconee *mapdomain, const double *rhs,
+             const long long int *rowbeg, const long long int *idx, long long int r1, long long int r2);
+
+static CBFresponsee
+  substitute(CBFdata *data, CBFtransform_presolve *pre);
+
+static void
+  free_presolve(CBFtransform_presolve *pre);
+
+static CBFresponsee
+  revert_primal(const CBFdata *data, const CBFtransform_presolve *pre, CBFsolution *sol);
+
+static CBFresponsee
+  revert_dual(const CBFdata *data, const CBFtransform_presolve *pre, CBFsolution *sol);
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFtransform const transform_presolve = { "presolve", transform, revert, NULL };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_presolve pre = { 0, };
+  long long int mapnum = data->mapnum, varnum = data->varnum;
+
+  if ( res == CBF_RES_OK )
+    res = analyze(data, &pre);
+
+  if ( res == CBF_RES_OK )
+    res = substitute(data, &pre);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_compress_maps(data, pre.delmap);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_compress_vars(data, pre.delvar);
+
+  if ( res == CBF_RES_OK && data->mapname )
+    res = CBFnametable_compress(data->mapname, mapnum, pre.delmap);
+
+  if ( res == CBF_RES_OK && data->varname )
+    res = CBFnametable_compress(data->varname, varnum, pre.delvar);
+
+  CBF_release_empty(data);
+  free_presolve(&pre);
+  return res;
+}
+
+static CBFresponsee revert(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_presolve pre = { 0, };
+
+  if (!param.sol)
+    return CBF_RES_ERR;
+
+  if ( res == CBF_RES_OK )
+    res = analyze(data, &pre);
+
+  if ( res == CBF_RES_OK )
+    res = revert_primal(data, &pre, param.sol);
+
+  if ( res == CBF_RES_OK )
+    res = revert_dual(data, &pre, param.sol);
+
+  free_presolve(&pre);
+  return res;
+}
+
+static CBFresponsee analyze(const CBFdata *data, CBFtransform_presolve *pre)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFscalarconee *mapdomain = NULL, *vardomain = NULL;
+  char *hasf = NULL, *hash = NULL, *isint = NULL;
+  long long int *rowbeg = NULL, *idx = NULL;
+  double *rhs = NULL, val;
+  long long int i, j, k, r, cnt, col;
+
+  pre->delmap = (char*) calloc(data->mapnum, sizeof(pre->delmap[0]));
+  pre->delvar = (char*) calloc(data->varnum, sizeof(pre->delvar[0]));
+  pre->fixval = (double*) calloc(data->varnum, sizeof(pre->fixval[0]));
+  pre->fixrow = (long long int*) malloc(data->varnum * sizeof(pre->fixrow[0]));
+  pre->shift = (double*) calloc(data->mapnum, sizeof(pre->shift[0]));
+
+  mapdomain = (CBFscalarconee*) malloc(data->mapnum * sizeof(mapdomain[0]));
+  vardomain = (CBFscalarconee*) malloc(data->varnum * sizeof(vardomain[0]));
+  hasf = (char*) calloc(data->mapnum, sizeof(hasf[0]));
+  hash = (char*) calloc(data->varnum, sizeof(hash[0]));
+  rhs = (double*) calloc(data->mapnum, sizeof(rhs[0]));
+  rowbeg = (long long int*) malloc((data->mapnum+1) * sizeof(rowbeg[0]));
+  idx = (long long int*) malloc(data->annz * sizeof(idx[0]));
+
+  if ( data->mapnum >= 1 && (!pre->delmap || !pre->shift || !mapdomain || !hasf || !rhs) )
+    res = CBF_RES_ERR;
+
+  if ( data->varnum >= 1 && (!pre->delvar || !pre->fixval || !pre->fixrow || !vardomain || !hash) )
+    res = CBF_RES_ERR;
+
+  if ( !rowbeg || (data->annz >= 1 && !idx) )
+    res = CBF_RES_ERR;
+
+  if ( res == CBF_RES_OK && data->varnum >= 1 )
+    res = CBFintegerarray_init(const_cast<CBFdata*>(data), &isint);
+
+  // Row-major view of the coordinates, ordered by variable within each row
+  if ( res == CBF_RES_OK )
+    res = CBF_transpose(data->annz, data->asubj, data->varnum-1, data->asubi, data->mapnum-1, rowbeg, idx);
+
+  if ( res == CBF_RES_OK ) {
+    for (r=0, i=0; r<data->mapstacknum; ++r)
+      for (k=0; k<data->mapstackdim[r]; ++k)
+        mapdomain[i++] = data->mapstackdomain[r];
+
+    for (r=0, j=0; r<data->varstacknum; ++r)
+      for (k=0; k<data->varstackdim[r]; ++k)
+        vardomain[j++] = data->varstackdomain[r];
+
+    for (k=0; k<data->fnnz; ++k)
+      if (data->fval[k] != 0.0)
+        hasf[data->fsubi[k]] = 1;
+
+    for (k=0; k<data->hnnz; ++k)
+      if (data->hval[k] != 0.0)
+        hash[data->hsubj[k]] = 1;
+
+    for (k=0; k<data->bnnz; ++k)
+      rhs[data->bsubi[k]] += data->bval[k];
+
+    // Variables of domain L= are fixed at zero
+    for (j=0; j<data->varnum; ++j) {
+      pre->fixrow[j] = -1;
+      if (vardomain[j] == CBF_CONE_ZERO)
+        pre->delvar[j] = 1;
+    }
+
+    // Singleton rows of domain L= fix their variable, unless the value is out of domain
+    for (i=0; i<data->mapnum; ++i) {
+      if (mapdomain[i] != CBF_CONE_ZERO || hasf[i])
+        continue;
+
+      for (cnt=0, col=-1, k=rowbeg[i]; k<rowbeg[i+1]; ++k) {
+        if (data->aval[idx[k]] != 0.0) {
+          col = idx[k];
+          ++cnt;
+        }
+      }
+
+      if (cnt != 1)
+        continue;
+
+      j = data->asubj[col];
+      if (pre->delvar[j] || hash[j] || vardomain[j] > CBF_CONE_ZERO)
+        continue;
+
+      val = -rhs[i] / data->aval[col];
+      if ((vardomain[j] == CBF_CONE_POS && val < 0.0) || (vardomain[j] == CBF_CONE_NEG && val > 0.0) || (isint[j] && val != floor(val)))
+        continue;
+
+      pre->delvar[j] = 1;
+      pre->fixval[j] = val;
+      pre->fixrow[j] = i;
+      pre->delmap[i] = 1;
+    }
+
+    // Contribution of removed variables to the remaining rows
+    for (k=0; k<data->annz; ++k)
+      if (pre->delvar[data->asubj[k]] && !pre->delmap[data->asubi[k]])
+        pre->shift[data->asubi[k]] += data->aval[k] * pre->fixval[data->asubj[k]];
+
+    for (i=0; i<data->mapnum; ++i)
+      rhs[i] += pre->shift[i];
+
+    // Empty rows of linear domain are removed if satisfied
+    for (i=0; i<data->mapnum; ++i) {
+      if (pre->delmap[i] || hasf[i] || mapdomain[i] > CBF_CONE_ZERO)
+        continue;
+
+      for (cnt=0, k=rowbeg[i]; k<rowbeg[i+1]; ++k)
+        if (data->aval[idx[k]] != 0.0 && !pre->delvar[data->asubj[idx[k]]])
+          ++cnt;
+
+      if (cnt != 0)
+        continue;
+
+      if ((mapdomain[i] == CBF_CONE_FREE) ||
+          (mapdomain[i] == CBF_CONE_POS && rhs[i] >= 0.0) ||
+          (mapdomain[i] == CBF_CONE_NEG && rhs[i] <= 0.0) ||
+          (mapdomain[i] == CBF_CONE_ZERO && rhs[i] == 0.0))
+        pre->delmap[i] = 1;
+    }
+  }
+
+  if ( res == CBF_RES_OK )
+    res = find_duplicates(data, pre, mapdomain, rhs, hasf, rowbeg, idx);
+
+  CBFintegerarray_free(&isint);
+  free(mapdomain);
+  free(vardomain);
+  free(hasf);
+  free(hash);
+  free(rhs);
+  free(rowbeg);
+  free(idx);
+  return res;
+}
+
+static unsigned long long int hash_mix(unsigned long long int h, unsigned long long int v)
+{
+  int b;
+
+  // FNV-1a, one byte at a time
+  for (b=0; b<8; ++b) {
+    h = (h ^ (v & 0xFF)) * 1099511628211ULL;
+    v >>= 8;
+  }
+
+  return h;
+}
+
+static unsigned long long int hash_mix(unsigned long long int h, double v)
+{
+  unsigned long long int bits;
+
+  // Equal values must hash equally, and -0.0 == 0.0
+  v += 0.0;
+  memcpy(&bits, &v, sizeof(bits));
+  return hash_mix(h, bits);
+}
+
+static CBFresponsee find_duplicates(const CBFdata *data, CBFtransform_presolve *pre, const CBFscalarconee *mapdomain, const double *rhs,
+                                    const char *hasf, const long long int *rowbeg, const long long int *idx)
+{
+  unsigned long long int h, *rowhash = NULL;
+  long long int i, k, slotnum, s, *slot = NULL;
+  double val;
+
+  rowhash = (unsigned long long int*) malloc(data->mapnum * sizeof(rowhash[0]));
+
+  // Open addressing with at most half of the slots in use
+  for (slotnum = 1; slotnum < 2*data->mapnum; slotnum *= 2) {}
+  slot = (long long int*) malloc(slotnum * sizeof(slot[0]));
+
+  if ( (data->mapnum >= 1 && !rowhash) || !slot ) {
+    free(rowhash);
+    free(slot);
+    return CBF_RES_ERR;
+  }
+
+  for (s=0; s<slotnum; ++s)
+    slot[s] = -1;
+
+  for (i=0; i<data->mapnum; ++i) {
+    if (pre->delmap[i] || hasf[i] || mapdomain[i] > CBF_CONE_ZERO)
+      continue;
+
+    // Domain, right-hand side and coefficients of the remaining variables
+    h = 14695981039346656037ULL;
+    h = hash_mix(h, (unsigned long long int) mapdomain[i]);
+    h = hash_mix(h, rhs[i]);
+    for (k=rowbeg[i]; k<rowbeg[i+1]; ++k) {
+      val = data->aval[idx[k]];
+      if (val != 0.0 && !pre->delvar[data->asubj[idx[k]]]) {
+        h = hash_mix(h, (unsigned long long int) data->asubj[idx[k]]);
+        h = hash_mix(h, val);
+      }
+    }
+    rowhash[i] = h;
+
+    // The first occurrence is kept, and later ones removed
+    for (s = h & (slotnum-1); slot[s] != -1; s = (s+1) & (slotnum-1)) {
+      if (rowhash[slot[s]] == h && equal_rows(data, pre, mapdomain, rhs, rowbeg, idx, slot[s], i)) {
+        pre->delmap[i] = 1;
+        break;
+      }
+    }
+
+    if (!pre->delmap[i])
+      slot[s] = i;
+  }
+
+  free(rowhash);
+  free(slot);
+  return CBF_RES_OK;
+}
+
+static int equal_rows(const CBFdata *data, const CBFtransform_presolve *pre, const CBFscalarconee *mapdomain, const double *rhs,
+                      const long long int *rowbeg, const long long int *idx, long long int r1, long long int r2)
+{
+  long long int k1 = rowbeg[r1], k2 = rowbeg[r2];
+
+  if (mapdomain[r1] != mapdomain[r2] || rhs[r1] != rhs[r2])
+    return 0;
+
+  while (1) {
+    while (k1 < rowbeg[r1+1] && (data->aval[idx[k1]] == 0.0 || pre->delvar[data->asubj[idx[k1]]]))
+      ++k1;
+
+    while (k2 < rowbeg[r2+1] && (data->aval[idx[k2]] == 0.0 || pre->delvar[data->asubj[idx[k2]]]))
+      ++k2;
+
+    if (k1 == rowbeg[r1+1] || k2 == rowbeg[r2+1])
+      return (k1 == rowbeg[r1+1] && k2 == rowbeg[r2+1]);
+
+    if (data->asubj[idx[k1]] != data->asubj[idx[k2]] || data->aval[idx[k1]] != data->aval[idx[k2]])
+      return 0;
+
+    ++k1;
+    ++k2;
+  }
+}
+
+static CBFresponsee substitute(CBFdata *data, CBFtransform_presolve *pre)
+{
+  long long int i, k, bnnz;
+  long long int *bsubi = NULL;
+  double *bval = NULL;
+
+  for (k=0; k<data->objannz; ++k)
+    if (pre->delvar[data->objasubj[k]])
+      data->objbval += data->objaval[k] * pre->fixval[data->objasubj[k]];
+
+  // Shifts are added to existing coordinates of the right-hand side if possible
+  for (k=0; k<data->bnnz; ++k) {
+    data->bval[k] += pre->shift[data->bsubi[k]];
+    pre->shift[data->bsubi[k]] = 0.0;
+  }
+
+  for (bnnz=data->bnnz, i=0; i<data->mapnum; ++i)
+    if (pre->shift[i] != 0.0 && !pre->delmap[i])
+      ++bnnz;
+
+  if (bnnz > data->bnnz) {
+    bsubi = (long long int*) realloc(data->bsubi, bnnz * sizeof(bsubi[0]));
+    if (bsubi)
+      data->bsubi = bsubi;
+
+    bval = (double*) realloc(data->bval, bnnz * sizeof(bval[0]));
+    if (bval)
+      data->bval = bval;
+
+    if (!bsubi || !bval)
+      return CBF_RES_ERR;
+
+    for (i=0; i<data->mapnum; ++i) {
+      if (pre->shift[i] != 0.0 && !pre->delmap[i]) {
+        data->bsubi[data->bnnz] = i;
+        data->bval[data->bnnz] = pre->shift[i];
+        ++data->bnnz;
+      }
+    }
+  }
+
+  return CBF_RES_OK;
+}
+
+static void free_presolve(CBFtransform_presolve *pre)
+{
+  free(pre->delmap);
+  free(pre->delvar);
+  free(pre->fixval);
+  free(pre->fixrow);
+  free(pre->shift);
+  memset(pre, 0, sizeof(*pre));
+}
+
+static CBFresponsee revert_primal(const CBFdata *data, const CBFtransform_presolve *pre, CBFsolution *sol)
+{
+  long long int j, k;
+  double *x = NULL;
+
+  if (sol->primvarnum + sol->primpsdvarnnz == 0)
+    return CBF_RES_OK;
+
+  for (k=0, j=0; j<data->varnum; ++j)
+    if (!pre->delvar[j])
+      ++k;
+
+  if (sol->primvarnum != k) {
+    printf("Mismatch between problem and solution\n");
+    return CBF_RES_ERR;
+  }
+
+  x = (double*) malloc(data->varnum * sizeof(x[0]));
+  if (!x && data->varnum >= 1)
+    return CBF_RES_ERR;
+
+  for (k=0, j=0; j<data->varnum; ++j)
+    x[j] = (pre->delvar[j] ? pre->fixval[j] : sol->primvar[k++]);
+
+  free(sol->primvar);
+  sol->primvar = x;
+  sol->primvarnum = data->varnum;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee revert_dual(const CBFdata *data, const CBFtransform_presolve *pre, CBFsolution *sol)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int i, j, k;
+  double *y = NULL, *slack = NULL, *pivot = NULL;
+
+  if (sol->dualvarnum + sol->dualpsdvarnnz == 0)
+    return CBF_RES_OK;
+
+  for (k=0, i=0; i<data->mapnum; ++i)
+    if (!pre->delmap[i])
+      ++k;
+
+  if (sol->dualvarnum != k) {
+    printf("Mismatch between problem and solution\n");
+    return CBF_RES_ERR;
+  }
+
+  y = (double*) malloc(data->mapnum * sizeof(y[0]));
+  slack = (double*) calloc(data->varnum, sizeof(slack[0]));
+  pivot = (double*) calloc(data->varnum, sizeof(pivot[0]));
+
+  if ( (data->mapnum >= 1 && !y) || (data->varnum >= 1 && (!slack || !pivot)) )
+    res = CBF_RES_ERR;
+
+  if ( res == CBF_RES_OK ) {
+    // Removed rows are inactive, except the singleton rows fixing a variable
+    for (k=0, i=0; i<data->mapnum; ++i)
+      y[i] = (pre->delmap[i] ? 0.0 : sol->dualvar[k++]);
+
+    // Such rows leave no slack in the dual constraint of their variable
+    for (k=0; k<data->objannz; ++k)
+      slack[data->objasubj[k]] += data->objaval[k];
+
+    for (k=0; k<data->annz; ++k) {
+      j = data->asubj[k];
+      if (pre->fixrow[j] == data->asubi[k])
+        pivot[j] += data->aval[k];
+      else
+        slack[j] -= data->aval[k] * y[data->asubi[k]];
+    }
+
+    for (j=0; j<data->varnum; ++j)
+      if (pre->fixrow[j] >= 0)
+        y[pre->fixrow[j]] = slack[j] / pivot[j];
+
+    free(sol->dualvar);
+    sol->dualvar = y;
+    sol->dualvarnum = data->mapnum;
+    y = NULL;
+  }
+
+  free(y);
+  free(slack);
+  free(pivot);
+  return res;
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "transform-relax.h"
+
+#include <stdlib.h>
+
+//
+// The continuous relaxation is a view of the problem without its integer
+// variables, so no coordinates are ever copied. In memory, the list of
+// integer variables is released, and when streaming, the structure is passed
+// on in a shallow copy that borrows all arrays of the caller.
+//
+struct CBFtransform_relaxstream {
+  CBFstream downstream;
+};
+
+static CBFresponsee
+  transform(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  revert(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  stream(CBFstream *upstream, CBFstream downstream, CBFtransform_param param);
+
+static CBFresponsee
+  stream_structure(void *userdata, CBFdata *data);
+
+static CBFresponsee
+  stream_blockbegin(void *userdata, CBFblocke block, long long int nnz);
+
+static CBFresponsee
+  stream_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk);
+
+static CBFresponsee
+  stream_blockend(void *userdata, CBFblocke block);
+
+static CBFresponsee
+  stream_finish(void *userdata, CBFresponsee res);
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFtransform const transform_relax = { "relax", transform, revert, stream };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
+{
+  if (data->intvarnum >= 1) {
+    free(data->intvar);
+    data->intvar = NULL;
+    data->intvarnum = 0;
+  }
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee revert(CBFdata *data, CBFtransform_param param)
+{
+  // Solutions of the relaxation are indexed as those of the problem
+  return CBF_RES_OK;
+}
+
+static CBFresponsee stream(CBFstream *upstream, CBFstream downstream, CBFtransform_param param)
+{
+  CBFtransform_relaxstream *state = NULL;
+
+  state = (CBFtransform_relaxstream*) calloc(1, sizeof(*state));
+  if (!state)
+    return CBF_RES_ERR;
+
+  state->downstream = downstream;
+
+  upstream->userdata   = state;
+  upstream->structure  = stream_structure;
+  upstream->blockbegin = stream_blockbegin;
+  upstream->blockchunk = stream_blockchunk;
+  upstream->blockend   = stream_blockend;
+  upstream->finish     = stream_finish;
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee stream_structure(void *userdata, CBFdata *data)
+{
+  CBFtransform_relaxstream *state = (CBFtransform_relaxstream*) userdata;
+  CBFdata relaxed = *data;
+
+  // Integer variables are dropped without being released, as owned by the caller
+  relaxed.intvarnum = 0;
+  relaxed.intvar = NULL;
+
+  return state->downstream.structure(state->downstream.userdata, &relaxed);
+}
+
+static CBFresponsee stream_blockbegin(void *userdata, CBFblocke block, long long int nnz)
+{
+  CBFtransform_relaxstream *state = (CBFtransform_relaxstream*) userdata;
+  return state->downstream.blockbegin(state->downstream.userdata, block, nnz);
+}
+
+static CBFresponsee stream_blockchunk(void *userdata, CBFblocke block, CBFdata *chunk)
+{
+  CBFtransform_relaxstream *state = (CBFtransform_relaxstream*) userdata;
+  return state->downstream.blockchunk(state->downstream.userdata, block, chunk);
+}
+
+static CBFresponsee stream_blockend(void *userdata, CBFblocke block)
+{
+  CBFtransform_relaxstream *state = (CBFtransform_relaxstream*) userdata;
+  return state->downstream.blockend(state->downstream.userdata, block);
+}
+
+static CBFresponsee stream_finish(void *userdata, CBFresponsee res)
+{
+  CBFtransform_relaxstream *state = (CBFtransform_relaxstream*) userdata;
+  CBFstream downstream = state->downstream;
+
+  free(state);
+  return downstream.finish(downstream.userdata, res);
+}
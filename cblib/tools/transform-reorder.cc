@@ -0,0 +1,370 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "transform-reorder.h"
+#include "cbf-helper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+
+//
+// Ordering found by analyze, depending only on the original problem so that
+// revert can find it again. Maps and variables are only permuted within stacks
+// of linear domain, as members of other cones are not interchangeable.
+//
+struct CBFtransform_reorder {
+  long long int *newmap;
+  long long int *newvar;
+};
+
+static CBFresponsee
+  transform(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  revert(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  analyze(const CBFdata *data, CBFtransform_reorder *ord);
+
+static CBFresponsee
+  rcm(long long int nodenum, const long long int *beg, const long long int *adj, long long int *pos);
+
+static CBFresponsee
+  permute_stacks(long long int stacknum, const long long int *stackdim, const CBFscalarconee *stackdomain,
+                 const long long int *pos, long long int num, long long int *newidx);
+
+static CBFresponsee
+  permute_names(CBFnametable *table, long long int num, const long long int *newidx);
+
+static void
+  free_reorder(CBFtransform_reorder *ord);
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFtransform const transform_reorder = { "reorder", transform, revert, NULL };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_reorder ord = { 0, };
+  long long int k;
+
+  if ( res == CBF_RES_OK )
+    res = analyze(data, &ord);
+
+  if ( res == CBF_RES_OK ) {
+    for (k=0; k<data->objannz; ++k)
+      data->objasubj[k] = ord.newvar[data->objasubj[k]];
+
+    for (k=0; k<data->fnnz; ++k)
+      data->fsubi[k] = ord.newmap[data->fsubi[k]];
+
+    for (k=0; k<data->annz; ++k) {
+      data->asubi[k] = ord.newmap[data->asubi[k]];
+      data->asubj[k] = ord.newvar[data->asubj[k]];
+    }
+
+    for (k=0; k<data->bnnz; ++k)
+      data->bsubi[k] = ord.newmap[data->bsubi[k]];
+
+    for (k=0; k<data->hnnz; ++k)
+      data->hsubj[k] = ord.newvar[data->hsubj[k]];
+
+    for (k=0; k<data->intvarnum; ++k)
+      data->intvar[k] = ord.newvar[data->intvar[k]];
+
+    std::sort(data->intvar, data->intvar + data->intvarnum);
+  }
+
+  // Coordinates are stored in the new order as well
+  if ( res == CBF_RES_OK )
+    res = CBF_coordinatesort(data->objasubj, data->objaval, data->objannz, data->varnum);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_coordinatesort_rowmajor_map(data);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_coordinatesort_rowmajor_psdmap(data);
+
+  if ( res == CBF_RES_OK && data->mapname )
+    res = permute_names(data->mapname, data->mapnum, ord.newmap);
+
+  if ( res == CBF_RES_OK && data->varname )
+    res = permute_names(data->varname, data->varnum, ord.newvar);
+
+  free_reorder(&ord);
+  return res;
+}
+
+static CBFresponsee revert(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_reorder ord = { 0, };
+  CBFsolution *sol = param.sol;
+  double *val = NULL;
+  long long int k;
+
+  if (!sol)
+    return CBF_RES_ERR;
+
+  if ( (sol->primvarnum + sol->primpsdvarnnz >= 1 && sol->primvarnum != data->varnum) ||
+       (sol->dualvarnum + sol->dualpsdvarnnz >= 1 && sol->dualvarnum != data->mapnum) ) {
+    printf("Mismatch between problem and solution\n");
+    return CBF_RES_ERR;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = analyze(data, &ord);
+
+  if ( res == CBF_RES_OK && sol->primvarnum >= 1 ) {
+    val = (double*) malloc(sol->primvarnum * sizeof(val[0]));
+    if (!val) {
+      res = CBF_RES_ERR;
+    } else {
+      for (k=0; k<data->varnum; ++k)
+        val[k] = sol->primvar[ord.newvar[k]];
+      std::swap(val, sol->primvar);
+      free(val);
+    }
+  }
+
+  if ( res == CBF_RES_OK && sol->dualvarnum >= 1 ) {
+    val = (double*) malloc(sol->dualvarnum * sizeof(val[0]));
+    if (!val) {
+      res = CBF_RES_ERR;
+    } else {
+      for (k=0; k<data->mapnum; ++k)
+        val[k] = sol->dualvar[ord.newmap[k]];
+      std::swap(val, sol->dualvar);
+      free(val);
+    }
+  }
+
+  free_reorder(&ord);
+  return res;
+}
+
+static CBFresponsee analyze(const CBFdata *data, CBFtransform_reorder *ord)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int *node = NULL, *nbr = NULL, *beg = NULL, *adj = NULL, *pos = NULL;
+  long long int k, e, nodenum, edgenum, varbeg, psdvarbeg, psdmapbeg;
+
+  //
+  // Maps, variables, PSD variables and PSD maps are the nodes of a graph with an
+  // edge for each coordinate of A, F and H, so that the ordering of maps and
+  // variables also accounts for the semidefinite parts connecting them.
+  //
+  varbeg = data->mapnum;
+  psdvarbeg = varbeg + data->varnum;
+  psdmapbeg = psdvarbeg + data->psdvarnum;
+  nodenum = psdmapbeg + data->psdmapnum;
+  edgenum = 2 * (data->annz + data->fnnz + data->hnnz);
+
+  ord->newmap = (long long int*) malloc(data->mapnum * sizeof(ord->newmap[0]));
+  ord->newvar = (long long int*) malloc(data->varnum * sizeof(ord->newvar[0]));
+  node = (long long int*) malloc(edgenum * sizeof(node[0]));
+  nbr = (long long int*) malloc(edgenum * sizeof(nbr[0]));
+  adj = (long long int*) malloc(edgenum * sizeof(adj[0]));
+  beg = (long long int*) malloc((nodenum+1) * sizeof(beg[0]));
+  pos = (long long int*) malloc(nodenum * sizeof(pos[0]));
+
+  if ( (data->mapnum >= 1 && !ord->newmap) || (data->varnum >= 1 && !ord->newvar) ||
+       (edgenum >= 1 && (!node || !nbr || !adj)) || !beg || (nodenum >= 1 && !pos) )
+    res = CBF_RES_ERR;
+
+  if ( res == CBF_RES_OK ) {
+    e = 0;
+    for (k=0; k<data->annz; ++k) {
+      node[e] = data->asubi[k];           nbr[e++] = varbeg + data->asubj[k];
+      node[e] = varbeg + data->asubj[k];  nbr[e++] = data->asubi[k];
+    }
+
+    for (k=0; k<data->fnnz; ++k) {
+      node[e] = data->fsubi[k];              nbr[e++] = psdvarbeg + data->fsubj[k];
+      node[e] = psdvarbeg + data->fsubj[k];  nbr[e++] = data->fsubi[k];
+    }
+
+    for (k=0; k<data->hnnz; ++k) {
+      node[e] = varbeg + data->hsubj[k];     nbr[e++] = psdmapbeg + data->hsubi[k];
+      node[e] = psdmapbeg + data->hsubi[k];  nbr[e++] = varbeg + data->hsubj[k];
+    }
+  }
+
+  // Adjacency lists by node, i.e., the transpose of the edge list
+  if ( res == CBF_RES_OK )
+    res = CBF_transpose(edgenum, nbr, nodenum-1, node, nodenum-1, beg, adj);
+
+  if ( res == CBF_RES_OK ) {
+    for (k=0; k<edgenum; ++k)
+      adj[k] = nbr[adj[k]];
+
+    res = rcm(nodenum, beg, adj, pos);
+  }
+
+  if ( res == CBF_RES_OK )
+    res = permute_stacks(data->mapstacknum, data->mapstackdim, data->mapstackdomain, pos, data->mapnum, ord->newmap);
+
+  if ( res == CBF_RES_OK )
+    res = permute_stacks(data->varstacknum, data->varstackdim, data->varstackdomain, pos + varbeg, data->varnum, ord->newvar);
+
+  free(node);
+  free(nbr);
+  free(beg);
+  free(adj);
+  free(pos);
+  return res;
+}
+
+static CBFresponsee rcm(long long int nodenum, const long long int *beg, const long long int *adj, long long int *pos)
+{
+  CBFresponsee res = CBF_RES_OK;
+  long long int *deg = NULL, *start = NULL, *order = NULL;
+  long long int k, s, u, v, head, tail, maxdeg = 0;
+  char *seen = NULL;
+
+  deg = (long long int*) malloc(nodenum * sizeof(deg[0]));
+  start = (long long int*) malloc(nodenum * sizeof(start[0]));
+  order = (long long int*) malloc(nodenum * sizeof(order[0]));
+  seen = (char*) calloc(nodenum, sizeof(seen[0]));
+
+  if ( nodenum >= 1 && (!deg || !start || !order || !seen) )
+    res = CBF_RES_ERR;
+
+  if ( res == CBF_RES_OK ) {
+    for (u=0; u<nodenum; ++u) {
+      deg[u] = beg[u+1] - beg[u];
+      maxdeg = std::max(maxdeg, deg[u]);
+      start[u] = u;
+    }
+
+    // Components are started from a node of least degree
+    res = CBF_bucketsort(maxdeg, nodenum, deg, start);
+  }
+
+  // Cuthill-McKee: breadth first, visiting neighbors by increasing degree
+  for (tail=0, s=0; s<nodenum && res==CBF_RES_OK; ++s) {
+    if (seen[start[s]])
+      continue;
+
+    seen[start[s]] = 1;
+    order[tail++] = start[s];
+
+    for (head=tail-1; head<tail; ++head) {
+      u = order[head];
+      k = tail;
+
+      for (v=beg[u]; v<beg[u+1]; ++v) {
+        if (!seen[adj[v]]) {
+          seen[adj[v]] = 1;
+          order[tail++] = adj[v];
+        }
+      }
+
+      std::sort(order + k, order + tail, [deg](long long int a, long long int b) {
+        return deg[a] < deg[b] || (deg[a] == deg[b] && a < b);
+      });
+    }
+  }
+
+  // ...and reversed
+  if ( res == CBF_RES_OK )
+    for (k=0; k<nodenum; ++k)
+      pos[order[k]] = nodenum-1 - k;
+
+  free(deg);
+  free(start);
+  free(order);
+  free(seen);
+  return res;
+}
+
+static CBFresponsee permute_stacks(long long int stacknum, const long long int *stackdim, const CBFscalarconee *stackdomain,
+                                   const long long int *pos, long long int num, long long int *newidx)
+{
+  long long int r, k, first = 0, *member = NULL;
+
+  member = (long long int*) malloc(num * sizeof(member[0]));
+  if (!member && num >= 1)
+    return CBF_RES_ERR;
+
+  for (r=0; r<stacknum; ++r) {
+    for (k=first; k<first+stackdim[r]; ++k)
+      member[k] = k;
+
+    // Members of linear domain take their place in the ordering, relative to each other
+    if (stackdomain[r] <= CBF_CONE_ZERO) {
+      std::sort(member + first, member + first + stackdim[r], [pos](long long int a, long long int b) {
+        return pos[a] < pos[b];
+      });
+    }
+
+    for (k=first; k<first+stackdim[r]; ++k)
+      newidx[member[k]] = k;
+
+    first += stackdim[r];
+  }
+
+  free(member);
+  return CBF_RES_OK;
+}
+
+static CBFresponsee permute_names(CBFnametable *table, long long int num, const long long int *newidx)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFnametable permuted;
+  long long int i, *oldidx = NULL;
+
+  memset(&permuted, 0, sizeof(permuted));
+
+  oldidx = (long long int*) malloc(num * sizeof(oldidx[0]));
+  if (!oldidx && num >= 1)
+    return CBF_RES_ERR;
+
+  for (i=0; i<num; ++i)
+    oldidx[newidx[i]] = i;
+
+  for (i=0; i<num && res==CBF_RES_OK; ++i)
+    res = CBFnametable_push(&permuted, CBFnametable_name(table, oldidx[i]));
+
+  if ( res == CBF_RES_OK ) {
+    CBFnametable_free(table);
+    *table = permuted;
+  } else {
+    CBFnametable_free(&permuted);
+  }
+
+  free(oldidx);
+  return res;
+}
+
+static void free_reorder(CBFtransform_reorder *ord)
+{
+  free(ord->newmap);
+  free(ord->newvar);
+  memset(ord, 0, sizeof(*ord));
+}
@@ -0,0 +1,306 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "transform-scale.h"
+#include "cbf-helper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <algorithm>
+#include <vector>
+
+#define CBF_SCALE_MAXITER  20
+#define CBF_SCALE_TOL      1e-2
+
+//
+// Ruiz equilibration, where map i and variable j are scaled by row[i] and
+// col[j] such that the largest coefficient of every row and column of ACOORD,
+// FCOORD and HCOORD tends to one. Members of a cone (other than F, L+, L- and
+// L=) share one factor, integer variables are not scaled, and psdmaps and
+// psdvars are scaled congruently by a diagonal matrix, i.e., entry (k,l) of
+// psdmap i by psdrow[psdrowbeg[i]+k] * psdrow[psdrowbeg[i]+l]. Factors are
+// rounded to powers of two, so scaling and reverting are exact.
+//
+struct CBFtransform_scale {
+  std::vector<double> row;
+  std::vector<double> col;
+
+  std::vector<long long int> psdrowbeg;
+  std::vector<double> psdrow;
+
+  std::vector<long long int> psdcolbeg;
+  std::vector<double> psdcol;
+};
+
+static CBFresponsee
+  transform(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  revert(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  equilibrate(CBFdata *data, CBFtransform_scale *sc);
+
+static void
+  stackmax(long long int stacknum, const long long int *stackdim, const CBFscalarconee *stackdomain, std::vector<double> &val);
+
+static double
+  update(std::vector<double> &scale, const std::vector<double> &maxval, double power);
+
+static double
+  roundpow2(double val);
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFtransform const transform_scale = { "scale", transform, revert, NULL };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_scale sc;
+  long long int i, k;
+
+  res = equilibrate(data, &sc);
+
+  if ( res == CBF_RES_OK ) {
+    for (k=0; k<data->objannz; ++k)
+      data->objaval[k] *= sc.col[data->objasubj[k]];
+
+    for (k=0; k<data->objfnnz; ++k) {
+      i = sc.psdcolbeg[data->objfsubj[k]];
+      data->objfval[k] *= sc.psdcol[i + data->objfsubk[k]] * sc.psdcol[i + data->objfsubl[k]];
+    }
+
+    for (k=0; k<data->annz; ++k)
+      data->aval[k] *= sc.row[data->asubi[k]] * sc.col[data->asubj[k]];
+
+    for (k=0; k<data->bnnz; ++k)
+      data->bval[k] *= sc.row[data->bsubi[k]];
+
+    for (k=0; k<data->fnnz; ++k) {
+      i = sc.psdcolbeg[data->fsubj[k]];
+      data->fval[k] *= sc.row[data->fsubi[k]] * sc.psdcol[i + data->fsubk[k]] * sc.psdcol[i + data->fsubl[k]];
+    }
+
+    for (k=0; k<data->hnnz; ++k) {
+      i = sc.psdrowbeg[data->hsubi[k]];
+      data->hval[k] *= sc.psdrow[i + data->hsubk[k]] * sc.psdrow[i + data->hsubl[k]] * sc.col[data->hsubj[k]];
+    }
+
+    for (k=0; k<data->dnnz; ++k) {
+      i = sc.psdrowbeg[data->dsubi[k]];
+      data->dval[k] *= sc.psdrow[i + data->dsubk[k]] * sc.psdrow[i + data->dsubl[k]];
+    }
+  }
+
+  return res;
+}
+
+static CBFresponsee revert(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_scale sc;
+  CBFsolution *sol = param.sol;
+  long long int i, j, t, n, psdvarnnz = 0, psdmapnnz = 0;
+  int k, l;
+
+  if (!sol)
+    return CBF_RES_ERR;
+
+  for (j=0; j<data->psdvarnum; ++j) {
+    n = data->psdvardim[j];
+    psdvarnnz += n*(n+1)/2;
+  }
+
+  for (i=0; i<data->psdmapnum; ++i) {
+    n = data->psdmapdim[i];
+    psdmapnnz += n*(n+1)/2;
+  }
+
+  if ( (sol->primvarnum >= 1 && sol->primvarnum != data->varnum) ||
+       (sol->primpsdvarnnz >= 1 && sol->primpsdvarnnz != psdvarnnz) ||
+       (sol->dualvarnum >= 1 && sol->dualvarnum != data->mapnum) ||
+       (sol->dualpsdvarnnz >= 1 && sol->dualpsdvarnnz != psdmapnnz) ) {
+    printf("Mismatch between problem and solution\n");
+    res = CBF_RES_ERR;
+  }
+
+  if ( res == CBF_RES_OK )
+    res = equilibrate(data, &sc);
+
+  // Primal values are C*y and D*Y*D, and dual values R*s and E*S*E
+  if ( res == CBF_RES_OK ) {
+    for (j=0; j<sol->primvarnum; ++j)
+      sol->primvar[j] *= sc.col[j];
+
+    for (i=0; i<sol->dualvarnum; ++i)
+      sol->dualvar[i] *= sc.row[i];
+
+    for (j=0, t=0; j<data->psdvarnum && sol->primpsdvarnnz >= 1; ++j)
+      for (k=0; k<data->psdvardim[j]; ++k)
+        for (l=0; l<=k; ++l)
+          sol->primpsdvar[t++] *= sc.psdcol[sc.psdcolbeg[j] + k] * sc.psdcol[sc.psdcolbeg[j] + l];
+
+    for (i=0, t=0; i<data->psdmapnum && sol->dualpsdvarnnz >= 1; ++i)
+      for (k=0; k<data->psdmapdim[i]; ++k)
+        for (l=0; l<=k; ++l)
+          sol->dualpsdvar[t++] *= sc.psdrow[sc.psdrowbeg[i] + k] * sc.psdrow[sc.psdrowbeg[i] + l];
+  }
+
+  return res;
+}
+
+static CBFresponsee equilibrate(CBFdata *data, CBFtransform_scale *sc)
+{
+  CBFresponsee res = CBF_RES_OK;
+  char *integer = NULL;
+  long long int i, j, k, t, it;
+  double val, dev;
+  std::vector<double> rowmax, colmax, psdrowmax, psdcolmax, fixed(data->varnum, 0.0);
+
+  sc->row.assign(data->mapnum, 1.0);
+  sc->col.assign(data->varnum, 1.0);
+
+  sc->psdrowbeg.assign(data->psdmapnum + 1, 0);
+  for (i=0; i<data->psdmapnum; ++i)
+    sc->psdrowbeg[i+1] = sc->psdrowbeg[i] + data->psdmapdim[i];
+  sc->psdrow.assign(sc->psdrowbeg[data->psdmapnum], 1.0);
+
+  sc->psdcolbeg.assign(data->psdvarnum + 1, 0);
+  for (j=0; j<data->psdvarnum; ++j)
+    sc->psdcolbeg[j+1] = sc->psdcolbeg[j] + data->psdvardim[j];
+  sc->psdcol.assign(sc->psdcolbeg[data->psdvarnum], 1.0);
+
+  // Integer variables are not scaled, nor are cones with any of them
+  if ( data->intvarnum >= 1 ) {
+    res = CBFintegerarray_init(data, &integer);
+
+    if ( res == CBF_RES_OK ) {
+      for (j=0; j<data->varnum; ++j)
+        fixed[j] = integer[j];
+
+      stackmax(data->varstacknum, data->varstackdim, data->varstackdomain, fixed);
+    }
+
+    CBFintegerarray_free(&integer);
+  }
+
+  for (it=0; it<CBF_SCALE_MAXITER && res==CBF_RES_OK; ++it) {
+    rowmax.assign(sc->row.size(), 0.0);
+    colmax.assign(sc->col.size(), 0.0);
+    psdrowmax.assign(sc->psdrow.size(), 0.0);
+    psdcolmax.assign(sc->psdcol.size(), 0.0);
+
+    // Largest coefficient of every row and column as currently scaled
+    for (k=0; k<data->annz; ++k) {
+      i = data->asubi[k];
+      j = data->asubj[k];
+      val = fabs(data->aval[k]) * sc->row[i] * sc->col[j];
+      rowmax[i] = std::max(rowmax[i], val);
+      colmax[j] = std::max(colmax[j], val);
+    }
+
+    for (k=0; k<data->fnnz; ++k) {
+      i = data->fsubi[k];
+      t = sc->psdcolbeg[data->fsubj[k]];
+      val = fabs(data->fval[k]) * sc->row[i] * sc->psdcol[t + data->fsubk[k]] * sc->psdcol[t + data->fsubl[k]];
+      rowmax[i] = std::max(rowmax[i], val);
+      psdcolmax[t + data->fsubk[k]] = std::max(psdcolmax[t + data->fsubk[k]], val);
+      psdcolmax[t + data->fsubl[k]] = std::max(psdcolmax[t + data->fsubl[k]], val);
+    }
+
+    for (k=0; k<data->hnnz; ++k) {
+      t = sc->psdrowbeg[data->hsubi[k]];
+      j = data->hsubj[k];
+      val = fabs(data->hval[k]) * sc->psdrow[t + data->hsubk[k]] * sc->psdrow[t + data->hsubl[k]] * sc->col[j];
+      psdrowmax[t + data->hsubk[k]] = std::max(psdrowmax[t + data->hsubk[k]], val);
+      psdrowmax[t + data->hsubl[k]] = std::max(psdrowmax[t + data->hsubl[k]], val);
+      colmax[j] = std::max(colmax[j], val);
+    }
+
+    stackmax(data->mapstacknum, data->mapstackdim, data->mapstackdomain, rowmax);
+    stackmax(data->varstacknum, data->varstackdim, data->varstackdomain, colmax);
+
+    for (j=0; j<data->varnum; ++j)
+      if (fixed[j])
+        colmax[j] = 0.0;
+
+    // Entries of psdmaps and psdvars get two factors of the same kind, hence the fourth root
+    dev = update(sc->row, rowmax, 0.5);
+    dev = std::max(dev, update(sc->col, colmax, 0.5));
+    dev = std::max(dev, update(sc->psdrow, psdrowmax, 0.25));
+    dev = std::max(dev, update(sc->psdcol, psdcolmax, 0.25));
+
+    if (dev <= CBF_SCALE_TOL)
+      break;
+  }
+
+  std::transform(sc->row.begin(), sc->row.end(), sc->row.begin(), roundpow2);
+  std::transform(sc->col.begin(), sc->col.end(), sc->col.begin(), roundpow2);
+  std::transform(sc->psdrow.begin(), sc->psdrow.end(), sc->psdrow.begin(), roundpow2);
+  std::transform(sc->psdcol.begin(), sc->psdcol.end(), sc->psdcol.begin(), roundpow2);
+
+  return res;
+}
+
+static void stackmax(long long int stacknum, const long long int *stackdim, const CBFscalarconee *stackdomain, std::vector<double> &val)
+{
+  long long int r, k;
+  double maxval;
+
+  // Members of a cone share the largest value among them
+  for (r=0, k=0; r<stacknum; k += stackdim[r++]) {
+    if (stackdomain[r] > CBF_CONE_ZERO && stackdim[r] >= 1) {
+      maxval = *std::max_element(val.begin() + k, val.begin() + k + stackdim[r]);
+      std::fill(val.begin() + k, val.begin() + k + stackdim[r], maxval);
+    }
+  }
+}
+
+static double update(std::vector<double> &scale, const std::vector<double> &maxval, double power)
+{
+  size_t i;
+  double dev = 0.0;
+
+  // Rows and columns without coefficients are left as they are
+  for (i=0; i<scale.size(); ++i) {
+    if (maxval[i] > 0.0) {
+      scale[i] /= pow(maxval[i], power);
+      dev = std::max(dev, fabs(1.0 - maxval[i]));
+    }
+  }
+
+  return dev;
+}
+
+static double roundpow2(double val)
+{
+  int e;
+  double m = frexp(val, &e);
+
+  // Nearest power of two to val = m*2^e, where 0.5 <= m < 1
+  return ldexp(1.0, (m < sqrt(0.5) ? e-1 : e));
+}
@@ -0,0 +1,273 @@
+// Copyright (c) 2012 by Zuse-Institute Berlin and the Technical University of Denmark.
+//
+// This software is provided 'as-is', without any express or implied
+// warranty. In no event will the authors be held liable for any damages
+// arising from the use of this software.
+//
+// Permission is granted to anyone to use this software for any purpose,
+// including commercial applications, and to alter it and redistribute it
+// freely, subject to the following restrictions:
+//
+// 1. The origin of this software must not be misrepresented; you must not
+//    claim that you wrote the original software. If you use this software
+//    in a product, an acknowledgment in the product documentation would be
+//    appreciated but is not required.
+// 2. Altered source versions must be plainly marked as such, and must not be
+//    misrepresented as being the original software.
+// 3. This notice may not be removed or altered from any source distribution.
+
+#include "transform-svec.h"
+#include "cbf-helper.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+//
+// Psdvar j is replaced by the variables varbeg[j], ..., varbeg[j+1]-1 holding
+// svec(X), i.e., X_kk and sqrt(2)*X_kl for k > l, which preserves the inner
+// products of FCOORD and OBJFCOORD. Psdvars of dimension one and two become
+// variables of domain L+ and of a rotated quadratic cone, while larger ones are
+// free variables constrained by an explicit psdmap.
+//
+struct CBFtransform_svec {
+  long long int *varbeg;
+};
+
+static CBFresponsee
+  transform(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  revert(CBFdata *data, CBFtransform_param param);
+
+static CBFresponsee
+  analyze(const CBFdata *data, CBFtransform_svec *vec);
+
+static CBFresponsee
+  substitute(CBFdata *data, const CBFtransform_svec *vec);
+
+static long long int
+  svecidx(int dim, int k, int l);
+
+// -------------------------------------
+// Global variable
+// -------------------------------------
+
+CBFtransform const transform_svec = { "svec", transform, revert, NULL };
+
+
+// -------------------------------------
+// Function definitions
+// -------------------------------------
+
+static CBFresponsee transform(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_svec vec = { 0, };
+  char *delpsdvar = NULL;
+  long long int varnum = data->varnum;
+
+  if ( data->psdvarnum == 0 )
+    return CBF_RES_OK;
+
+  if ( res == CBF_RES_OK )
+    res = analyze(data, &vec);
+
+  if ( res == CBF_RES_OK )
+    res = substitute(data, &vec);
+
+  if ( res == CBF_RES_OK ) {
+    delpsdvar = (char*) malloc(data->psdvarnum * sizeof(delpsdvar[0]));
+    if (!delpsdvar) {
+      res = CBF_RES_ERR;
+    } else {
+      memset(delpsdvar, 1, data->psdvarnum * sizeof(delpsdvar[0]));
+      res = CBF_compress_psdvars(data, delpsdvar);
+    }
+  }
+
+  // Coordinates were appended in a single pass, and are sorted once
+  if ( res == CBF_RES_OK )
+    res = CBF_coordinatesort(data->objasubj, data->objaval, data->objannz, data->varnum);
+
+  if ( res == CBF_RES_OK )
+    res = CBF_coordinatesort_rowmajor_map(data);
+
+  if ( res == CBF_RES_OK && data->varname )
+    res = CBFnametable_pushnew(data->varname, "x", varnum, data->varnum - varnum);
+
+  CBF_release_empty(data);
+  free(delpsdvar);
+  free(vec.varbeg);
+  return res;
+}
+
+static CBFresponsee revert(CBFdata *data, CBFtransform_param param)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFtransform_svec vec = { 0, };
+  CBFsolution *sol = param.sol;
+  double *val = NULL;
+  long long int j, t, n, psdvarnnz = 0, psdmapnnz = 0, addpsdmapnnz = 0;
+  int k, l;
+
+  if (!sol)
+    return CBF_RES_ERR;
+
+  if ( res == CBF_RES_OK )
+    res = analyze(data, &vec);
+
+  if ( res == CBF_RES_OK ) {
+    for (j=0; j<data->psdmapnum; ++j) {
+      n = data->psdmapdim[j];
+      psdmapnnz += n*(n+1)/2;
+    }
+
+    // Psdvars of dimension three and up were constrained by a psdmap of their own
+    for (j=0; j<data->psdvarnum; ++j) {
+      n = data->psdvardim[j];
+      psdvarnnz += n*(n+1)/2;
+      if (n >= 3)
+        addpsdmapnnz += n*(n+1)/2;
+    }
+
+    // Solution sizes must match the transformed problem exactly
+    if ( (sol->primvarnum + sol->primpsdvarnnz >= 1 && (sol->primvarnum != vec.varbeg[data->psdvarnum] || sol->primpsdvarnnz != 0)) ||
+         (sol->dualvarnum + sol->dualpsdvarnnz >= 1 && (sol->dualvarnum != data->mapnum || sol->dualpsdvarnnz != psdmapnnz + addpsdmapnnz)) ) {
+      printf("Mismatch between problem and solution\n");
+      res = CBF_RES_ERR;
+    }
+  }
+
+  // Psdvars are read back from their scaled variables
+  if ( res == CBF_RES_OK && sol->primvarnum >= 1 && psdvarnnz >= 1 ) {
+    val = (double*) malloc(psdvarnnz * sizeof(val[0]));
+    if (!val) {
+      res = CBF_RES_ERR;
+    } else {
+      for (j=0, t=0; j<data->psdvarnum; ++j) {
+        for (k=0; k<data->psdvardim[j]; ++k) {
+          for (l=0; l<=k; ++l, ++t) {
+            val[t] = sol->primvar[vec.varbeg[j] + svecidx(data->psdvardim[j], k, l)];
+            if (k != l)
+              val[t] /= sqrt(2.0);
+          }
+        }
+      }
+
+      std::swap(val, sol->primpsdvar);
+      sol->primpsdvarnnz = psdvarnnz;
+      sol->primvarnum = data->varnum;
+      free(val);
+    }
+  }
+
+  // Duals of the psdmaps added for psdvars have no counterpart, and are dropped
+  if ( res == CBF_RES_OK && sol->dualpsdvarnnz >= 1 )
+    sol->dualpsdvarnnz = psdmapnnz;
+
+  free(vec.varbeg);
+  return res;
+}
+
+static CBFresponsee analyze(const CBFdata *data, CBFtransform_svec *vec)
+{
+  long long int j, n;
+
+  vec->varbeg = (long long int*) malloc((data->psdvarnum+1) * sizeof(vec->varbeg[0]));
+  if (!vec->varbeg)
+    return CBF_RES_ERR;
+
+  vec->varbeg[0] = data->varnum;
+  for (j=0; j<data->psdvarnum; ++j) {
+    n = data->psdvardim[j];
+    vec->varbeg[j+1] = vec->varbeg[j] + n*(n+1)/2;
+  }
+
+  return CBF_RES_OK;
+}
+
+static CBFresponsee substitute(CBFdata *data, const CBFtransform_svec *vec)
+{
+  CBFresponsee res = CBF_RES_OK;
+  CBFdyndata dyndata;
+  long long int j, hnnz = 0, psdmapnum = data->psdmapnum;
+  int n, k, l;
+  double scale;
+
+  for (j=0; j<data->psdvarnum; ++j) {
+    n = data->psdvardim[j];
+    if (n >= 3) {
+      hnnz += vec->varbeg[j+1] - vec->varbeg[j];
+      ++psdmapnum;
+    }
+  }
+
+  // Arrays are reallocated in place, owned by the frontend as before
+  CBFdyn_assign(&dyndata, data);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_var_capacitysurplus(&dyndata, data->psdvarnum);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_psdmap_capacitysurplus(&dyndata, psdmapnum - data->psdmapnum);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_h_capacitysurplus(&dyndata, hnnz);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_a_capacitysurplus(&dyndata, data->fnnz);
+
+  if ( res == CBF_RES_OK )
+    res = CBFdyn_obja_capacitysurplus(&dyndata, data->objfnnz);
+
+  for (j=0; j<data->psdvarnum && res==CBF_RES_OK; ++j) {
+    n = data->psdvardim[j];
+
+    if (n == 1) {
+      res = CBFdyn_var_adddomain(&dyndata, CBF_CONE_POS, 1);
+
+    } else if (n == 2) {
+      res = CBFdyn_var_adddomain(&dyndata, CBF_CONE_RQUAD, 3);
+
+    } else {
+      res = CBFdyn_var_adddomain(&dyndata, CBF_CONE_FREE, vec->varbeg[j+1] - vec->varbeg[j]);
+
+      if ( res == CBF_RES_OK )
+        res = CBFdyn_psdmap_add(&dyndata, n);
+
+      // X = sum_kk E_kk x_kk + sum_k>l (E_kl + E_lk) x_kl / sqrt(2)
+      for (k=0; k<n && res==CBF_RES_OK; ++k)
+        for (l=0; l<=k && res==CBF_RES_OK; ++l)
+          res = CBFdyn_h_add(&dyndata, data->psdmapnum-1, vec->varbeg[j] + svecidx(n, k, l), k, l, (k == l) ? 1.0 : 1.0 / sqrt(2.0));
+    }
+  }
+
+  // A single pass over the coordinates, as every entry of a psdvar has its own variable
+  for (j=0; j<data->fnnz && res==CBF_RES_OK; ++j) {
+    k = std::max(data->fsubk[j], data->fsubl[j]);
+    l = std::min(data->fsubk[j], data->fsubl[j]);
+    scale = (k == l) ? 1.0 : sqrt(2.0);
+    res = CBFdyn_a_add(&dyndata, data->fsubi[j], vec->varbeg[data->fsubj[j]] + svecidx(data->psdvardim[data->fsubj[j]], k, l), scale * data->fval[j]);
+  }
+
+  for (j=0; j<data->objfnnz && res==CBF_RES_OK; ++j) {
+    k = std::max(data->objfsubk[j], data->objfsubl[j]);
+    l = std::min(data->objfsubk[j], data->objfsubl[j]);
+    scale = (k == l) ? 1.0 : sqrt(2.0);
+    res = CBFdyn_obja_add(&dyndata, vec->varbeg[data->objfsubj[j]] + svecidx(data->psdvardim[data->objfsubj[j]], k, l), scale * data->objfval[j]);
+  }
+
+  return res;
+}
+
+static long long int svecidx(int dim, int k, int l)
+{
+  // Entry (k,l) with k >= l, though members of a rotated quadratic cone come as X_00, X_11, sqrt(2)*X_10
+  if (dim == 2)
+    return (k == l) ? k : 2;
+
+  return (long long int)k*(k+1)/2 + l;
+}
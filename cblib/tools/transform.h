@@ -20,12 +20,18 @@
 #define CBF_TRANSFORM_H
 
 #include "cbf-data.h"
+#include "solution-cbf.h"
+#include "stream.h"
 #include "programmingstyle.h"
 #include <stdlib.h>
 
 typedef struct CBFtransform_param_struct {
 
+  // Solution of the transformed problem, which revert replaces by one of the original
+  CBFsolution *sol;
+
   CBFresponsee init(CBFdata *data) {
+    sol = NULL;
     return CBF_RES_OK;
   }
 
@@ -36,6 +42,7 @@ typedef struct CBFtransform_struct {
   const char *name;
   CBFresponsee (*transform)(CBFdata *data, CBFtransform_param param);
   CBFresponsee (*revert)(CBFdata *data, CBFtransform_param param);
+  CBFresponsee (*stream)(CBFstream *upstream, CBFstream downstream, CBFtransform_param param);
 
 } CBFtransform;
 